@@ -1,3 +1,14 @@
 #pragma once
 #include "Core/Engine.h"
+#include "Core/Task.h"
+#include "Core/JobSystem.h"
+#include "Core/RenderCommandStream.h"
+#include "Platform/FileSystem.h"
+#include "RHI/Textures/TextureReadback.h"
+#include "RHI/Textures/TextureStreamer.h"
+#include "RHI/Textures/BlockCompression.h"
+#include "RHI/Textures/PixelConversion.h"
+#include "RHI/Textures/MipGenerator.h"
+#include "RHI/Textures/TextureContainer.h"
+#include "RHI/Textures/TexturePool.h"
 #include <SDL3/SDL_main.h>
\ No newline at end of file
@@ -1,9 +1,12 @@
 #include "Engine.h"
 #include "Log.h"
+#include "JobSystem.h"
+#include "RenderThread.h"
 #include "RHI/Device.h"
 #include "RHI/Swapchain.h"
 #include "Platform/Window.h"
 #include "Platform/Events.h"
+#include "Platform/FileSystem.h"
 
 Awki::Awki(const AkInstanceDescriptor& descriptor)
 {
@@ -12,6 +15,12 @@ Awki::Awki(const AkInstanceDescriptor& descriptor)
 
 	AkLogInfo("Awki {} initializing", kEngineVersion);
 
+	if (!AkJobSystem::Initialize())
+		throw std::runtime_error("Failed to initialize Job System!");
+
+	if (!AkFileSystem::Initialize())
+		throw std::runtime_error("Failed to initialize File System!");
+
 	if (!AkEvents::Initialize())
 		throw std::runtime_error("Failed to initialize Events System!");
 
@@ -19,7 +28,10 @@ Awki::Awki(const AkInstanceDescriptor& descriptor)
 		throw std::runtime_error("Failed to initialize RHI Device!");
 
 	m_Window = std::make_shared<AkWindow>(descriptor.windowDescriptor);
-	m_Swapchain = std::make_shared<AkSwapchain>(m_Window);
+	m_Swapchain = std::make_shared<AkSwapchain>(m_Window, descriptor.swapchainDescriptor);
+	m_IsLowLatencyMode = descriptor.lowLatencyMode;
+	m_RenderThread = std::make_unique<AkRenderThread>(m_Swapchain, m_IsLowLatencyMode ? 1 : descriptor.renderPipelineDepth);
+	m_FramePacer = std::make_unique<AkFramePacer>(descriptor.framePacing);
 
 	AkLogInfo("{} {} initializing", descriptor.gameName, descriptor.gameVersion);
 }
@@ -27,6 +39,7 @@ Awki::Awki(const AkInstanceDescriptor& descriptor)
 Awki::~Awki()
 {
 	AkLogInfo("Awki {} deinitializing", kEngineVersion);
+	m_RenderThread.reset();
 	AkDevice::WaitIdle();
 
 	m_Swapchain.reset();
@@ -34,18 +47,71 @@ Awki::~Awki()
 
 	AkDevice::Deinitialize();
 	AkEvents::Deinitialize();
+	AkFileSystem::Deinitialize();
+	AkJobSystem::Deinitialize();
 	AkLog::Deinitialize();
 }
 
-void Awki::Run()
+void Awki::Run(const AkGameCallbacks& callbacks)
 {
 	while (!AkEvents::ShouldClose())
 	{
-		AkEvents::PollEvents();
-		
-		if (m_Swapchain->Prepare())
+		AkFramePacingMode pacingMode = AkFramePacingMode::FOREGROUND;
+		if (m_Window->IsMinimized())
+			pacingMode = AkFramePacingMode::MINIMIZED;
+		else if (!m_Window->HasInputFocus())
+			pacingMode = AkFramePacingMode::BACKGROUND;
+
+		// The render thread is idled and the swapchain drains the submission thread before the wait, which then has the swapchain to itself
+		if (m_IsLowLatencyMode && pacingMode != AkFramePacingMode::MINIMIZED)
 		{
-			m_Swapchain->Present();
+			m_RenderThread->WaitIdle();
+			m_Swapchain->WaitForPresentLatency();
 		}
+
+		m_FramePacer->WaitForNextFrame(pacingMode);
+		const std::chrono::steady_clock::time_point inputSampleTime = std::chrono::steady_clock::now();
+
+		const uint32_t fixedTickCount = m_FramePacer->BeginFrame();
+		const AkFrameTime& frameTime = m_FramePacer->GetFrameTime();
+
+		// Every tick consumes the input events that happened up to its end, inputs keep their order and spacing at any tick rate
+		for (uint32_t i = 0; i < fixedTickCount && callbacks.onFixedUpdate; ++i)
+		{
+			AkEvents::SetInputWindowEnd(m_FramePacer->GetFixedTickEndTimestamp(i));
+			callbacks.onFixedUpdate(frameTime.fixedDeltaTime);
+		}
+
+		// Nothing is visible, so no frame is handed to the render thread
+		if (pacingMode == AkFramePacingMode::MINIMIZED)
+			continue;
+
+		// Events past the last tick end belong to the ticks of the next frame, the frame update only consumes them when nothing ticks
+		if (!callbacks.onFixedUpdate)
+			AkEvents::SetInputWindowEnd(frameTime.timestamp);
+
+		AkRenderCommandStream& commandStream = m_RenderThread->BeginFrame();
+		if (callbacks.onUpdate)
+			callbacks.onUpdate(frameTime, commandStream);
+
+		m_RenderThread->EndFrame(inputSampleTime);
 	}
+
+	m_RenderThread->WaitIdle();
+}
+
+AkEngineStats Awki::GetStats() const
+{
+	const AkFrameTime& frameTime = m_FramePacer->GetFrameTime();
+
+	return
+	{
+		.frameIndex = frameTime.frameIndex,
+		.frameTime = frameTime.deltaTime,
+		.inputLatency = m_Swapchain->GetInputLatency(),
+		.isLowLatencyMode = m_IsLowLatencyMode,
+		.usesPresentWait = AkDevice::SupportsPresentWait(),
+		.renderScale = m_Swapchain->GetRenderScale(),
+		.gpuTime = m_Swapchain->GetGpuTime()
+	};
 }
\ No newline at end of file
@@ -1,8 +1,11 @@
 #pragma once
 #include "Version.h"
+#include "FramePacer.h"
 #include "Platform/Window.h"
+#include "RHI/Swapchain.h"
 
 #include <memory>
+#include <functional>
 #include <string_view>
 
 struct AkInstanceDescriptor
@@ -10,6 +13,41 @@ struct AkInstanceDescriptor
 	std::string_view gameName = {};
 	AkVersion gameVersion = {};
 	AkWindowDescriptor windowDescriptor = {};
+	AkSwapchainDescriptor swapchainDescriptor = {};
+
+	// Number of frames the simulation can run ahead of the render thread
+	uint32_t renderPipelineDepth = 2;
+
+	// Samples input only once the previous frame was presented and keeps the simulation in lockstep with the render thread
+	bool lowLatencyMode = false;
+
+	AkFramePacingDescriptor framePacing = {};
+};
+
+struct AkGameCallbacks
+{
+	// Runs on the main thread at the fixed tick rate, as many times as needed to catch up with the frame time.
+	// AkEvents::PopInputEvent hands out the input events up to the end of the tick being run.
+	std::function<void(const float fixedDeltaTime)> onFixedUpdate = nullptr;
+
+	// Runs on the main thread once per visible frame, commands written to the stream are rendered on the render thread.
+	// Input events are left to the fixed update when there is one, otherwise it receives those up to the frame start.
+	std::function<void(const AkFrameTime& frameTime, class AkRenderCommandStream& commandStream)> onUpdate = nullptr;
+};
+
+struct AkEngineStats
+{
+	uint64_t frameIndex = 0;
+	float frameTime = 0.f;
+
+	// Milliseconds from input sampling to presentation, or to GPU completion without VK_KHR_present_wait
+	float inputLatency = 0.f;
+	bool isLowLatencyMode = false;
+	bool usesPresentWait = false;
+
+	// Only measured while dynamic resolution is enabled
+	float renderScale = 1.f;
+	float gpuTime = 0.f;
 };
 
 class Awki
@@ -20,9 +58,14 @@ public:
 	Awki(const AkInstanceDescriptor& descriptor);
 	~Awki();
 	
-	void Run();
+	void Run(const AkGameCallbacks& callbacks = {});
+
+	AkEngineStats GetStats() const;
 
 private:
+	bool m_IsLowLatencyMode = false;
 	std::shared_ptr<AkWindow> m_Window = nullptr;
 	std::shared_ptr<class AkSwapchain> m_Swapchain = nullptr;
+	std::unique_ptr<class AkRenderThread> m_RenderThread = nullptr;
+	std::unique_ptr<AkFramePacer> m_FramePacer = nullptr;
 };
\ No newline at end of file
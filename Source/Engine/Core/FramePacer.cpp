@@ -0,0 +1,124 @@
+#include "FramePacer.h"
+#include "Platform/Events.h"
+
+#include <cmath>
+#include <thread>
+#include <algorithm>
+
+static double GetSeconds(const AkFramePacer::AkClock::duration duration)
+{
+	return std::chrono::duration<double>(duration).count();
+}
+
+AkFramePacer::AkFramePacer(const AkFramePacingDescriptor& descriptor)
+{
+	m_Descriptor = descriptor;
+	m_Descriptor.fixedTickRate = std::max(1.f, m_Descriptor.fixedTickRate);
+	m_Descriptor.maxFixedTicksPerFrame = std::max(1u, m_Descriptor.maxFixedTicksPerFrame);
+
+	m_FrameTime.fixedDeltaTime = 1.f / m_Descriptor.fixedTickRate;
+	m_LastFrameStart = AkClock::now();
+	m_NextFrameDeadline = m_LastFrameStart;
+}
+
+void AkFramePacer::WaitForNextFrame(const AkFramePacingMode mode)
+{
+	const double framePeriod = GetFramePeriod(mode);
+	if (framePeriod <= 0.0)
+	{
+		AkEvents::PollEvents();
+		m_NextFrameDeadline = AkClock::now();
+		return;
+	}
+
+	const AkClock::duration period = std::chrono::duration_cast<AkClock::duration>(std::chrono::duration<double>(framePeriod));
+	const AkClock::time_point deadline = m_NextFrameDeadline;
+
+	if (mode == AkFramePacingMode::FOREGROUND)
+	{
+		SleepUntil(deadline);
+		AkEvents::PollEvents();
+	}
+	else
+	{
+		// Only events that change the pacing mode end the wait early, so restoring or focusing the window is handled right away
+		const double remainingTime = std::max(0.0, GetSeconds(deadline - AkClock::now()));
+		AkEvents::WaitEvents(static_cast<uint32_t>(std::ceil(remainingTime * 1000.0)));
+	}
+
+	// Deadlines advance by whole periods to keep the cadence, unless the frame fell more than a period behind
+	const AkClock::time_point now = AkClock::now();
+	m_NextFrameDeadline = now - deadline > period ? now + period : deadline + period;
+}
+
+uint32_t AkFramePacer::BeginFrame()
+{
+	const AkClock::time_point now = AkClock::now();
+	const double deltaTime = GetSeconds(now - m_LastFrameStart);
+	m_LastFrameStart = now;
+	m_FrameTime.timestamp = AkEvents::GetTimestamp();
+
+	const double fixedDeltaTime = m_FrameTime.fixedDeltaTime;
+	m_FixedTimeAccumulator = std::min(m_FixedTimeAccumulator + deltaTime, fixedDeltaTime * m_Descriptor.maxFixedTicksPerFrame);
+
+	const uint32_t fixedTickCount = static_cast<uint32_t>(m_FixedTimeAccumulator / fixedDeltaTime);
+	m_FixedTimeAccumulator -= fixedTickCount * fixedDeltaTime;
+	m_FixedTickCount = fixedTickCount;
+
+	++m_FrameTime.frameIndex;
+	m_FrameTime.deltaTime = static_cast<float>(deltaTime);
+	m_FrameTime.interpolationAlpha = static_cast<float>(m_FixedTimeAccumulator / fixedDeltaTime);
+
+	return fixedTickCount;
+}
+
+uint64_t AkFramePacer::GetFixedTickEndTimestamp(const uint32_t fixedTick) const
+{
+	const double secondsBeforeFrame = m_FixedTimeAccumulator + (m_FixedTickCount - 1.0 - fixedTick) * m_FrameTime.fixedDeltaTime;
+	const uint64_t nanosecondsBeforeFrame = static_cast<uint64_t>(std::max(0.0, secondsBeforeFrame) * 1e9);
+	return m_FrameTime.timestamp - std::min(nanosecondsBeforeFrame, m_FrameTime.timestamp);
+}
+
+void AkFramePacer::SetTargetFrameRate(const float targetFrameRate)
+{
+	m_Descriptor.targetFrameRate = std::max(0.f, targetFrameRate);
+}
+
+double AkFramePacer::GetFramePeriod(const AkFramePacingMode mode) const
+{
+	float frameRate = 0.f;
+	switch (mode)
+	{
+		case AkFramePacingMode::FOREGROUND:	frameRate = m_Descriptor.targetFrameRate;		break;
+		case AkFramePacingMode::BACKGROUND:	frameRate = m_Descriptor.backgroundFrameRate;	break;
+		case AkFramePacingMode::MINIMIZED:	frameRate = m_Descriptor.minimizedFrameRate;	break;
+	}
+
+	return frameRate > 0.f ? 1.0 / frameRate : 0.0;
+}
+
+void AkFramePacer::SleepUntil(const AkClock::time_point deadline)
+{
+	// Recent samples weigh more, the oversleep changes with the timer resolution and the load of the system
+	static constexpr double kSleepErrorSmoothing = 0.1;
+	static constexpr double kMaxSpinMargin = 0.004;
+
+	while (true)
+	{
+		const double remainingTime = GetSeconds(deadline - AkClock::now());
+		if (remainingTime <= m_SpinMargin)
+			break;
+
+		const double requestedTime = remainingTime - m_SpinMargin;
+		const AkClock::time_point sleepStart = AkClock::now();
+		std::this_thread::sleep_for(std::chrono::duration<double>(requestedTime));
+		const double sleepError = GetSeconds(AkClock::now() - sleepStart) - requestedTime;
+
+		m_SleepErrorMean += kSleepErrorSmoothing * (sleepError - m_SleepErrorMean);
+		m_SleepErrorDeviation += kSleepErrorSmoothing * (std::abs(sleepError - m_SleepErrorMean) - m_SleepErrorDeviation);
+		m_SpinMargin = std::clamp(m_SleepErrorMean + 2.0 * m_SleepErrorDeviation, 0.0, kMaxSpinMargin);
+	}
+
+	while (AkClock::now() < deadline)
+		std::this_thread::yield();
+}
\ No newline at end of file
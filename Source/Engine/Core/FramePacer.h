@@ -0,0 +1,72 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+
+enum class AkFramePacingMode
+{
+	FOREGROUND,
+	BACKGROUND,
+	MINIMIZED
+};
+
+struct AkFramePacingDescriptor
+{
+	// Zero leaves the foreground frame rate uncapped
+	float targetFrameRate = 0.f;
+	float backgroundFrameRate = 30.f;
+	float minimizedFrameRate = 4.f;
+
+	float fixedTickRate = 60.f;
+	// Fixed ticks dropped past this count, so a long hitch does not make every following frame catch up
+	uint32_t maxFixedTicksPerFrame = 8;
+};
+
+struct AkFrameTime
+{
+	uint64_t frameIndex = 0;
+	float deltaTime = 0.f;
+
+	// Nanoseconds on the clock of input event timestamps when the frame began
+	uint64_t timestamp = 0;
+	float fixedDeltaTime = 0.f;
+
+	// How far this frame is past the last fixed tick in fixed steps, used to interpolate simulated state
+	float interpolationAlpha = 0.f;
+};
+
+class AkFramePacer
+{
+public:
+	using AkClock = std::chrono::steady_clock;
+
+	AkFramePacer(const AkFramePacingDescriptor& descriptor);
+
+	// Holds the frame until the period of the mode elapsed and pumps events, out of the foreground the wait blocks inside the event queue
+	void WaitForNextFrame(const AkFramePacingMode mode);
+
+	// Advances the frame time and returns the number of fixed ticks to simulate before the frame
+	uint32_t BeginFrame();
+
+	// Fixed ticks end one fixed step apart, the last one before the frame start by what is left in the accumulator
+	uint64_t GetFixedTickEndTimestamp(const uint32_t fixedTick) const;
+
+	void SetTargetFrameRate(const float targetFrameRate);
+	const AkFrameTime& GetFrameTime() const { return m_FrameTime; }
+
+private:
+	AkFramePacingDescriptor m_Descriptor = {};
+	AkFrameTime m_FrameTime = {};
+
+	double m_FixedTimeAccumulator = 0.0;
+	uint32_t m_FixedTickCount = 0;
+	AkClock::time_point m_LastFrameStart = {};
+	AkClock::time_point m_NextFrameDeadline = {};
+
+	// Moving averages of how far sleeps overshoot what was requested, the spin phase before the deadline covers their mean plus two deviations
+	double m_SleepErrorMean = 0.001;
+	double m_SleepErrorDeviation = 0.0005;
+	double m_SpinMargin = 0.002;
+
+	double GetFramePeriod(const AkFramePacingMode mode) const;
+	void SleepUntil(const AkClock::time_point deadline);
+};
\ No newline at end of file
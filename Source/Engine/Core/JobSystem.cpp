@@ -0,0 +1,357 @@
+#include "JobSystem.h"
+#include "Core/Log.h"
+
+#include <mutex>
+#include <array>
+#include <memory>
+#include <thread>
+#include <vector>
+
+static constexpr int64_t kJobDequeCapacity = 4096;
+static constexpr uint32_t kJobPoolSize = 2 * kJobDequeCapacity;
+static constexpr uint32_t kRangesPerThread = 4;
+static constexpr uint32_t kSpinAttempts = 64;
+
+struct AkJob
+{
+	AkJobFunction function = nullptr;
+	AkJobCounter* counter = nullptr;
+	const AkJobCounter* dependency = nullptr;
+};
+
+// Chase-Lev deque with the memory orderings from Le et al., the owner pushes and pops at the bottom while thieves take from the top
+class AkJobDeque
+{
+public:
+	bool Push(AkJob* job)
+	{
+		const int64_t bottom = m_Bottom.load(std::memory_order_relaxed);
+		const int64_t top = m_Top.load(std::memory_order_acquire);
+		if (bottom - top >= kJobDequeCapacity)
+			return false;
+
+		m_Jobs[bottom & (kJobDequeCapacity - 1)].store(job, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+		return true;
+	}
+
+	AkJob* Pop()
+	{
+		const int64_t bottom = m_Bottom.load(std::memory_order_relaxed) - 1;
+		m_Bottom.store(bottom, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		int64_t top = m_Top.load(std::memory_order_relaxed);
+
+		if (top > bottom)
+		{
+			m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+			return nullptr;
+		}
+
+		AkJob* job = m_Jobs[bottom & (kJobDequeCapacity - 1)].load(std::memory_order_relaxed);
+		if (top == bottom)
+		{
+			// Only one job left, thieves may be racing for it
+			if (!m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+				job = nullptr;
+
+			m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+		}
+
+		return job;
+	}
+
+	AkJob* Steal()
+	{
+		int64_t top = m_Top.load(std::memory_order_acquire);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		const int64_t bottom = m_Bottom.load(std::memory_order_acquire);
+
+		if (top >= bottom)
+			return nullptr;
+
+		AkJob* job = m_Jobs[top & (kJobDequeCapacity - 1)].load(std::memory_order_relaxed);
+		if (!m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+			return nullptr;
+
+		return job;
+	}
+
+private:
+	std::atomic<int64_t> m_Top = 0;
+	std::atomic<int64_t> m_Bottom = 0;
+	std::array<std::atomic<AkJob*>, kJobDequeCapacity> m_Jobs = {};
+};
+
+struct AkJobWorker
+{
+	AkJobDeque deque;
+	std::thread thread;
+
+	// Slots are recycled in ring order, jobs are moved out of them once taken so a running job never lives in a slot being reused
+	uint32_t nextJob = 0;
+	std::vector<AkJob> jobPool = std::vector<AkJob>(kJobPoolSize);
+};
+
+// Workers[0] is the thread that initialized the system, the shared worker takes jobs from every other thread
+static std::vector<std::unique_ptr<AkJobWorker>> sWorkers;
+static std::unique_ptr<AkJobWorker> sSharedWorker = nullptr;
+static std::mutex sSharedWorkerMutex;
+
+static std::atomic<bool> sShouldExit = false;
+static std::atomic<uint32_t> sWakeCounter = 0;
+static std::atomic<uint32_t> sSleepingWorkers = 0;
+
+// Jobs whose dependency was still pending when they were picked up, resumed by the job completing a counter or by threads that run out of work
+static std::mutex sParkedJobsMutex;
+static std::vector<AkJob> sParkedJobs;
+static std::atomic<uint32_t> sParkedJobCount = 0;
+
+static thread_local AkJobWorker* sCurrentWorker = nullptr;
+static thread_local uint32_t sRandomState = 0;
+
+static bool PushJob(AkJobWorker& worker, AkJob& job)
+{
+	// The slot is only claimed once pushed, the slots behind it still hold the jobs queued in the deque
+	AkJob& pooledJob = worker.jobPool[worker.nextJob % kJobPoolSize];
+	pooledJob = std::move(job);
+
+	if (worker.deque.Push(&pooledJob))
+	{
+		++worker.nextJob;
+		return true;
+	}
+
+	// The job is run inline by the caller
+	job = std::move(pooledJob);
+	return false;
+}
+
+static AkJob* StealJob()
+{
+	if (sRandomState == 0)
+		sRandomState = static_cast<uint32_t>(std::hash<std::thread::id>()(std::this_thread::get_id())) | 1;
+
+	sRandomState ^= sRandomState << 13;
+	sRandomState ^= sRandomState >> 17;
+	sRandomState ^= sRandomState << 5;
+
+	// The shared worker is the last victim slot, visited in the same random rotation as the workers
+	const uint32_t victimCount = static_cast<uint32_t>(sWorkers.size()) + 1;
+	for (uint32_t i = 0; i < victimCount; ++i)
+	{
+		const uint32_t victimIndex = (sRandomState + i) % victimCount;
+		AkJobWorker* victim = victimIndex < sWorkers.size() ? sWorkers[victimIndex].get() : sSharedWorker.get();
+		if (victim == sCurrentWorker)
+			continue;
+
+		if (AkJob* job = victim->deque.Steal())
+			return job;
+	}
+
+	return nullptr;
+}
+
+bool AkJobSystem::Initialize(const uint32_t workerCount)
+{
+	const uint32_t coreCount = std::max(2u, std::thread::hardware_concurrency());
+	const uint32_t threadCount = workerCount > 0 ? workerCount : coreCount - 1;
+
+	sShouldExit = false;
+	sSharedWorker = std::make_unique<AkJobWorker>();
+
+	sWorkers.resize(threadCount + 1);
+	for (std::unique_ptr<AkJobWorker>& worker : sWorkers)
+		worker = std::make_unique<AkJobWorker>();
+
+	sCurrentWorker = sWorkers[0].get();
+
+	try
+	{
+		for (uint32_t i = 1; i < sWorkers.size(); ++i)
+			sWorkers[i]->thread = std::thread(&AkJobSystem::WorkerThread, i);
+	}
+	catch (const std::exception& exception)
+	{
+		AkLogError("Failed to start job system worker: {}", exception.what());
+		return false;
+	}
+
+	AkLogInfo("Job system started with {} workers", threadCount);
+	return true;
+}
+
+void AkJobSystem::Deinitialize()
+{
+	sShouldExit = true;
+	++sWakeCounter;
+	sWakeCounter.notify_all();
+
+	for (std::unique_ptr<AkJobWorker>& worker : sWorkers)
+	{
+		if (worker->thread.joinable())
+			worker->thread.join();
+	}
+
+	sWorkers.clear();
+	sSharedWorker.reset();
+	sParkedJobs.clear();
+	sParkedJobCount = 0;
+	sCurrentWorker = nullptr;
+}
+
+void AkJobSystem::Schedule(AkJobFunction&& function, AkJobCounter* counter, const AkJobCounter* dependency)
+{
+	if (counter != nullptr)
+		counter->m_Value.fetch_add(1, std::memory_order_relaxed);
+
+	AkJob job = { .function = std::move(function), .counter = counter, .dependency = dependency };
+	Enqueue(job);
+}
+
+void AkJobSystem::Wait(const AkJobCounter& counter)
+{
+	WaitUntil([&counter]() { return counter.IsDone(); });
+}
+
+uint32_t AkJobSystem::GetWorkerCount()
+{
+	return sWorkers.empty() ? 0 : static_cast<uint32_t>(sWorkers.size()) - 1;
+}
+
+uint32_t AkJobSystem::GetGrainSize(const uint32_t count)
+{
+	const uint32_t rangeCount = std::max<uint32_t>(1, static_cast<uint32_t>(sWorkers.size()) * kRangesPerThread);
+	return std::max(1u, (count + rangeCount - 1) / rangeCount);
+}
+
+void AkJobSystem::Enqueue(AkJob& job)
+{
+	bool pushed = false;
+	if (sCurrentWorker != nullptr)
+	{
+		pushed = PushJob(*sCurrentWorker, job);
+	}
+	else
+	{
+		std::scoped_lock lock(sSharedWorkerMutex);
+		pushed = PushJob(*sSharedWorker, job);
+	}
+
+	if (!pushed)
+	{
+		ExecuteJob(job);
+		return;
+	}
+
+	++sWakeCounter;
+	if (sSleepingWorkers > 0)
+		sWakeCounter.notify_one();
+}
+
+void AkJobSystem::ExecuteJob(AkJob& job)
+{
+	if (job.dependency != nullptr && !job.dependency->IsDone())
+	{
+		std::scoped_lock lock(sParkedJobsMutex);
+
+		// Counted before the dependency is checked again, the job completing it then either sees this one parked or it is seen done here
+		++sParkedJobCount;
+		if (job.dependency->m_Value.load(std::memory_order_seq_cst) != 0)
+		{
+			sParkedJobs.push_back(std::move(job));
+			return;
+		}
+
+		--sParkedJobCount;
+	}
+
+	job.function();
+	job.function = nullptr;
+
+	// The counter may be destroyed by its waiter as soon as it reaches zero, only the parked jobs are looked at afterwards
+	if (job.counter != nullptr && job.counter->m_Value.fetch_sub(1, std::memory_order_seq_cst) == 1 && sParkedJobCount.load(std::memory_order_seq_cst) > 0)
+		ResumeParkedJobs();
+}
+
+bool AkJobSystem::ExecuteNextJob()
+{
+	AkJob* job = nullptr;
+	if (sCurrentWorker != nullptr)
+	{
+		job = sCurrentWorker->deque.Pop();
+	}
+	else
+	{
+		std::scoped_lock lock(sSharedWorkerMutex);
+		job = sSharedWorker->deque.Pop();
+	}
+
+	if (job == nullptr)
+		job = StealJob();
+
+	if (job == nullptr)
+		return ResumeParkedJobs();
+
+	AkJob takenJob = std::move(*job);
+	ExecuteJob(takenJob);
+	return true;
+}
+
+bool AkJobSystem::ResumeParkedJobs()
+{
+	if (sParkedJobCount == 0)
+		return false;
+
+	// Enqueueing may run a job inline that resumes parked jobs again, so every call gathers into its own list
+	std::vector<AkJob> readyJobs;
+
+	{
+		std::scoped_lock lock(sParkedJobsMutex);
+		for (size_t i = 0; i < sParkedJobs.size();)
+		{
+			if (sParkedJobs[i].dependency->IsDone())
+			{
+				readyJobs.push_back(std::move(sParkedJobs[i]));
+				sParkedJobs[i] = std::move(sParkedJobs.back());
+				sParkedJobs.pop_back();
+				--sParkedJobCount;
+			}
+			else
+			{
+				++i;
+			}
+		}
+	}
+
+	for (AkJob& readyJob : readyJobs)
+	{
+		readyJob.dependency = nullptr;
+		Enqueue(readyJob);
+	}
+
+	return !readyJobs.empty();
+}
+
+void AkJobSystem::WorkerThread(const uint32_t workerIndex)
+{
+	sCurrentWorker = sWorkers[workerIndex].get();
+
+	while (!sShouldExit)
+	{
+		const uint32_t wakeCounter = sWakeCounter;
+
+		bool executedJob = false;
+		for (uint32_t i = 0; i < kSpinAttempts && !executedJob; ++i)
+			executedJob = ExecuteNextJob();
+
+		if (executedJob)
+			continue;
+
+		// Any job scheduled since the counter was read changed it, so the wait returns right away instead of missing it
+		++sSleepingWorkers;
+		sWakeCounter.wait(wakeCounter);
+		--sSleepingWorkers;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,173 @@
+#pragma once
+#include <new>
+#include <atomic>
+#include <thread>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+#include <type_traits>
+
+// Counts the jobs scheduled against it that have not finished yet
+class AkJobCounter
+{
+public:
+	bool IsDone() const { return m_Value.load(std::memory_order_acquire) == 0; }
+
+private:
+	friend class AkJobSystem;
+	std::atomic<uint32_t> m_Value = 0;
+};
+
+// Move only callable stored inline, scheduling a job never allocates. Captures that do not fit are passed by pointer instead.
+class AkJobFunction
+{
+public:
+	static constexpr size_t kStorageSize = 48;
+
+	AkJobFunction() = default;
+	AkJobFunction(std::nullptr_t) {}
+
+	template<typename Function> requires (!std::is_same_v<std::remove_cvref_t<Function>, AkJobFunction> && std::is_invocable_r_v<void, std::decay_t<Function>&>)
+	AkJobFunction(Function&& function)
+	{
+		using Callable = std::decay_t<Function>;
+		static_assert(sizeof(Callable) <= kStorageSize && alignof(Callable) <= alignof(std::max_align_t), "Job captures do not fit the inline storage of AkJobFunction");
+		static_assert(std::is_nothrow_move_constructible_v<Callable>, "Job captures must be nothrow move constructible");
+
+		new (m_Storage) Callable(std::forward<Function>(function));
+		m_Invoke = &Invoke<Callable>;
+		m_Relocate = &Relocate<Callable>;
+	}
+
+	AkJobFunction(AkJobFunction&& other) noexcept { MoveFrom(other); }
+	AkJobFunction& operator=(AkJobFunction&& other) noexcept
+	{
+		if (this != &other)
+		{
+			Reset();
+			MoveFrom(other);
+		}
+
+		return *this;
+	}
+
+	AkJobFunction& operator=(std::nullptr_t)
+	{
+		Reset();
+		return *this;
+	}
+
+	AkJobFunction(const AkJobFunction&) = delete;
+	AkJobFunction& operator=(const AkJobFunction&) = delete;
+
+	~AkJobFunction() { Reset(); }
+
+	explicit operator bool() const { return m_Invoke != nullptr; }
+	void operator()() { m_Invoke(m_Storage); }
+
+private:
+	alignas(std::max_align_t) std::byte m_Storage[kStorageSize];
+	void (*m_Invoke)(void* storage) = nullptr;
+	// Moves the callable into the destination storage if there is one and destroys the source
+	void (*m_Relocate)(void* destination, void* source) = nullptr;
+
+	template<typename Callable>
+	static void Invoke(void* storage)
+	{
+		(*static_cast<Callable*>(storage))();
+	}
+
+	template<typename Callable>
+	static void Relocate(void* destination, void* source)
+	{
+		Callable* callable = static_cast<Callable*>(source);
+		if (destination != nullptr)
+			new (destination) Callable(std::move(*callable));
+
+		callable->~Callable();
+	}
+
+	void MoveFrom(AkJobFunction& other)
+	{
+		if (!other)
+			return;
+
+		other.m_Relocate(m_Storage, other.m_Storage);
+		m_Invoke = std::exchange(other.m_Invoke, nullptr);
+		m_Relocate = std::exchange(other.m_Relocate, nullptr);
+	}
+
+	void Reset()
+	{
+		if (m_Relocate != nullptr)
+			m_Relocate(nullptr, m_Storage);
+
+		m_Invoke = nullptr;
+		m_Relocate = nullptr;
+	}
+};
+
+// Work stealing scheduler with one worker per core, every worker owns a Chase-Lev deque and steals from the others when it runs dry.
+// Threads that are not workers push into a shared queue, waiting on a counter executes jobs instead of blocking.
+class AkJobSystem
+{
+public:
+	// Zero worker count spawns a worker for every core beside the one of the calling thread
+	static bool Initialize(const uint32_t workerCount = 0);
+	static void Deinitialize();
+
+	// The counter is incremented now and decremented once the job ran.
+	// Jobs with a pending dependency are parked without occupying a thread and resumed once the last job of the dependency ran, the dependency must outlive them.
+	static void Schedule(AkJobFunction&& function, AkJobCounter* counter = nullptr, const AkJobCounter* dependency = nullptr);
+
+	// Executes pending jobs on the calling thread until the counter reaches zero
+	static void Wait(const AkJobCounter& counter);
+
+	template<typename Predicate>
+	static void WaitUntil(Predicate&& isDone)
+	{
+		while (!isDone())
+		{
+			if (!ExecuteNextJob())
+				std::this_thread::yield();
+		}
+	}
+
+	// Splits [0, count) into ranges sized so every thread gets a few of them and blocks until all indices ran
+	template<typename Function>
+	static void ParallelFor(const uint32_t count, Function&& function)
+	{
+		const uint32_t grainSize = GetGrainSize(count);
+		if (grainSize >= count)
+		{
+			for (uint32_t i = 0; i < count; ++i)
+				function(i);
+
+			return;
+		}
+
+		AkJobCounter counter;
+		for (uint32_t begin = 0; begin < count; begin += grainSize)
+		{
+			const uint32_t end = std::min(count, begin + grainSize);
+			Schedule([&function, begin, end]()
+			{
+				for (uint32_t i = begin; i < end; ++i)
+					function(i);
+			}, &counter);
+		}
+
+		Wait(counter);
+	}
+
+	static uint32_t GetWorkerCount();
+
+private:
+	static uint32_t GetGrainSize(const uint32_t count);
+	static void Enqueue(struct AkJob& job);
+	static void ExecuteJob(struct AkJob& job);
+	static bool ExecuteNextJob();
+	static bool ResumeParkedJobs();
+	static void WorkerThread(const uint32_t workerIndex);
+};
\ No newline at end of file
@@ -0,0 +1,62 @@
+#include "RenderCommandStream.h"
+
+template<typename Function>
+void AkRenderCommandStream::ForEachCommand(Function&& function)
+{
+	static constexpr size_t kCommandOffset = AlignUp(sizeof(AkCommandHeader));
+
+	for (AkCommandBlock& block : m_Blocks)
+	{
+		size_t offset = 0;
+		while (offset < block.usedSize)
+		{
+			std::byte* memory = block.memory.get() + offset;
+			AkCommandHeader* header = std::launder(reinterpret_cast<AkCommandHeader*>(memory));
+
+			function(header, memory + kCommandOffset);
+			offset += header->size;
+		}
+	}
+}
+
+AkRenderCommandStream::~AkRenderCommandStream()
+{
+	Reset();
+}
+
+void AkRenderCommandStream::Execute(const AkRenderContext& context)
+{
+	ForEachCommand([&context](AkCommandHeader* header, void* commandMemory)
+	{
+		header->execute(commandMemory, context);
+	});
+}
+
+void AkRenderCommandStream::Reset()
+{
+	ForEachCommand([](AkCommandHeader* header, void* commandMemory)
+	{
+		header->destroy(commandMemory);
+	});
+
+	for (AkCommandBlock& block : m_Blocks)
+		block.usedSize = 0;
+
+	m_CommandCount = 0;
+	m_CurrentBlock = 0;
+}
+
+std::byte* AkRenderCommandStream::Allocate(const size_t size)
+{
+	if (!m_Blocks.empty() && m_Blocks[m_CurrentBlock].usedSize + size > kBlockSize)
+		++m_CurrentBlock;
+
+	if (m_CurrentBlock == m_Blocks.size())
+		m_Blocks.push_back({ .memory = std::make_unique<std::byte[]>(kBlockSize) });
+
+	AkCommandBlock& block = m_Blocks[m_CurrentBlock];
+	std::byte* memory = block.memory.get() + block.usedSize;
+	block.usedSize += size;
+
+	return memory;
+}
\ No newline at end of file
@@ -0,0 +1,90 @@
+#pragma once
+#include <new>
+#include <memory>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <type_traits>
+#include <glm/vec2.hpp>
+
+struct AkRenderContext
+{
+	class AkCommandBuffer* commandBuffer = nullptr;
+	class AkTexture* renderTarget = nullptr;
+
+	// Region of the render target to draw into, smaller than the target itself while dynamic resolution scales down
+	glm::uvec2 renderSize = {};
+};
+
+// Commands written by the simulation for one frame and replayed by the render thread once it turns that frame into GPU work.
+// Commands live in fixed size blocks that are kept between frames, so steady state frames do not allocate.
+class AkRenderCommandStream
+{
+public:
+	static constexpr size_t kBlockSize = 64 * 1024;
+
+	AkRenderCommandStream() = default;
+	~AkRenderCommandStream();
+
+	AkRenderCommandStream(const AkRenderCommandStream&) = delete;
+	AkRenderCommandStream& operator=(const AkRenderCommandStream&) = delete;
+
+	template<typename Command>
+	void Enqueue(Command&& command)
+	{
+		using CommandType = std::decay_t<Command>;
+		static_assert(std::is_invocable_v<CommandType&, const AkRenderContext&>, "Render commands must be invocable with an AkRenderContext");
+		static_assert(alignof(CommandType) <= alignof(std::max_align_t), "Render commands can not be over aligned");
+
+		static constexpr size_t kCommandOffset = AlignUp(sizeof(AkCommandHeader));
+		static constexpr size_t kCommandSize = AlignUp(kCommandOffset + sizeof(CommandType));
+		static_assert(kCommandSize <= kBlockSize, "Render command does not fit in a stream block");
+
+		std::byte* memory = Allocate(kCommandSize);
+		AkCommandHeader* header = new (memory) AkCommandHeader();
+		header->size = static_cast<uint32_t>(kCommandSize);
+		header->execute = [](void* commandMemory, const AkRenderContext& context) { (*static_cast<CommandType*>(commandMemory))(context); };
+		header->destroy = [](void* commandMemory) { static_cast<CommandType*>(commandMemory)->~CommandType(); };
+
+		new (memory + kCommandOffset) CommandType(std::forward<Command>(command));
+		++m_CommandCount;
+	}
+
+	// Runs every command in the order it was enqueued
+	void Execute(const AkRenderContext& context);
+
+	// Destroys every command but keeps the blocks for the next frame
+	void Reset();
+
+	uint32_t GetCommandCount() const { return m_CommandCount; }
+
+private:
+	struct AkCommandHeader
+	{
+		void (*execute)(void* commandMemory, const AkRenderContext& context) = nullptr;
+		void (*destroy)(void* commandMemory) = nullptr;
+		uint32_t size = 0;
+	};
+
+	struct AkCommandBlock
+	{
+		std::unique_ptr<std::byte[]> memory = nullptr;
+		size_t usedSize = 0;
+	};
+
+	uint32_t m_CommandCount = 0;
+	uint32_t m_CurrentBlock = 0;
+	std::vector<AkCommandBlock> m_Blocks;
+
+	static constexpr size_t AlignUp(const size_t size)
+	{
+		constexpr size_t kAlignment = alignof(std::max_align_t);
+		return (size + kAlignment - 1) & ~(kAlignment - 1);
+	}
+
+	std::byte* Allocate(const size_t size);
+
+	template<typename Function>
+	void ForEachCommand(Function&& function);
+};
\ No newline at end of file
@@ -0,0 +1,119 @@
+#include "RenderThread.h"
+#include "Core/Log.h"
+#include "RHI/Swapchain.h"
+#include "RHI/Textures/TextureStreamer.h"
+#include "RHI/CommandBuffers/CommandBuffer.h"
+#include "RHI/CommandBuffers/CommandBufferAllocator.h"
+
+#include <algorithm>
+
+AkRenderThread::AkRenderThread(const std::shared_ptr<AkSwapchain>& swapchain, const uint32_t pipelineDepth)
+{
+	m_Swapchain = swapchain;
+	m_PipelineDepth = std::clamp(pipelineDepth, 1u, kMaxPipelineDepth);
+
+	for (uint32_t i = 0; i < m_PipelineDepth; ++i)
+		m_CommandStreams.push_back(std::make_unique<AkRenderCommandStream>());
+
+	m_InputSampleTimes.resize(m_PipelineDepth);
+
+	m_Thread = std::thread(&AkRenderThread::RenderLoop, this);
+	AkLogInfo("Render thread started with a pipeline depth of {}", m_PipelineDepth);
+}
+
+AkRenderThread::~AkRenderThread()
+{
+	{
+		std::scoped_lock lock(m_Mutex);
+		m_ShouldExit = true;
+	}
+
+	m_Condition.notify_all();
+	if (m_Thread.joinable())
+		m_Thread.join();
+}
+
+AkRenderCommandStream& AkRenderThread::BeginFrame()
+{
+	std::unique_lock lock(m_Mutex);
+	m_Condition.wait(lock, [this]() { return m_SubmittedFrames - m_RenderedFrames < m_PipelineDepth; });
+
+	return *m_CommandStreams[m_SubmittedFrames % m_PipelineDepth];
+}
+
+void AkRenderThread::EndFrame(const std::chrono::steady_clock::time_point inputSampleTime)
+{
+	{
+		std::scoped_lock lock(m_Mutex);
+		m_InputSampleTimes[m_SubmittedFrames % m_PipelineDepth] = inputSampleTime;
+		++m_SubmittedFrames;
+	}
+
+	m_Condition.notify_all();
+}
+
+void AkRenderThread::WaitIdle()
+{
+	std::unique_lock lock(m_Mutex);
+	m_Condition.wait(lock, [this]() { return m_SubmittedFrames == m_RenderedFrames; });
+}
+
+void AkRenderThread::RenderLoop()
+{
+	while (true)
+	{
+		AkRenderCommandStream* commandStream = nullptr;
+		std::chrono::steady_clock::time_point inputSampleTime = {};
+
+		{
+			std::unique_lock lock(m_Mutex);
+			m_Condition.wait(lock, [this]() { return m_ShouldExit || m_SubmittedFrames != m_RenderedFrames; });
+
+			// Frames already handed over are still rendered, so nothing the simulation wrote is lost on exit
+			if (m_SubmittedFrames == m_RenderedFrames)
+				return;
+
+			commandStream = m_CommandStreams[m_RenderedFrames % m_PipelineDepth].get();
+			inputSampleTime = m_InputSampleTimes[m_RenderedFrames % m_PipelineDepth];
+		}
+
+		RenderFrame(*commandStream, inputSampleTime);
+		commandStream->Reset();
+
+		{
+			std::scoped_lock lock(m_Mutex);
+			++m_RenderedFrames;
+		}
+
+		m_Condition.notify_all();
+	}
+}
+
+void AkRenderThread::RenderFrame(AkRenderCommandStream& commandStream, const std::chrono::steady_clock::time_point inputSampleTime)
+{
+	if (!m_Swapchain->Prepare())
+		return;
+
+	// Streaming is recorded ahead of the frame in the same command buffer, so the frame samples the textures it just swapped in
+	AkCommandBuffer* commandBuffer = AkCommandBufferAllocator::AllocateCommandBuffer(AkDeviceQueue::GRAPHICS);
+	if (commandBuffer != nullptr)
+	{
+		commandBuffer->Begin();
+		AkTextureStreamer::RecordUpdates(commandBuffer);
+
+		if (commandStream.GetCommandCount() > 0)
+		{
+			AkTexture* backBuffer = m_Swapchain->GetCurrentBackBuffer();
+			AkTexture* renderTarget = m_Swapchain->GetRenderTarget();
+			commandStream.Execute({ .commandBuffer = commandBuffer, .renderTarget = renderTarget, .renderSize = m_Swapchain->GetRenderSize() });
+
+			// A scaled render target is upscaled into the back buffer by the swapchain, which then transitions it itself
+			if (renderTarget == backBuffer)
+				commandBuffer->RequireState(backBuffer, AkResourceState::PRESENT);
+		}
+
+		commandBuffer->End();
+	}
+
+	m_Swapchain->Present(commandBuffer, inputSampleTime);
+}
\ No newline at end of file
@@ -0,0 +1,46 @@
+#pragma once
+#include "Core/RenderCommandStream.h"
+
+#include <mutex>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <condition_variable>
+
+// Turns the command streams written by the simulation into GPU work, so simulation of a frame overlaps rendering of the previous ones.
+// The pipeline depth is the number of frames the simulation can have handed over before it waits, one disables the overlap.
+class AkRenderThread
+{
+public:
+	static constexpr uint32_t kMaxPipelineDepth = 4;
+
+	AkRenderThread(const std::shared_ptr<class AkSwapchain>& swapchain, const uint32_t pipelineDepth);
+	~AkRenderThread();
+
+	// Blocks until the render thread released the oldest stream
+	AkRenderCommandStream& BeginFrame();
+	void EndFrame(const std::chrono::steady_clock::time_point inputSampleTime = {});
+
+	// Blocks until every handed over frame has been rendered
+	void WaitIdle();
+
+	uint32_t GetPipelineDepth() const { return m_PipelineDepth; }
+
+private:
+	bool m_ShouldExit = false;
+	uint32_t m_PipelineDepth = 2;
+	uint64_t m_SubmittedFrames = 0;
+	uint64_t m_RenderedFrames = 0;
+
+	std::mutex m_Mutex;
+	std::condition_variable m_Condition;
+	std::thread m_Thread;
+
+	std::shared_ptr<class AkSwapchain> m_Swapchain = nullptr;
+	std::vector<std::unique_ptr<AkRenderCommandStream>> m_CommandStreams;
+	std::vector<std::chrono::steady_clock::time_point> m_InputSampleTimes;
+
+	void RenderLoop();
+	void RenderFrame(AkRenderCommandStream& commandStream, const std::chrono::steady_clock::time_point inputSampleTime);
+};
\ No newline at end of file
@@ -0,0 +1,181 @@
+#pragma once
+#include "Core/Assert.h"
+#include "Core/JobSystem.h"
+
+#include <atomic>
+#include <utility>
+#include <optional>
+#include <exception>
+#include <coroutine>
+
+// Lazily started coroutine that resumes on the job system, either launched with Start or by being awaited from another task.
+// Awaiting a job counter, a file read or a GPU fence suspends the task without blocking the thread that ran it.
+template<typename T = void>
+class AkTask;
+
+struct AkTaskPromiseBase
+{
+	std::coroutine_handle<> continuation = nullptr;
+	std::exception_ptr exception = nullptr;
+	std::atomic<bool> isDone = false;
+
+	struct AkFinalAwaiter
+	{
+		bool await_ready() const noexcept { return false; }
+		void await_resume() const noexcept {}
+
+		template<typename Promise>
+		std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) const noexcept
+		{
+			// The frame can be destroyed as soon as it is flagged done, so the continuation is read before
+			AkTaskPromiseBase& promise = handle.promise();
+			std::coroutine_handle<> continuation = promise.continuation;
+			promise.isDone.store(true, std::memory_order_release);
+
+			return continuation ? continuation : std::noop_coroutine();
+		}
+	};
+
+	std::suspend_always initial_suspend() const noexcept { return {}; }
+	AkFinalAwaiter final_suspend() const noexcept { return {}; }
+	void unhandled_exception() { exception = std::current_exception(); }
+};
+
+template<typename T>
+struct AkTaskPromise : AkTaskPromiseBase
+{
+	std::optional<T> value = std::nullopt;
+
+	AkTask<T> get_return_object();
+
+	template<typename U>
+	void return_value(U&& result) { value.emplace(std::forward<U>(result)); }
+};
+
+template<>
+struct AkTaskPromise<void> : AkTaskPromiseBase
+{
+	AkTask<void> get_return_object();
+	void return_void() const {}
+};
+
+template<typename T>
+class AkTask
+{
+public:
+	using promise_type = AkTaskPromise<T>;
+
+	AkTask() = default;
+	explicit AkTask(const std::coroutine_handle<promise_type> handle) : m_Handle(handle) {}
+
+	AkTask(AkTask&& other) noexcept : m_IsStarted(std::exchange(other.m_IsStarted, false)), m_Handle(std::exchange(other.m_Handle, nullptr)) {}
+	AkTask& operator=(AkTask&& other) noexcept
+	{
+		if (this != &other)
+		{
+			Destroy();
+			m_IsStarted = std::exchange(other.m_IsStarted, false);
+			m_Handle = std::exchange(other.m_Handle, nullptr);
+		}
+
+		return *this;
+	}
+
+	AkTask(const AkTask&) = delete;
+	AkTask& operator=(const AkTask&) = delete;
+
+	~AkTask() { Destroy(); }
+
+	// Runs the task from a job, it must not be awaited afterwards
+	void Start()
+	{
+		AkAssert(m_Handle && !m_IsStarted && !m_Handle.promise().continuation, "Starting an empty or already awaited task");
+		m_IsStarted = true;
+		AkJobSystem::Schedule([handle = m_Handle]() { handle.resume(); });
+	}
+
+	bool IsDone() const { return !m_Handle || m_Handle.promise().isDone.load(std::memory_order_acquire); }
+
+	// Executes other jobs on the calling thread until the started task completed
+	void Wait() const
+	{
+		AkJobSystem::WaitUntil([this]() { return IsDone(); });
+	}
+
+	auto GetResult()
+	{
+		AkAssert(IsDone(), "Reading the result of a task that did not complete");
+		if (m_Handle.promise().exception)
+			std::rethrow_exception(m_Handle.promise().exception);
+
+		if constexpr (!std::is_void_v<T>)
+			return std::move(*m_Handle.promise().value);
+	}
+
+	auto operator co_await() noexcept
+	{
+		struct AkTaskAwaiter
+		{
+			std::coroutine_handle<promise_type> handle;
+
+			bool await_ready() const noexcept { return false; }
+
+			std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaitingHandle) const noexcept
+			{
+				handle.promise().continuation = awaitingHandle;
+				return handle;
+			}
+
+			auto await_resume() const
+			{
+				if (handle.promise().exception)
+					std::rethrow_exception(handle.promise().exception);
+
+				if constexpr (!std::is_void_v<T>)
+					return std::move(*handle.promise().value);
+			}
+		};
+
+		return AkTaskAwaiter{ m_Handle };
+	}
+
+private:
+	bool m_IsStarted = false;
+	std::coroutine_handle<promise_type> m_Handle = nullptr;
+
+	void Destroy()
+	{
+		if (!m_Handle)
+			return;
+
+		AkSoftAssert(IsDone() || !m_IsStarted, "Destroying a task that is still running");
+		m_Handle.destroy();
+		m_Handle = nullptr;
+		m_IsStarted = false;
+	}
+};
+
+template<typename T>
+AkTask<T> AkTaskPromise<T>::get_return_object()
+{
+	return AkTask<T>(std::coroutine_handle<AkTaskPromise<T>>::from_promise(*this));
+}
+
+inline AkTask<void> AkTaskPromise<void>::get_return_object()
+{
+	return AkTask<void>(std::coroutine_handle<AkTaskPromise<void>>::from_promise(*this));
+}
+
+struct AkJobCounterAwaiter
+{
+	const AkJobCounter& counter;
+
+	bool await_ready() const { return counter.IsDone(); }
+	void await_suspend(std::coroutine_handle<> handle) const { AkJobSystem::Schedule([handle]() { handle.resume(); }, nullptr, &counter); }
+	void await_resume() const {}
+};
+
+inline AkJobCounterAwaiter operator co_await(const AkJobCounter& counter)
+{
+	return { counter };
+}
\ No newline at end of file
@@ -1,9 +1,12 @@
 #include "Events.h"
 #include "Core/Log.h"
+#include "Platform/Window.h"
 
 #include <SDL3/SDL.h>
 
 #include <array>
+#include <algorithm>
+#include <immintrin.h>
 
 static constexpr std::array kKeyCodeLookupTable = std::to_array<uint32_t>
 ({
@@ -102,6 +105,7 @@ static constexpr std::array kKeyCodeLookupTable = std::to_array<uint32_t>
 	SDLK_BACKSLASH,
 	SDLK_EQUALS,
 	SDLK_MINUS,
+	SDLK_HASH,
 
 	SDLK_UP,
 	SDLK_DOWN,
@@ -127,6 +131,53 @@ static constexpr std::array kMouseButtonLookupTable = std::to_array<uint8_t>
 	SDL_BUTTON_X2
 });
 
+static constexpr uint32_t kKeyCodeCount = static_cast<uint32_t>(AkKeyCode::NUM_LOCK) + 1;
+static constexpr uint32_t kMouseButtonCount = static_cast<uint32_t>(AkMouseButton::X2) + 1;
+static constexpr uint32_t kInvalidInput = UINT8_MAX;
+static_assert(kKeyCodeLookupTable.size() == kKeyCodeCount, "Every key code needs its SDL key");
+static_assert(kMouseButtonLookupTable.size() == kMouseButtonCount, "Every mouse button needs its SDL button");
+static_assert(kKeyCodeCount + kMouseButtonCount <= 128, "Input states are stored in 128 bit masks");
+
+// SDL keys are either characters or scancodes with a mask bit, both fit a single table once folded next to each other
+static constexpr uint32_t kFoldedKeyCount = 2 * SDL_SCANCODE_COUNT;
+
+// Characters past the scancode range would alias the folded scancodes, they map past the table instead
+static constexpr uint32_t FoldKey(const SDL_Keycode key)
+{
+	if (key & SDLK_SCANCODE_MASK)
+		return SDL_SCANCODE_COUNT + (key & ~SDLK_SCANCODE_MASK);
+
+	return key < SDL_SCANCODE_COUNT ? key : kFoldedKeyCount;
+}
+
+static constexpr std::array kInputIndexLookupTable = []()
+{
+	std::array<uint8_t, kFoldedKeyCount> table = {};
+	table.fill(kInvalidInput);
+
+	for (uint32_t keyIndex = 0; keyIndex < kKeyCodeCount; ++keyIndex)
+		table[FoldKey(kKeyCodeLookupTable[keyIndex])] = static_cast<uint8_t>(keyIndex);
+
+	return table;
+}();
+
+static uint32_t GetKeyInputIndex(const SDL_Keycode key)
+{
+	const uint32_t foldedKey = FoldKey(key);
+	return foldedKey < kFoldedKeyCount ? kInputIndexLookupTable[foldedKey] : kInvalidInput;
+}
+
+// SDL numbers its buttons from one in the same order as ours
+static uint32_t GetMouseButtonInputIndex(const uint8_t button)
+{
+	return button >= SDL_BUTTON_LEFT && button <= SDL_BUTTON_X2 ? kKeyCodeCount + button - SDL_BUTTON_LEFT : kInvalidInput;
+}
+
+static bool TestInput(const std::array<uint64_t, 2>& mask, const uint32_t inputIndex)
+{
+	return (mask[inputIndex >> 6] >> (inputIndex & 63)) & 1;
+}
+
 bool AkEvents::Initialize()
 {
 	if (!SDL_InitSubSystem(SDL_INIT_EVENTS))
@@ -149,59 +200,132 @@ void AkEvents::PollEvents()
 
 	SDL_Event event;
 	while (SDL_PollEvent(&event))
+		ProcessEvent(event);
+}
+
+void AkEvents::WaitEvents(const uint32_t timeoutMilliseconds)
+{
+	m_InputState.BeginFrame();
+
+	// Other events are processed as they come without ending the wait, so a flood of them does not speed up a paced loop
+	const uint64_t deadline = SDL_GetTicks() + timeoutMilliseconds;
+	SDL_Event event;
+
+	for (uint64_t now = SDL_GetTicks(); now < deadline; now = SDL_GetTicks())
+	{
+		if (!SDL_WaitEventTimeout(&event, static_cast<Sint32>(std::min<uint64_t>(deadline - now, INT32_MAX))))
+			break;
+
+		ProcessEvent(event);
+		if (EndsWait(event))
+			break;
+	}
+
+	while (SDL_PollEvent(&event))
+		ProcessEvent(event);
+}
+
+bool AkEvents::EndsWait(const SDL_Event& event)
+{
+	switch (event.type)
 	{
-		switch (event.type)
+		case SDL_EventType::SDL_EVENT_QUIT:
+		case SDL_EventType::SDL_EVENT_WINDOW_CLOSE_REQUESTED:
+		case SDL_EventType::SDL_EVENT_WINDOW_MINIMIZED:
+		case SDL_EventType::SDL_EVENT_WINDOW_RESTORED:
+		case SDL_EventType::SDL_EVENT_WINDOW_MAXIMIZED:
+		case SDL_EventType::SDL_EVENT_WINDOW_SHOWN:
+		case SDL_EventType::SDL_EVENT_WINDOW_HIDDEN:
+		case SDL_EventType::SDL_EVENT_WINDOW_FOCUS_GAINED:
+		case SDL_EventType::SDL_EVENT_WINDOW_FOCUS_LOST:
+			return true;
+		default:
+			return false;
+	}
+}
+
+void AkEvents::ProcessEvent(const SDL_Event& event)
+{
+	switch (event.type)
+	{
+		case SDL_EventType::SDL_EVENT_MOUSE_MOTION:
 		{
-			case SDL_EventType::SDL_EVENT_MOUSE_MOTION:
-			{
-				m_InputState.mousePosition = { event.motion.x, event.motion.y };
-				m_InputState.mouseDelta = { event.motion.xrel, -event.motion.yrel };
-				break;
-			}
-			case SDL_EventType::SDL_EVENT_MOUSE_WHEEL:
-			{
-				const float directionMultiplier = event.wheel.direction == SDL_MOUSEWHEEL_NORMAL ? 1.f : -1.f;
-				m_InputState.mouseWheel.x = directionMultiplier * event.wheel.x;
-				m_InputState.mouseWheel.y = directionMultiplier * event.wheel.y;
-				break;
-			}
-			case SDL_EventType::SDL_EVENT_MOUSE_BUTTON_DOWN:
-			{
-				// http://www-graphics.stanford.edu/~seander/bithacks.html#ConditionalSetOrClearBitsWithoutBranching
-				AkInputState::AkButtonState& state = m_InputState.mouseButtonStates[event.button.button];
-				const bool shouldSet = state & AkInputState::IDLE;
-				state = state ^ ((-static_cast<uint8_t>(shouldSet) ^ state) & AkInputState::PRESSED);
-				break;
-			}
-			case SDL_EventType::SDL_EVENT_MOUSE_BUTTON_UP:
-			{
-				AkInputState::AkButtonState& state = m_InputState.mouseButtonStates[event.button.button];
-				state = AkInputState::RELEASED;
-				break;
-			}
-			case SDL_EventType::SDL_EVENT_KEY_DOWN:
-			{
-				AkInputState::AkButtonState& state = m_InputState.keyStates[event.key.key];
-				const bool shouldSet = state & AkInputState::IDLE;
-				state = state ^ ((-static_cast<uint8_t>(shouldSet) ^ state) & AkInputState::PRESSED);
-				break;
-			}
-			case SDL_EventType::SDL_EVENT_KEY_UP:
-			{
-				AkInputState::AkButtonState& state = m_InputState.keyStates[event.key.key];
-				state = AkInputState::RELEASED;
+			// Several motions can arrive within a frame, the frame delta is their sum
+			const glm::vec2 delta = { event.motion.xrel, -event.motion.yrel };
+			m_InputState.mousePosition = { event.motion.x, event.motion.y };
+			m_InputState.mouseDelta += delta;
+			PushInputEvent({ .timestamp = event.common.timestamp, .type = AkInputEventType::MOUSE_MOTION, .position = m_InputState.mousePosition, .value = delta });
+			break;
+		}
+		case SDL_EventType::SDL_EVENT_MOUSE_WHEEL:
+		{
+			const float directionMultiplier = event.wheel.direction == SDL_MOUSEWHEEL_NORMAL ? 1.f : -1.f;
+			const glm::vec2 scroll = { directionMultiplier * event.wheel.x, directionMultiplier * event.wheel.y };
+			m_InputState.mouseWheel += scroll;
+			PushInputEvent({ .timestamp = event.common.timestamp, .type = AkInputEventType::MOUSE_WHEEL, .position = m_InputState.mousePosition, .value = scroll });
+			break;
+		}
+		case SDL_EventType::SDL_EVENT_MOUSE_BUTTON_DOWN:
+		case SDL_EventType::SDL_EVENT_MOUSE_BUTTON_UP:
+		{
+			const uint32_t inputIndex = GetMouseButtonInputIndex(event.button.button);
+			if (inputIndex == kInvalidInput)
 				break;
-			}
-			case SDL_EventType::SDL_EVENT_QUIT:
-			case SDL_EventType::SDL_EVENT_WINDOW_CLOSE_REQUESTED:
-			{
-				m_ShouldClose = true;
+
+			const bool isDown = event.type == SDL_EVENT_MOUSE_BUTTON_DOWN;
+			if (isDown)
+				SetInputDown(inputIndex);
+			else
+				SetInputUp(inputIndex);
+
+			const AkInputEventType type = isDown ? AkInputEventType::MOUSE_BUTTON_DOWN : AkInputEventType::MOUSE_BUTTON_UP;
+			PushInputEvent({ .timestamp = event.common.timestamp, .type = type, .mouseButton = static_cast<AkMouseButton>(inputIndex - kKeyCodeCount), .position = m_InputState.mousePosition });
+			break;
+		}
+		case SDL_EventType::SDL_EVENT_KEY_DOWN:
+		case SDL_EventType::SDL_EVENT_KEY_UP:
+		{
+			// Repeats only matter to text input, the key already went down
+			const uint32_t inputIndex = GetKeyInputIndex(event.key.key);
+			if (inputIndex == kInvalidInput || event.key.repeat)
 				break;
-			}
+
+			const bool isDown = event.type == SDL_EVENT_KEY_DOWN;
+			if (isDown)
+				SetInputDown(inputIndex);
+			else
+				SetInputUp(inputIndex);
+			PushInputEvent({ .timestamp = event.common.timestamp, .type = isDown ? AkInputEventType::KEY_DOWN : AkInputEventType::KEY_UP, .key = static_cast<AkKeyCode>(inputIndex) });
+			break;
+		}
+		case SDL_EventType::SDL_EVENT_QUIT:
+		case SDL_EventType::SDL_EVENT_WINDOW_CLOSE_REQUESTED:
+		{
+			m_ShouldClose = true;
+			break;
+		}
+	}
+
+	if (event.type >= SDL_EVENT_WINDOW_FIRST && event.type <= SDL_EVENT_WINDOW_LAST)
+	{
+		for (AkWindow* window : m_Windows)
+		{
+			if (window->m_WindowId == event.window.windowID)
+				window->ProcessEvent(event);
 		}
 	}
 }
 
+void AkEvents::RegisterWindow(AkWindow* window)
+{
+	m_Windows.push_back(window);
+}
+
+void AkEvents::UnregisterWindow(AkWindow* window)
+{
+	std::erase(m_Windows, window);
+}
+
 void AkEvents::TriggerQuit()
 {
 	SDL_Event event;
@@ -214,6 +338,39 @@ bool AkEvents::ShouldClose()
 	return m_ShouldClose;
 }
 
+uint64_t AkEvents::GetTimestamp()
+{
+	return SDL_GetTicksNS();
+}
+
+void AkEvents::SetInputWindowEnd(const uint64_t timestamp)
+{
+	m_InputWindowEnd = timestamp;
+}
+
+bool AkEvents::PopInputEvent(AkInputEvent& outEvent)
+{
+	if (m_InputEventReadIndex == m_InputEventWriteIndex)
+		return false;
+
+	const AkInputEvent& inputEvent = m_InputEvents[m_InputEventReadIndex % kInputEventCapacity];
+	if (inputEvent.timestamp > m_InputWindowEnd)
+		return false;
+
+	outEvent = inputEvent;
+	++m_InputEventReadIndex;
+	return true;
+}
+
+void AkEvents::PushInputEvent(const AkInputEvent& inputEvent)
+{
+	if (m_InputEventWriteIndex - m_InputEventReadIndex == kInputEventCapacity)
+		++m_InputEventReadIndex;
+
+	m_InputEvents[m_InputEventWriteIndex % kInputEventCapacity] = inputEvent;
+	++m_InputEventWriteIndex;
+}
+
 const glm::vec2& AkEvents::GetMouseWheel()
 {
 	return m_InputState.mouseWheel;
@@ -231,54 +388,60 @@ const glm::vec2& AkEvents::GetMousePosition()
 
 bool AkEvents::GetKey(AkKeyCode key)
 {
-	const uint32_t storageKey = kKeyCodeLookupTable[static_cast<uint32_t>(key)];
-	return m_InputState.keyStates[storageKey] & AkInputState::HELD;
+	return TestInput(m_InputState.held, static_cast<uint32_t>(key));
 }
 
 bool AkEvents::GetKeyUp(AkKeyCode key)
 {
-	const uint32_t storageKey = kKeyCodeLookupTable[static_cast<uint32_t>(key)];
-	return m_InputState.keyStates[storageKey] & AkInputState::RELEASED;
+	return TestInput(m_InputState.released, static_cast<uint32_t>(key));
 }
 
 bool AkEvents::GetKeyDown(AkKeyCode key)
 {
-	const uint32_t storageKey = kKeyCodeLookupTable[static_cast<uint32_t>(key)];
-	return m_InputState.keyStates[storageKey] & AkInputState::PRESSED;
+	return TestInput(m_InputState.pressed, static_cast<uint32_t>(key));
 }
 
 bool AkEvents::GetMouseButton(AkMouseButton mouseButton)
 {
-	const uint8_t storageKey = kMouseButtonLookupTable[static_cast<uint32_t>(mouseButton)];
-	return m_InputState.mouseButtonStates[storageKey] & AkInputState::HELD;
+	return TestInput(m_InputState.held, kKeyCodeCount + static_cast<uint32_t>(mouseButton));
 }
 
 bool AkEvents::GetMouseButtonUp(AkMouseButton mouseButton)
 {
-	const uint8_t storageKey = kMouseButtonLookupTable[static_cast<uint32_t>(mouseButton)];
-	return m_InputState.mouseButtonStates[storageKey] & AkInputState::RELEASED;
+	return TestInput(m_InputState.released, kKeyCodeCount + static_cast<uint32_t>(mouseButton));
 }
 
 bool AkEvents::GetMouseButtonDown(AkMouseButton mouseButton)
 {
-	const uint8_t storageKey = kMouseButtonLookupTable[static_cast<uint32_t>(mouseButton)];
-	return m_InputState.mouseButtonStates[storageKey] & AkInputState::PRESSED;
+	return TestInput(m_InputState.pressed, kKeyCodeCount + static_cast<uint32_t>(mouseButton));
 }
 
-void AkEvents::AkInputState::BeginFrame()
+// Repeats of a key already down are ignored, a press and release within the same frame still report both
+void AkEvents::SetInputDown(const uint32_t inputIndex)
 {
-	mouseWheel = glm::vec2(0.f);
-	mouseDelta = glm::vec2(0.f);
-
-	for (auto& [keyCode, state] : m_InputState.keyStates)
-		state.Validate();
+	const uint64_t bit = 1ull << (inputIndex & 63);
+	uint64_t& down = m_InputState.down[inputIndex >> 6];
+	m_InputState.pressed[inputIndex >> 6] |= bit & ~down;
+	down |= bit;
+}
 
-	for (auto& [mouseButton, state] : m_InputState.mouseButtonStates)
-		state.Validate();
+// Held inputs stop being held as soon as they are released, rather than at the next frame
+void AkEvents::SetInputUp(const uint32_t inputIndex)
+{
+	const uint64_t bit = 1ull << (inputIndex & 63);
+	uint64_t& down = m_InputState.down[inputIndex >> 6];
+	m_InputState.released[inputIndex >> 6] |= bit & down;
+	m_InputState.held[inputIndex >> 6] &= ~bit;
+	down &= ~bit;
 }
 
-void AkEvents::AkInputState::AkButtonState::Validate()
+void AkEvents::AkInputState::BeginFrame()
 {
-	const bool shift = m_State & (AkInputState::PRESSED | AkInputState::RELEASED);
-	m_State <<= static_cast<uint8_t>(shift);
+	mouseWheel = glm::vec2(0.f);
+	mouseDelta = glm::vec2(0.f);
+
+	// Inputs pressed last frame become held and released ones idle, for every key and button at once
+	_mm_store_si128(reinterpret_cast<__m128i*>(held.data()), _mm_load_si128(reinterpret_cast<const __m128i*>(down.data())));
+	_mm_store_si128(reinterpret_cast<__m128i*>(pressed.data()), _mm_setzero_si128());
+	_mm_store_si128(reinterpret_cast<__m128i*>(released.data()), _mm_setzero_si128());
 }
\ No newline at end of file
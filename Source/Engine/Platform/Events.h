@@ -1,6 +1,8 @@
 #pragma once
+#include <array>
+#include <vector>
+#include <cstdint>
 #include <glm/vec2.hpp>
-#include <unordered_map>
 
 enum class AkKeyCode
 {
@@ -125,6 +127,30 @@ enum class AkMouseButton
 	X2
 };
 
+enum class AkInputEventType
+{
+	KEY_DOWN,
+	KEY_UP,
+	MOUSE_BUTTON_DOWN,
+	MOUSE_BUTTON_UP,
+	MOUSE_MOTION,
+	MOUSE_WHEEL
+};
+
+struct AkInputEvent
+{
+	// Nanoseconds on the clock of GetTimestamp, when the platform received the input
+	uint64_t timestamp = 0;
+	AkInputEventType type = AkInputEventType::KEY_DOWN;
+
+	AkKeyCode key = AkKeyCode::ALPHA_0;
+	AkMouseButton mouseButton = AkMouseButton::LEFT;
+
+	// Motion events carry the cursor position and its delta, wheel events the scrolled amount
+	glm::vec2 position = {};
+	glm::vec2 value = {};
+};
+
 class AkEvents
 {
 public:
@@ -132,9 +158,21 @@ public:
 	static void Deinitialize();
 
 	static void PollEvents();
+
+	// Blocks until the timeout elapsed and processes events meanwhile, quitting or a change of the window focus or visibility ends it early
+	static void WaitEvents(const uint32_t timeoutMilliseconds);
 	static void TriggerQuit();
 	static bool ShouldClose();
 
+	// Nanoseconds since the platform layer initialized, the clock input events are timestamped with
+	static uint64_t GetTimestamp();
+
+	// Input events are queued as they are pumped and consumed in order up to the end of the input window.
+	// The engine moves the window to the end of each fixed tick before running it, and to the frame start only when there is no fixed update.
+	static constexpr uint32_t kInputEventCapacity = 1024;
+	static void SetInputWindowEnd(const uint64_t timestamp);
+	static bool PopInputEvent(AkInputEvent& outEvent);
+
 	static const glm::vec2& GetMouseWheel();
 	static const glm::vec2& GetMouseDelta();
 	static const glm::vec2& GetMousePosition();
@@ -147,39 +185,43 @@ public:
 	static bool GetMouseButtonUp(AkMouseButton mouseButton);
 	static bool GetMouseButtonDown(AkMouseButton mouseButton);
 
+	// Windows receive their own events while they are pumped, so their cached state follows resizes, minimizes and focus changes
+	static void RegisterWindow(class AkWindow* window);
+	static void UnregisterWindow(class AkWindow* window);
+
 private:
+	static void ProcessEvent(const union SDL_Event& event);
+	static bool EndsWait(const union SDL_Event& event);
+
+	static void SetInputDown(const uint32_t inputIndex);
+	static void SetInputUp(const uint32_t inputIndex);
+	static void PushInputEvent(const AkInputEvent& inputEvent);
+
+	// One bit per key followed by one per mouse button, so a frame transition handles every input at once
+	using AkInputMask = std::array<uint64_t, 2>;
+
 	struct AkInputState
 	{
-		enum : uint8_t
-		{
-			PRESSED		= 1 << 0,
-			HELD		= 1 << 1,
-			RELEASED	= 1 << 2,
-			IDLE		= 1 << 3
-		};
-
-		class AkButtonState
-		{
-		public:
-			AkButtonState() = default;
-			AkButtonState(uint8_t newState) { m_State = newState; }
-			operator uint8_t() const { return m_State; }
-			
-			void Validate();
-			
-		private:
-			uint8_t m_State = IDLE;
-		};
-
 		glm::vec2 mouseDelta;
 		glm::vec2 mouseWheel;
 		glm::vec2 mousePosition;
-		std::unordered_map<uint32_t, AkButtonState> keyStates;
-		std::unordered_map<uint8_t, AkButtonState> mouseButtonStates;
+
+		// Down follows the events as they come, held is what was down when the frame began
+		alignas(16) AkInputMask down;
+		alignas(16) AkInputMask held;
+		alignas(16) AkInputMask pressed;
+		alignas(16) AkInputMask released;
 
 		void BeginFrame();
 	};
 
 	static inline bool m_ShouldClose = false;
 	static inline AkInputState m_InputState = {};
+
+	// A full queue drops its oldest events, indices only grow and wrap through the capacity
+	static inline std::array<AkInputEvent, kInputEventCapacity> m_InputEvents = {};
+	static inline uint64_t m_InputEventWriteIndex = 0;
+	static inline uint64_t m_InputEventReadIndex = 0;
+	static inline uint64_t m_InputWindowEnd = 0;
+	static inline std::vector<class AkWindow*> m_Windows = {};
 };
\ No newline at end of file
@@ -0,0 +1,119 @@
+#include "FileSystem.h"
+#include "Core/Log.h"
+#include "Core/JobSystem.h"
+
+#include <mutex>
+#include <deque>
+#include <thread>
+#include <fstream>
+#include <condition_variable>
+
+struct AkReadFileRequest
+{
+	std::filesystem::path path;
+	AkReadFileCallback callback = nullptr;
+};
+
+static std::thread sIOThread;
+static std::mutex sRequestsMutex;
+static std::condition_variable sRequestsCondition;
+
+static bool sShouldExit = false;
+static std::deque<AkReadFileRequest> sPendingRequests;
+
+static AkFileData ReadWholeFile(const std::filesystem::path& path)
+{
+	std::error_code errorCode;
+	const uintmax_t fileSize = std::filesystem::file_size(path, errorCode);
+	if (errorCode)
+	{
+		AkLogError("Failed to read file {}: {}", path.string(), errorCode.message());
+		return std::nullopt;
+	}
+
+	std::ifstream file(path, std::ios::binary);
+	if (!file)
+	{
+		AkLogError("Failed to open file {}", path.string());
+		return std::nullopt;
+	}
+
+	std::vector<uint8_t> data(static_cast<size_t>(fileSize));
+	if (!file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size())))
+	{
+		AkLogError("Failed to read file {}", path.string());
+		return std::nullopt;
+	}
+
+	return data;
+}
+
+void AkReadFileAwaiter::await_suspend(std::coroutine_handle<> handle)
+{
+	AkFileSystem::ReadFile(path, [this, handle](AkFileData&& fileData)
+	{
+		data = std::move(fileData);
+		AkJobSystem::Schedule([handle]() { handle.resume(); });
+	});
+}
+
+bool AkFileSystem::Initialize()
+{
+	sShouldExit = false;
+
+	try
+	{
+		sIOThread = std::thread(&AkFileSystem::IOThread);
+	}
+	catch (const std::exception& exception)
+	{
+		AkLogError("Failed to start I/O thread: {}", exception.what());
+		return false;
+	}
+
+	return true;
+}
+
+void AkFileSystem::Deinitialize()
+{
+	{
+		std::scoped_lock lock(sRequestsMutex);
+		sShouldExit = true;
+	}
+
+	sRequestsCondition.notify_all();
+	if (sIOThread.joinable())
+		sIOThread.join();
+}
+
+void AkFileSystem::ReadFile(const std::filesystem::path& path, AkReadFileCallback&& callback)
+{
+	{
+		std::scoped_lock lock(sRequestsMutex);
+		sPendingRequests.push_back({ .path = path, .callback = std::move(callback) });
+	}
+
+	sRequestsCondition.notify_one();
+}
+
+void AkFileSystem::IOThread()
+{
+	while (true)
+	{
+		AkReadFileRequest request = {};
+
+		{
+			std::unique_lock lock(sRequestsMutex);
+			sRequestsCondition.wait(lock, []() { return sShouldExit || !sPendingRequests.empty(); });
+
+			// Requests still queued are served, so no awaiting task is left suspended on exit
+			if (sPendingRequests.empty())
+				return;
+
+			request = std::move(sPendingRequests.front());
+			sPendingRequests.pop_front();
+		}
+
+		request.callback(ReadWholeFile(request.path));
+	}
+}
\ No newline at end of file
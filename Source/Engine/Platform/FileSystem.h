@@ -0,0 +1,37 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <optional>
+#include <coroutine>
+#include <filesystem>
+#include <functional>
+
+using AkFileData = std::optional<std::vector<uint8_t>>;
+using AkReadFileCallback = std::function<void(AkFileData&& data)>;
+
+struct AkReadFileAwaiter
+{
+	std::filesystem::path path;
+	AkFileData data = std::nullopt;
+
+	bool await_ready() const { return false; }
+	void await_suspend(std::coroutine_handle<> handle);
+	AkFileData await_resume() { return std::move(data); }
+};
+
+// Reads files on a dedicated I/O thread so neither workers nor the main thread block on the disk
+class AkFileSystem
+{
+public:
+	static bool Initialize();
+	static void Deinitialize();
+
+	// The callback runs on the I/O thread, an empty result means the file could not be read
+	static void ReadFile(const std::filesystem::path& path, AkReadFileCallback&& callback);
+
+	// Suspends the awaiting task until the file was read, it resumes on the job system
+	static AkReadFileAwaiter ReadFileAsync(const std::filesystem::path& path) { return { .path = path }; }
+
+private:
+	static void IOThread();
+};
\ No newline at end of file
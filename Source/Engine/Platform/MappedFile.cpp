@@ -0,0 +1,114 @@
+#include "MappedFile.h"
+#include "Core/Log.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#if defined(_WIN32)
+AkMappedFile::AkMappedFile(const std::filesystem::path& path)
+{
+	const HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		AkLogError("Failed to open file {}", path.string());
+		throw std::runtime_error("Failed to create AkMappedFile");
+	}
+
+	LARGE_INTEGER fileSize = {};
+	if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+	{
+		CloseHandle(file);
+		AkLogError("File {} is empty or its size could not be read", path.string());
+		throw std::runtime_error("Failed to create AkMappedFile");
+	}
+
+	const HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	const void* data = mapping != nullptr ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+	if (data == nullptr)
+	{
+		if (mapping != nullptr)
+			CloseHandle(mapping);
+
+		CloseHandle(file);
+		AkLogError("Failed to map file {}", path.string());
+		throw std::runtime_error("Failed to create AkMappedFile");
+	}
+
+	m_Data = static_cast<const uint8_t*>(data);
+	m_Size = static_cast<size_t>(fileSize.QuadPart);
+	m_FileHandle = file;
+	m_MappingHandle = mapping;
+}
+
+AkMappedFile::~AkMappedFile()
+{
+	UnmapViewOfFile(m_Data);
+	CloseHandle(m_MappingHandle);
+	CloseHandle(m_FileHandle);
+}
+
+void AkMappedFile::Prefetch(const size_t offset, const size_t size) const
+{
+	if (offset >= m_Size)
+		return;
+
+	WIN32_MEMORY_RANGE_ENTRY range = { .VirtualAddress = const_cast<uint8_t*>(m_Data + offset), .NumberOfBytes = std::min(size, m_Size - offset) };
+	PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+}
+#else
+AkMappedFile::AkMappedFile(const std::filesystem::path& path)
+{
+	const int file = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (file < 0)
+	{
+		AkLogError("Failed to open file {}", path.string());
+		throw std::runtime_error("Failed to create AkMappedFile");
+	}
+
+	struct stat fileStatus = {};
+	if (fstat(file, &fileStatus) != 0 || fileStatus.st_size == 0)
+	{
+		close(file);
+		AkLogError("File {} is empty or its size could not be read", path.string());
+		throw std::runtime_error("Failed to create AkMappedFile");
+	}
+
+	// The mapping keeps its own reference to the file, so the descriptor is not needed past this point
+	void* data = mmap(nullptr, static_cast<size_t>(fileStatus.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+	close(file);
+
+	if (data == MAP_FAILED)
+	{
+		AkLogError("Failed to map file {}", path.string());
+		throw std::runtime_error("Failed to create AkMappedFile");
+	}
+
+	m_Data = static_cast<const uint8_t*>(data);
+	m_Size = static_cast<size_t>(fileStatus.st_size);
+}
+
+AkMappedFile::~AkMappedFile()
+{
+	munmap(const_cast<uint8_t*>(m_Data), m_Size);
+}
+
+void AkMappedFile::Prefetch(const size_t offset, const size_t size) const
+{
+	if (offset >= m_Size)
+		return;
+
+	// Advice has to start on a page boundary
+	const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+	const size_t pageOffset = offset - offset % pageSize;
+	madvise(const_cast<uint8_t*>(m_Data + pageOffset), std::min(size, m_Size - offset) + (offset - pageOffset), MADV_WILLNEED);
+}
+#endif
\ No newline at end of file
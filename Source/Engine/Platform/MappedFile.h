@@ -0,0 +1,29 @@
+#pragma once
+#include <span>
+#include <cstdint>
+#include <filesystem>
+
+// Maps a whole file read only, its pages are read from disk on first access instead of being copied into a buffer up front
+class AkMappedFile
+{
+public:
+	AkMappedFile(const std::filesystem::path& path);
+	~AkMappedFile();
+
+	AkMappedFile(const AkMappedFile&) = delete;
+	AkMappedFile& operator=(const AkMappedFile&) = delete;
+
+	std::span<const uint8_t> GetBytes() const { return { m_Data, m_Size }; }
+
+	// Asks the OS to start reading a region before it is touched, such as a payload about to be copied
+	void Prefetch(const size_t offset, const size_t size) const;
+
+private:
+	const uint8_t* m_Data = nullptr;
+	size_t m_Size = 0;
+
+#if defined(_WIN32)
+	void* m_FileHandle = nullptr;
+	void* m_MappingHandle = nullptr;
+#endif
+};
\ No newline at end of file
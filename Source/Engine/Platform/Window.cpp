@@ -1,5 +1,6 @@
 #include "Window.h"
 #include "Core/Log.h"
+#include "Platform/Events.h"
 
 #include <SDL3/SDL.h>
 
@@ -28,10 +29,16 @@ AkWindow::AkWindow(const AkWindowDescriptor& descriptor)
 		AkLogError("Failed to create SDL window: {}", SDL_GetError());
 		throw std::runtime_error("AkWindow could be created!");
 	}
+
+	m_WindowId = SDL_GetWindowID(m_WindowHandle);
+	RefreshState();
+	AkEvents::RegisterWindow(this);
 }
 
 AkWindow::~AkWindow()
 {
+	AkEvents::UnregisterWindow(this);
+
 	if (m_WindowHandle)
 		SDL_DestroyWindow(m_WindowHandle);
 }
@@ -49,13 +56,10 @@ void AkWindow::SetSize(const glm::uvec2& size)
 		AkLogError("Failed to set window size: {}", SDL_GetError());
 }
 
-glm::uvec2 AkWindow::GetSize()
+glm::uvec2 AkWindow::GetSize() const
 {
-	int width = 1, height = 1;
-	if (!SDL_GetWindowSizeInPixels(m_WindowHandle, &width, &height))
-		AkLogError("Failed to get window size: {}", SDL_GetError());
-
-	return { width, height };
+	const uint64_t packedPixelSize = m_PackedPixelSize.load(std::memory_order_acquire);
+	return { static_cast<uint32_t>(packedPixelSize), static_cast<uint32_t>(packedPixelSize >> 32) };
 }
 
 void AkWindow::SetPosition(const glm::uvec2& position)
@@ -149,7 +153,7 @@ void AkWindow::Maximize()
 
 bool AkWindow::IsMaximized() const
 {
-	return SDL_GetWindowFlags(m_WindowHandle) & SDL_WINDOW_MAXIMIZED;
+	return m_Flags.load(std::memory_order_relaxed) & SDL_WINDOW_MAXIMIZED;
 }
 
 void AkWindow::Minimize()
@@ -160,7 +164,7 @@ void AkWindow::Minimize()
 
 bool AkWindow::IsMinimized() const
 {
-	return SDL_GetWindowFlags(m_WindowHandle) & SDL_WINDOW_MINIMIZED;
+	return m_Flags.load(std::memory_order_relaxed) & SDL_WINDOW_MINIMIZED;
 }
 
 void AkWindow::Focus()
@@ -176,12 +180,12 @@ bool AkWindow::HasFocus() const
 
 bool AkWindow::HasInputFocus() const
 {
-	return SDL_GetWindowFlags(m_WindowHandle) & SDL_WINDOW_INPUT_FOCUS;
+	return m_Flags.load(std::memory_order_relaxed) & SDL_WINDOW_INPUT_FOCUS;
 }
 
 bool AkWindow::HasMouseFocus() const
 {
-	return SDL_GetWindowFlags(m_WindowHandle) & SDL_WINDOW_MOUSE_FOCUS;
+	return m_Flags.load(std::memory_order_relaxed) & SDL_WINDOW_MOUSE_FOCUS;
 }
 
 SDL_Window* AkWindow::GetHandle() const
@@ -189,6 +193,42 @@ SDL_Window* AkWindow::GetHandle() const
 	return m_WindowHandle;
 }
 
+void AkWindow::ProcessEvent(const SDL_Event& event)
+{
+	switch (event.type)
+	{
+		case SDL_EventType::SDL_EVENT_WINDOW_PIXEL_SIZE_CHANGED:
+		case SDL_EventType::SDL_EVENT_WINDOW_MINIMIZED:
+		case SDL_EventType::SDL_EVENT_WINDOW_RESTORED:
+		case SDL_EventType::SDL_EVENT_WINDOW_MAXIMIZED:
+		case SDL_EventType::SDL_EVENT_WINDOW_SHOWN:
+		case SDL_EventType::SDL_EVENT_WINDOW_HIDDEN:
+		case SDL_EventType::SDL_EVENT_WINDOW_FOCUS_GAINED:
+		case SDL_EventType::SDL_EVENT_WINDOW_FOCUS_LOST:
+		case SDL_EventType::SDL_EVENT_WINDOW_MOUSE_ENTER:
+		case SDL_EventType::SDL_EVENT_WINDOW_MOUSE_LEAVE:
+		case SDL_EventType::SDL_EVENT_WINDOW_ENTER_FULLSCREEN:
+		case SDL_EventType::SDL_EVENT_WINDOW_LEAVE_FULLSCREEN:
+		{
+			RefreshState();
+			break;
+		}
+	}
+}
+
+void AkWindow::RefreshState()
+{
+	int width = 0, height = 0;
+	if (!SDL_GetWindowSizeInPixels(m_WindowHandle, &width, &height))
+		AkLogError("Failed to get window size: {}", SDL_GetError());
+
+	const uint64_t packedPixelSize = static_cast<uint64_t>(width) | (static_cast<uint64_t>(height) << 32);
+	if (m_PackedPixelSize.exchange(packedPixelSize, std::memory_order_acq_rel) != packedPixelSize)
+		m_ResizeCount.fetch_add(1, std::memory_order_release);
+
+	m_Flags.store(SDL_GetWindowFlags(m_WindowHandle), std::memory_order_relaxed);
+}
+
 std::vector<AkDisplayMode> AkWindow::GetAvailableDisplayModes()
 {
 	int displayModesCount = 0;
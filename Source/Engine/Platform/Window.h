@@ -1,4 +1,5 @@
 #pragma once
+#include <atomic>
 #include <vector>
 #include <string_view>
 #include <glm/vec2.hpp>
@@ -40,8 +41,12 @@ public:
 
 	void SetTitle(std::string_view title);
 	
+	// Window state is cached from the events pumped by AkEvents, so the getters below are safe to call from any thread every frame
 	void SetSize(const glm::uvec2& size);
-	glm::uvec2 GetSize();
+	glm::uvec2 GetSize() const;
+
+	// Incremented every time the size in pixels changed, cheaper to compare than the size itself
+	uint32_t GetResizeCount() const { return m_ResizeCount.load(std::memory_order_acquire); }
 
 	void SetPosition(const glm::uvec2& position);
 	glm::uvec2 GetPosition();
@@ -69,5 +74,15 @@ public:
 	static std::vector<AkDisplayMode> GetAvailableDisplayModes();
 
 private:
+	friend class AkEvents;
+
 	struct SDL_Window* m_WindowHandle = nullptr;
+	uint32_t m_WindowId = 0;
+
+	std::atomic<uint64_t> m_Flags = 0;
+	std::atomic<uint64_t> m_PackedPixelSize = 0;
+	std::atomic<uint32_t> m_ResizeCount = 0;
+
+	void ProcessEvent(const union SDL_Event& event);
+	void RefreshState();
 };
\ No newline at end of file
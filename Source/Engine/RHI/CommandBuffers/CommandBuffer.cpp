@@ -1,196 +1,230 @@
 #include "CommandBuffer.h"
 #include "Core/Assert.h"
-#include "RHI/Device.h"
+#include "RHI/VulkanPipelineStates.h"
 #include "RHI/Textures/Texture.h"
 
+#include <array>
+#include <vector>
+#include <algorithm>
 #include <vulkan/vulkan.hpp>
 
-vk::ImageAspectFlags GetAspectMask(const AkPixelFormat format)
-{
-	if (IsDepthPixelFormat(format))
-		return vk::ImageAspectFlagBits::eDepth;
-	else
-		return vk::ImageAspectFlagBits::eColor;
-}
-
-constexpr vk::ImageLayout GetImageLayout(const AkResourceState resourceState)
+constexpr AkShaderStageFlags GetTrackedShaderStages(const AkResourceState resourceState, const AkShaderStageFlags shaderStages)
 {
 	switch (resourceState)
 	{
-		case AkResourceState::UNDEFINED:
-			return vk::ImageLayout::eUndefined;
-
-		case AkResourceState::RENDER_TARGET:
-			return vk::ImageLayout::eColorAttachmentOptimal;
-
-		case AkResourceState::UNORDERED_ACCESS:
-			return vk::ImageLayout::eGeneral;
-
-		case AkResourceState::DEPTH_READ:
-			return vk::ImageLayout::eDepthStencilReadOnlyOptimal;
-
-		case AkResourceState::DEPTH_WRITE:
-			return vk::ImageLayout::eDepthStencilAttachmentOptimal;
-
-		case AkResourceState::SHADER_RESOURCE:
-			return vk::ImageLayout::eShaderReadOnlyOptimal;
-
-		case AkResourceState::COPY_DESTINATION:
-			return vk::ImageLayout::eTransferDstOptimal;
-
-		case AkResourceState::COPY_SOURCE:
-			return vk::ImageLayout::eTransferSrcOptimal;
-
-		case AkResourceState::PRESENT:
-			return vk::ImageLayout::ePresentSrcKHR;
-
-		case AkResourceState::INDEX_BUFFER:
-		case AkResourceState::VERTEX_BUFFER:
-		case AkResourceState::CONSTANT_BUFFER:
-		case AkResourceState::INDIRECT_ARGUMENT:
-			AkLogCritical("Resource state is not a texture compatible state");
-			return vk::ImageLayout::eUndefined;
-
-		default:
-			AkLogCritical("Resource state not registered in this function");
-			return vk::ImageLayout::eUndefined;
-	}
-}
-
-constexpr vk::AccessFlags GetAccessMask(const AkResourceState resourceState)
-{
-	switch (resourceState)
-	{
-		case AkResourceState::UNDEFINED:			return vk::AccessFlagBits::eNone;
-		case AkResourceState::INDEX_BUFFER:			return vk::AccessFlagBits::eIndexRead;
-		case AkResourceState::VERTEX_BUFFER: 		return vk::AccessFlagBits::eVertexAttributeRead;
-		case AkResourceState::CONSTANT_BUFFER:		return vk::AccessFlagBits::eUniformRead;
-		case AkResourceState::RENDER_TARGET:		return vk::AccessFlagBits::eColorAttachmentRead | vk::AccessFlagBits::eColorAttachmentWrite;
-		case AkResourceState::UNORDERED_ACCESS:		return vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite;
-		case AkResourceState::DEPTH_READ:			return vk::AccessFlagBits::eDepthStencilAttachmentRead;
-		case AkResourceState::DEPTH_WRITE:			return vk::AccessFlagBits::eDepthStencilAttachmentRead | vk::AccessFlagBits::eDepthStencilAttachmentWrite;
-		case AkResourceState::SHADER_RESOURCE:		return vk::AccessFlagBits::eShaderRead;
-		case AkResourceState::INDIRECT_ARGUMENT:	return vk::AccessFlagBits::eIndirectCommandRead;
-		case AkResourceState::COPY_DESTINATION:		return vk::AccessFlagBits::eTransferWrite;
-		case AkResourceState::COPY_SOURCE:			return vk::AccessFlagBits::eTransferRead;
-		case AkResourceState::PRESENT:				return vk::AccessFlagBits::eMemoryRead;
-
-		default:
-			AkLogCritical("Resource state not registered in this function");
-			return vk::AccessFlagBits::eNone;
-	}
-}
-
-constexpr vk::PipelineStageFlags GetPipelineStageFlags(const AkResourceState resourceState)
-{
-	switch (resourceState)
-	{
-		case AkResourceState::UNDEFINED:
-			return vk::PipelineStageFlagBits::eTopOfPipe;
-
-		case AkResourceState::INDEX_BUFFER:
-		case AkResourceState::VERTEX_BUFFER:
-			return vk::PipelineStageFlagBits::eVertexInput;
-
 		case AkResourceState::SHADER_RESOURCE:
 		case AkResourceState::CONSTANT_BUFFER:
 		case AkResourceState::UNORDERED_ACCESS:
-			return	vk::PipelineStageFlagBits::eVertexShader |
-				vk::PipelineStageFlagBits::eFragmentShader |
-				vk::PipelineStageFlagBits::eGeometryShader |
-				vk::PipelineStageFlagBits::eComputeShader |
-				vk::PipelineStageFlagBits::eTessellationControlShader |
-				vk::PipelineStageFlagBits::eTessellationEvaluationShader;
-
-		case AkResourceState::RENDER_TARGET:
-			return vk::PipelineStageFlagBits::eColorAttachmentOutput;
-
-		case AkResourceState::DEPTH_READ:
-		case AkResourceState::DEPTH_WRITE:
-			return	vk::PipelineStageFlagBits::eEarlyFragmentTests |
-				vk::PipelineStageFlagBits::eLateFragmentTests;
-
-		case AkResourceState::INDIRECT_ARGUMENT:
-			return vk::PipelineStageFlagBits::eDrawIndirect;
-
-		case AkResourceState::COPY_SOURCE:
-		case AkResourceState::COPY_DESTINATION:
-			return vk::PipelineStageFlagBits::eTransfer;
-
-		case AkResourceState::PRESENT:
-			return vk::PipelineStageFlagBits::eBottomOfPipe;
+			return shaderStages;
 
 		default:
-			AkLogCritical("Resource state not registered in this function");
-			return vk::PipelineStageFlagBits::eNone;
+			return AkShaderStage_NONE;
 	}
 }
 
 struct AkCommandBufferStorage
 {
-	vk::CommandPool commandPool = {};
 	vk::CommandBuffer commandBuffer = {};
+	AkCommandBufferLevel level = AkCommandBufferLevel::PRIMARY;
+
+	std::vector<vk::MemoryBarrier2> memoryBarriers;
+	std::vector<vk::BufferMemoryBarrier2> bufferMemoryBarriers;
+	std::vector<vk::ImageMemoryBarrier2> imageMemoryBarriers;
 };
 
-AkCommandBuffer::AkCommandBuffer(const vk::CommandPool& commandPool, const vk::CommandBuffer& commandBuffer)
+AkCommandBuffer::AkCommandBuffer(const vk::CommandBuffer& commandBuffer, const AkCommandBufferLevel level)
 {
-	m_Storage->commandPool = commandPool;
 	m_Storage->commandBuffer = commandBuffer;
+	m_Storage->level = level;
 }
 
 AkCommandBuffer::~AkCommandBuffer()
 {
-	const vk::Device& device = AkDevice::GetDevice();
-
-	if (m_Storage->commandPool && m_Storage->commandBuffer)
-		device.freeCommandBuffers(m_Storage->commandPool, m_Storage->commandBuffer);
+	// Command buffers are freed in bulk together with the pool that owns them
 }
 
-void AkCommandBuffer::Begin()
+void AkCommandBuffer::Begin(const AkCommandBufferUsage usage)
 {
-	static const vk::CommandBufferBeginInfo kCommandBufferBeginInfo =
+	static const vk::CommandBufferInheritanceInfo kCommandBufferInheritanceInfo = {};
+
+	// Reusable recordings may be resubmitted before the GPU has finished executing their previous submission
+	const vk::CommandBufferBeginInfo commandBufferBeginInfo =
 	{
-		.flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit
+		.flags = usage == AkCommandBufferUsage::REUSABLE ? vk::CommandBufferUsageFlagBits::eSimultaneousUse : vk::CommandBufferUsageFlagBits::eOneTimeSubmit,
+		.pInheritanceInfo = m_Storage->level == AkCommandBufferLevel::SECONDARY ? &kCommandBufferInheritanceInfo : nullptr
 	};
 
-	m_Storage->commandBuffer.begin(kCommandBufferBeginInfo);
+	m_Storage->memoryBarriers.clear();
+	m_Storage->bufferMemoryBarriers.clear();
+	m_Storage->imageMemoryBarriers.clear();
+	m_Storage->commandBuffer.begin(commandBufferBeginInfo);
 }
 
 void AkCommandBuffer::End()
 {
+	FlushBarriers();
 	m_Storage->commandBuffer.end();
 }
 
 void AkCommandBuffer::TransitionTexture(AkTexture* texture, const AkResourceState sourceState, const AkResourceState destinationState)
 {
-	const AkTextureDescriptor& descriptor = texture->GetDescriptor();
-	const vk::ImageSubresourceRange subResourceRange =
+	texture->SetState({ sourceState, GetTrackedShaderStages(sourceState, AkShaderStage_ALL) });
+	RequireState(texture, destinationState);
+}
+
+void AkCommandBuffer::RequireState(AkTexture* texture, const AkResourceState state, const AkShaderStageFlags shaderStages)
+{
+	RequireState(texture, state, AkTextureSubresourceRange{}, shaderStages);
+}
+
+void AkCommandBuffer::RequireState(AkTexture* texture, const AkResourceState state, const AkTextureSubresourceRange& range, const AkShaderStageFlags shaderStages)
+{
+	// Barriers inside a single vkCmdPipelineBarrier2 are unordered, so a second transition of the same image needs its own batch
+	const vk::Image& image = texture->GetImage();
+	if (std::any_of(m_Storage->imageMemoryBarriers.begin(), m_Storage->imageMemoryBarriers.end(), [&image](const vk::ImageMemoryBarrier2& barrier) { return barrier.image == image; }))
+		FlushBarriers();
+
+	const AkTextureSubresourceRange resolvedRange = texture->ResolveRange(range);
+	const vk::ImageAspectFlags aspectMask = GetAspectMask(texture->GetDescriptor().format);
+	const AkSubresourceState requiredState = { state, GetTrackedShaderStages(state, shaderStages) };
+
+	auto Transition = [&](const AkSubresourceState& currentState, const AkTextureSubresourceRange& subresourceRange)
 	{
-		.aspectMask = GetAspectMask(descriptor.format),
-		.levelCount = descriptor.mips,
-		.layerCount = descriptor.slices,
+		vk::AccessFlags2 sourceAccessMask = GetAccessMask(currentState.state);
+		AkSubresourceState destinationState = requiredState;
+		AkSubresourceState trackedState = requiredState;
+
+		// Staying in the same state is free for the shader stages already accessing the subresources.
+		// Unordered access is the exception as writes still need to be made visible to the next dispatch or draw.
+		if (currentState.state == requiredState.state && requiredState.state != AkResourceState::UNORDERED_ACCESS)
+		{
+			const AkShaderStageFlags addedStages = static_cast<AkShaderStageFlags>(requiredState.shaderStages & ~currentState.shaderStages);
+			if (addedStages == AkShaderStage_NONE)
+				return;
+
+			// The barrier into this state only waited for the last write on behalf of the stages reading it then,
+			// chaining from those stages extends that dependency to the added ones without a layout change
+			sourceAccessMask = vk::AccessFlagBits2::eNone;
+			destinationState.shaderStages = addedStages;
+			trackedState.shaderStages = static_cast<AkShaderStageFlags>(currentState.shaderStages | addedStages);
+		}
+
+		m_Storage->imageMemoryBarriers.push_back(
+		{
+			.srcStageMask = GetPipelineStageFlags(currentState),
+			.srcAccessMask = sourceAccessMask,
+			.dstStageMask = GetPipelineStageFlags(destinationState),
+			.dstAccessMask = GetAccessMask(destinationState.state),
+			.oldLayout = GetImageLayout(currentState.state),
+			.newLayout = GetImageLayout(requiredState.state),
+			.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+			.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+			.image = image,
+			.subresourceRange =
+			{
+				.aspectMask = aspectMask,
+				.baseMipLevel = subresourceRange.baseMip,
+				.levelCount = subresourceRange.mipCount,
+				.baseArrayLayer = subresourceRange.baseSlice,
+				.layerCount = subresourceRange.sliceCount
+			}
+		});
+
+		texture->SetState(trackedState, subresourceRange);
 	};
 
-	const vk::ImageMemoryBarrier imageMemoryBarrier =
+	if (texture->HasUniformState())
+	{
+		Transition(texture->GetState(resolvedRange.baseMip, resolvedRange.baseSlice), resolvedRange);
+		return;
+	}
+
+	// Emit one barrier per run of slices that share the same state within each mip
+	const uint32_t endSlice = resolvedRange.baseSlice + resolvedRange.sliceCount;
+	for (uint32_t mip = resolvedRange.baseMip; mip < resolvedRange.baseMip + resolvedRange.mipCount; ++mip)
 	{
-		.srcAccessMask = GetAccessMask(sourceState),
-		.dstAccessMask = GetAccessMask(destinationState),
-		.oldLayout = GetImageLayout(sourceState),
-		.newLayout = GetImageLayout(destinationState),
+		uint32_t slice = resolvedRange.baseSlice;
+		while (slice < endSlice)
+		{
+			const AkSubresourceState currentState = texture->GetState(mip, slice);
+
+			uint32_t runEnd = slice + 1;
+			while (runEnd < endSlice && texture->GetState(mip, runEnd) == currentState)
+				++runEnd;
+
+			Transition(currentState, { .baseMip = mip, .mipCount = 1, .baseSlice = slice, .sliceCount = runEnd - slice });
+			slice = runEnd;
+		}
+	}
+}
+
+void AkCommandBuffer::TransitionBuffer(const vk::Buffer& buffer, const AkSubresourceState& sourceState, const AkSubresourceState& destinationState)
+{
+	if (std::any_of(m_Storage->bufferMemoryBarriers.begin(), m_Storage->bufferMemoryBarriers.end(), [&buffer](const vk::BufferMemoryBarrier2& barrier) { return barrier.buffer == buffer; }))
+		FlushBarriers();
+
+	m_Storage->bufferMemoryBarriers.push_back(
+	{
+		.srcStageMask = GetPipelineStageFlags(sourceState),
+		.srcAccessMask = GetAccessMask(sourceState.state),
+		.dstStageMask = GetPipelineStageFlags(destinationState),
+		.dstAccessMask = GetAccessMask(destinationState.state),
 		.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
 		.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-		.image = texture->GetImage(),
-		.subresourceRange = subResourceRange
+		.buffer = buffer,
+		.offset = 0,
+		.size = VK_WHOLE_SIZE
+	});
+}
+
+void AkCommandBuffer::GlobalBarrier(const AkSubresourceState& sourceState, const AkSubresourceState& destinationState)
+{
+	m_Storage->memoryBarriers.push_back(
+	{
+		.srcStageMask = GetPipelineStageFlags(sourceState),
+		.srcAccessMask = GetAccessMask(sourceState.state),
+		.dstStageMask = GetPipelineStageFlags(destinationState),
+		.dstAccessMask = GetAccessMask(destinationState.state)
+	});
+}
+
+void AkCommandBuffer::HostReadBarrier()
+{
+	m_Storage->memoryBarriers.push_back(
+	{
+		.srcStageMask = vk::PipelineStageFlagBits2::eTransfer,
+		.srcAccessMask = vk::AccessFlagBits2::eTransferWrite,
+		.dstStageMask = vk::PipelineStageFlagBits2::eHost,
+		.dstAccessMask = vk::AccessFlagBits2::eHostRead
+	});
+}
+
+void AkCommandBuffer::FlushBarriers()
+{
+	if (m_Storage->memoryBarriers.empty() && m_Storage->bufferMemoryBarriers.empty() && m_Storage->imageMemoryBarriers.empty())
+		return;
+
+	const vk::DependencyInfo dependencyInfo =
+	{
+		.memoryBarrierCount = static_cast<uint32_t>(m_Storage->memoryBarriers.size()),
+		.pMemoryBarriers = m_Storage->memoryBarriers.data(),
+		.bufferMemoryBarrierCount = static_cast<uint32_t>(m_Storage->bufferMemoryBarriers.size()),
+		.pBufferMemoryBarriers = m_Storage->bufferMemoryBarriers.data(),
+		.imageMemoryBarrierCount = static_cast<uint32_t>(m_Storage->imageMemoryBarriers.size()),
+		.pImageMemoryBarriers = m_Storage->imageMemoryBarriers.data()
 	};
 
-	const vk::PipelineStageFlags sourceStage = GetPipelineStageFlags(sourceState);
-	const vk::PipelineStageFlags destinationStage = GetPipelineStageFlags(destinationState);
-	m_Storage->commandBuffer.pipelineBarrier(sourceStage, destinationStage, {}, 0, nullptr, 0, nullptr, 1, &imageMemoryBarrier);
+	m_Storage->commandBuffer.pipelineBarrier2KHR(dependencyInfo);
+
+	m_Storage->memoryBarriers.clear();
+	m_Storage->bufferMemoryBarriers.clear();
+	m_Storage->imageMemoryBarriers.clear();
 }
 
 void AkCommandBuffer::ClearColor(AkTexture* texture, const AkResourceState sourceState, const glm::vec4& color)
 {
 	AkSoftAssert(sourceState == AkResourceState::COPY_DESTINATION || sourceState == AkResourceState::UNORDERED_ACCESS, "Texture is in an invalid resource state\nOnly 'COPY_DESTINATION' and 'UNORDERED_ACCESS' are supported.");
+	FlushBarriers();
 
 	const AkTextureDescriptor& descriptor = texture->GetDescriptor();
 	const vk::ImageSubresourceRange subResourceRange =
@@ -205,7 +239,154 @@ void AkCommandBuffer::ClearColor(AkTexture* texture, const AkResourceState sourc
 	m_Storage->commandBuffer.clearColorImage(texture->GetImage(), currentLayout, clearColor, subResourceRange);
 }
 
+void AkCommandBuffer::BlitTexture(AkTexture* source, const glm::uvec2& sourceSize, AkTexture* destination, const glm::uvec2& destinationSize)
+{
+	const AkTextureSubresourceRange firstSubresource = { .mipCount = 1, .sliceCount = 1 };
+	RequireState(source, AkResourceState::COPY_SOURCE, firstSubresource);
+	RequireState(destination, AkResourceState::COPY_DESTINATION, firstSubresource);
+	FlushBarriers();
+
+	const vk::ImageBlit blitRegion =
+	{
+		.srcSubresource = { .aspectMask = GetAspectMask(source->GetDescriptor().format), .layerCount = 1 },
+		.srcOffsets = std::array<vk::Offset3D, 2>{ vk::Offset3D{ 0, 0, 0 }, vk::Offset3D{ static_cast<int32_t>(sourceSize.x), static_cast<int32_t>(sourceSize.y), 1 } },
+		.dstSubresource = { .aspectMask = GetAspectMask(destination->GetDescriptor().format), .layerCount = 1 },
+		.dstOffsets = std::array<vk::Offset3D, 2>{ vk::Offset3D{ 0, 0, 0 }, vk::Offset3D{ static_cast<int32_t>(destinationSize.x), static_cast<int32_t>(destinationSize.y), 1 } }
+	};
+
+	m_Storage->commandBuffer.blitImage(source->GetImage(), GetImageLayout(AkResourceState::COPY_SOURCE), destination->GetImage(), GetImageLayout(AkResourceState::COPY_DESTINATION), blitRegion, vk::Filter::eLinear);
+}
+
+void AkCommandBuffer::GenerateMips(AkTexture* texture, const AkMipReduction reduction)
+{
+	AkMipGenerator::Generate(this, texture, reduction);
+}
+
+void AkCommandBuffer::CopyTextureToBuffer(AkTexture* texture, const vk::Buffer& buffer, const uint64_t bufferOffset, const AkTextureSubresourceRange& range)
+{
+	RequireState(texture, AkResourceState::COPY_SOURCE, range);
+	FlushBarriers();
+
+	const AkTextureDescriptor& descriptor = texture->GetDescriptor();
+	const AkTextureSubresourceRange resolvedRange = texture->ResolveRange(range);
+
+	static thread_local std::vector<vk::BufferImageCopy> sCopyRegions;
+	sCopyRegions.clear();
+
+	uint64_t regionOffset = bufferOffset;
+	for (uint32_t mip = resolvedRange.baseMip; mip < resolvedRange.baseMip + resolvedRange.mipCount; ++mip)
+	{
+		const uint32_t width = std::max(1u, descriptor.width >> mip);
+		const uint32_t height = std::max(1u, descriptor.height >> mip);
+		const uint32_t depth = std::max(1u, descriptor.depth >> mip);
+
+		sCopyRegions.push_back(
+		{
+			.bufferOffset = regionOffset,
+			.imageSubresource =
+			{
+				.aspectMask = GetAspectMask(descriptor.format),
+				.mipLevel = mip,
+				.baseArrayLayer = resolvedRange.baseSlice,
+				.layerCount = resolvedRange.sliceCount
+			},
+			.imageExtent = { width, height, depth }
+		});
+
+		regionOffset += GetSurfaceByteSize(descriptor.format, width, height) * depth * resolvedRange.sliceCount;
+	}
+
+	m_Storage->commandBuffer.copyImageToBuffer(texture->GetImage(), GetImageLayout(AkResourceState::COPY_SOURCE), buffer, sCopyRegions);
+}
+
+void AkCommandBuffer::CopyBufferToTexture(const vk::Buffer& buffer, AkTexture* texture, const uint64_t bufferOffset, const AkTextureSubresourceRange& range)
+{
+	RequireState(texture, AkResourceState::COPY_DESTINATION, range);
+	FlushBarriers();
+
+	const AkTextureDescriptor& descriptor = texture->GetDescriptor();
+	const AkTextureSubresourceRange resolvedRange = texture->ResolveRange(range);
+
+	static thread_local std::vector<vk::BufferImageCopy> sCopyRegions;
+	sCopyRegions.clear();
+
+	uint64_t regionOffset = bufferOffset;
+	for (uint32_t mip = resolvedRange.baseMip; mip < resolvedRange.baseMip + resolvedRange.mipCount; ++mip)
+	{
+		const uint32_t width = std::max(1u, descriptor.width >> mip);
+		const uint32_t height = std::max(1u, descriptor.height >> mip);
+		const uint32_t depth = std::max(1u, descriptor.depth >> mip);
+
+		sCopyRegions.push_back(
+		{
+			.bufferOffset = regionOffset,
+			.imageSubresource =
+			{
+				.aspectMask = GetAspectMask(descriptor.format),
+				.mipLevel = mip,
+				.baseArrayLayer = resolvedRange.baseSlice,
+				.layerCount = resolvedRange.sliceCount
+			},
+			.imageExtent = { width, height, depth }
+		});
+
+		regionOffset += GetSurfaceByteSize(descriptor.format, width, height) * depth * resolvedRange.sliceCount;
+	}
+
+	m_Storage->commandBuffer.copyBufferToImage(buffer, texture->GetImage(), GetImageLayout(AkResourceState::COPY_DESTINATION), sCopyRegions);
+}
+
+void AkCommandBuffer::CopyTextureMips(AkTexture* source, const uint32_t sourceBaseMip, AkTexture* destination, const uint32_t destinationBaseMip, const uint32_t mipCount)
+{
+	RequireState(source, AkResourceState::COPY_SOURCE, { .baseMip = sourceBaseMip, .mipCount = mipCount });
+	RequireState(destination, AkResourceState::COPY_DESTINATION, { .baseMip = destinationBaseMip, .mipCount = mipCount });
+	FlushBarriers();
+
+	const AkTextureDescriptor& descriptor = destination->GetDescriptor();
+	const vk::ImageAspectFlags aspectMask = GetAspectMask(descriptor.format);
+	const uint32_t sliceCount = std::min(source->GetDescriptor().slices, descriptor.slices);
+
+	static thread_local std::vector<vk::ImageCopy> sCopyRegions;
+	sCopyRegions.clear();
+
+	for (uint32_t i = 0; i < mipCount; ++i)
+	{
+		const uint32_t mip = destinationBaseMip + i;
+		sCopyRegions.push_back(
+		{
+			.srcSubresource = { .aspectMask = aspectMask, .mipLevel = sourceBaseMip + i, .layerCount = sliceCount },
+			.dstSubresource = { .aspectMask = aspectMask, .mipLevel = mip, .layerCount = sliceCount },
+			.extent = { std::max(1u, descriptor.width >> mip), std::max(1u, descriptor.height >> mip), std::max(1u, descriptor.depth >> mip) }
+		});
+	}
+
+	m_Storage->commandBuffer.copyImage(source->GetImage(), GetImageLayout(AkResourceState::COPY_SOURCE), destination->GetImage(), GetImageLayout(AkResourceState::COPY_DESTINATION), sCopyRegions);
+}
+
+void AkCommandBuffer::ExecuteCommands(const std::vector<AkCommandBuffer*>& secondaryCommandBuffers)
+{
+	AkAssert(m_Storage->level == AkCommandBufferLevel::PRIMARY, "Secondary command buffers can only be executed from a primary command buffer");
+	FlushBarriers();
+
+	static thread_local std::vector<vk::CommandBuffer> sVulkanCommandBuffers;
+	sVulkanCommandBuffers.clear();
+
+	for (AkCommandBuffer* secondaryCommandBuffer : secondaryCommandBuffers)
+	{
+		AkAssert(secondaryCommandBuffer->GetLevel() == AkCommandBufferLevel::SECONDARY, "Only secondary command buffers can be executed from a primary command buffer");
+		sVulkanCommandBuffers.push_back(secondaryCommandBuffer->GetBuffer());
+	}
+
+	if (!sVulkanCommandBuffers.empty())
+		m_Storage->commandBuffer.executeCommands(sVulkanCommandBuffers);
+}
+
 vk::CommandBuffer& AkCommandBuffer::GetBuffer()
 {
 	return m_Storage->commandBuffer;
+}
+
+AkCommandBufferLevel AkCommandBuffer::GetLevel() const
+{
+	return m_Storage->level;
 }
\ No newline at end of file
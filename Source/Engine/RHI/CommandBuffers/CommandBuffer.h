@@ -1,31 +1,73 @@
 #pragma once
 #include "RHI/PipelineStates.h"
+#include "RHI/Textures/MipGenerator.h"
 #include "Utilities/ForwardStorage.h"
 
+#include <vector>
+#include <glm/vec2.hpp>
 #include <glm/vec4.hpp>
 
 namespace vk 
 { 
-	class CommandPool; 
+	class Buffer;
 	class CommandBuffer; 
 }
 
+enum class AkCommandBufferLevel
+{
+	PRIMARY,
+	SECONDARY
+};
+
+enum class AkCommandBufferUsage
+{
+	ONE_TIME_SUBMIT,
+	REUSABLE
+};
+
 class AkCommandBuffer
 {
 	friend class AkCommandBufferAllocator;
 
 public:
-	AkCommandBuffer(const vk::CommandPool& commandPool, const vk::CommandBuffer& commandBuffer);
+	AkCommandBuffer(const vk::CommandBuffer& commandBuffer, const AkCommandBufferLevel level);
 	~AkCommandBuffer();
 
-	void Begin();
+	void Begin(const AkCommandBufferUsage usage = AkCommandBufferUsage::ONE_TIME_SUBMIT);
 	void End();
 
+	// Barriers are batched and only recorded once a command that depends on them is recorded or FlushBarriers is called
 	void TransitionTexture(class AkTexture* texture, const AkResourceState sourceState, const AkResourceState destinationState);
+	void RequireState(class AkTexture* texture, const AkResourceState state, const struct AkTextureSubresourceRange& range, const AkShaderStageFlags shaderStages = AkShaderStage_ALL);
+	void RequireState(class AkTexture* texture, const AkResourceState state, const AkShaderStageFlags shaderStages = AkShaderStage_ALL);
+	void TransitionBuffer(const vk::Buffer& buffer, const AkSubresourceState& sourceState, const AkSubresourceState& destinationState);
+	void GlobalBarrier(const AkSubresourceState& sourceState, const AkSubresourceState& destinationState);
+	// Makes the transfer writes recorded so far readable by the host once the submission completed, for buffers it reads back
+	void HostReadBarrier();
+	void FlushBarriers();
+
 	void ClearColor(class AkTexture* texture, const AkResourceState sourceState, const glm::vec4& color);
 
+	// Scales the top left region of the first mip and slice of the source into the one of the destination with bilinear filtering
+	void BlitTexture(class AkTexture* source, const glm::uvec2& sourceSize, class AkTexture* destination, const glm::uvec2& destinationSize);
+
+	// Fills every mip after the first from the one before it, see AkMipGenerator for what decides between compute and blits
+	void GenerateMips(class AkTexture* texture, const AkMipReduction reduction = AkMipReduction::AVERAGE);
+
+	// Mips are written one after the other starting at the offset, each one holding its slices tightly packed
+	void CopyTextureToBuffer(class AkTexture* texture, const vk::Buffer& buffer, const uint64_t bufferOffset = 0, const struct AkTextureSubresourceRange& range = {});
+	void CopyBufferToTexture(const vk::Buffer& buffer, class AkTexture* texture, const uint64_t bufferOffset = 0, const struct AkTextureSubresourceRange& range = {});
+
+	// Copies every slice of a run of mips between textures whose mips match in size from the given base mips, such as two chains of the same image
+	void CopyTextureMips(class AkTexture* source, const uint32_t sourceBaseMip, class AkTexture* destination, const uint32_t destinationBaseMip, const uint32_t mipCount);
+
+	// Secondary command buffers are executed in the order they are given, regardless of the order they finished recording in.
+	// Texture states are tracked at record time, so shared textures must be transitioned in the primary before recording secondaries in parallel.
+	void ExecuteCommands(const std::vector<AkCommandBuffer*>& secondaryCommandBuffers);
+
 	vk::CommandBuffer& GetBuffer();
+	AkCommandBufferLevel GetLevel() const;
 
 private:
-	ForwardStorage<struct AkCommandBufferStorage, 16> m_Storage;
+	ForwardStorage<struct AkCommandBufferStorage, 112> m_Storage;
 };
\ No newline at end of file
@@ -1,66 +1,175 @@
 #include "CommandBufferAllocator.h"
 #include "RHI/Device.h"
+#include "RHI/Swapchain.h"
 #include "Core/Log.h"
-
+#include "Core/Assert.h"
+
+#include <array>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <algorithm>
 #include <vulkan/vulkan.hpp>
 
-static std::unordered_map<AkDeviceQueue, vk::CommandPool> sCommandPools;
+static constexpr uint32_t kDeviceQueueCount = 3;
+static constexpr uint32_t kCommandBufferLevelCount = 2;
+static constexpr uint32_t kMaxFramesInFlight = AkSwapchain::kMaxFramesInFlight;
 
-bool AkCommandBufferAllocator::Initialize()
+struct AkCommandBufferFreeList
 {
-	const vk::Device& device = AkDevice::GetDevice();
+	uint32_t nextFreeIndex = 0;
+	std::vector<std::unique_ptr<AkCommandBuffer>> commandBuffers;
+};
 
-	try
+struct AkFrameCommandPools
+{
+	// Frame this slot was last reset for, it is reset by its owning thread on the first allocation of a newer frame
+	uint32_t frameCounter = 0;
+	std::array<vk::CommandPool, kDeviceQueueCount> commandPools = {};
+	std::array<std::array<AkCommandBufferFreeList, kCommandBufferLevelCount>, kDeviceQueueCount> freeLists;
+};
+
+struct AkThreadCommandPools
+{
+	std::array<AkFrameCommandPools, kMaxFramesInFlight> frames;
+};
+
+// Both halves are published together so a thread never pairs a frame index with the counter of another frame
+struct AkCommandBufferFrame
+{
+	uint32_t frameIndex = 0;
+	uint32_t frameCounter = 0;
+};
+
+// Hands the pools of an exiting thread back, their command buffers may still be in flight so they are only reset once their frame comes around again
+struct AkThreadCommandPoolsOwner
+{
+	~AkThreadCommandPoolsOwner();
+
+	AkThreadCommandPools* threadCommandPools = nullptr;
+};
+
+static std::mutex sThreadCommandPoolsMutex;
+static std::vector<std::unique_ptr<AkThreadCommandPools>> sThreadCommandPools;
+static std::vector<AkThreadCommandPools*> sFreeThreadCommandPools;
+static thread_local AkThreadCommandPoolsOwner sCurrentThreadCommandPools;
+
+static std::atomic<uint32_t> sFramesInFlight = 1;
+static std::atomic<AkCommandBufferFrame> sCurrentFrame = AkCommandBufferFrame{};
+
+AkThreadCommandPoolsOwner::~AkThreadCommandPoolsOwner()
+{
+	if (threadCommandPools == nullptr)
+		return;
+
+	std::scoped_lock lock(sThreadCommandPoolsMutex);
+
+	// The pools are gone already if the allocator was deinitialized before this thread exited
+	const bool isAlive = std::ranges::any_of(sThreadCommandPools, [this](const std::unique_ptr<AkThreadCommandPools>& pools)
 	{
-		vk::CommandPoolCreateInfo poolCreateInfo =
-		{
-			.flags = vk::CommandPoolCreateFlagBits::eResetCommandBuffer,
-			.queueFamilyIndex = AkDevice::GetGraphicsQueueFamilyIndex()
-		};
-		sCommandPools[AkDeviceQueue::GRAPHICS] = device.createCommandPool(poolCreateInfo);
+		return pools.get() == threadCommandPools;
+	});
 
-		poolCreateInfo.queueFamilyIndex = AkDevice::GetComputeQueueFamilyIndex();
-		sCommandPools[AkDeviceQueue::COMPUTE] = device.createCommandPool(poolCreateInfo);
+	if (isAlive)
+		sFreeThreadCommandPools.push_back(threadCommandPools);
+}
 
-		poolCreateInfo.queueFamilyIndex = AkDevice::GetTransferQueueFamilyIndex();
-		sCommandPools[AkDeviceQueue::TRANSFER] = device.createCommandPool(poolCreateInfo);
-	}
-	catch (const std::exception& exception)
+bool AkCommandBufferAllocator::Initialize()
+{
+	return GetThreadCommandPools() != nullptr;
+}
+
+void AkCommandBufferAllocator::Deinitialize()
+{
+	const vk::Device& device = AkDevice::GetDevice();
+	std::scoped_lock lock(sThreadCommandPoolsMutex);
+
+	for (std::unique_ptr<AkThreadCommandPools>& threadCommandPools : sThreadCommandPools)
 	{
-		AkLogError("Failed to create command pool: {}", exception.what());
-		return false;
+		for (AkFrameCommandPools& frameCommandPools : threadCommandPools->frames)
+		{
+			for (uint32_t i = 0; i < kDeviceQueueCount; ++i)
+			{
+				if (frameCommandPools.commandPools[i])
+					device.destroyCommandPool(frameCommandPools.commandPools[i]);
+			}
+		}
 	}
 
-	return true;
+	sThreadCommandPools.clear();
+	sFreeThreadCommandPools.clear();
+	sCurrentThreadCommandPools.threadCommandPools = nullptr;
 }
 
-void AkCommandBufferAllocator::Deinitialize()
+void AkCommandBufferAllocator::SetFramesInFlight(const uint32_t framesInFlight)
 {
-	m_CommandBuffers.clear();
+	AkAssert(framesInFlight <= kMaxFramesInFlight, "Frames in flight exceed the maximum supported by the command buffer allocator");
+	sFramesInFlight = std::max(framesInFlight, sFramesInFlight.load());
+}
 
-	const vk::Device& device = AkDevice::GetDevice();
-	device.destroyCommandPool(sCommandPools[AkDeviceQueue::GRAPHICS]);
-	device.destroyCommandPool(sCommandPools[AkDeviceQueue::COMPUTE]);
-	device.destroyCommandPool(sCommandPools[AkDeviceQueue::TRANSFER]);
+void AkCommandBufferAllocator::BeginFrame(const uint32_t frameIndex)
+{
+	AkAssert(frameIndex < sFramesInFlight, "Frame index is bigger than the number of frames in flight");
+
+	// The frame fence has signaled, every thread resets its own pools for this frame the next time it allocates from them
+	const AkCommandBufferFrame currentFrame = sCurrentFrame.load(std::memory_order_relaxed);
+	sCurrentFrame.store({ .frameIndex = frameIndex, .frameCounter = currentFrame.frameCounter + 1 }, std::memory_order_release);
 }
 
-AkCommandBuffer* AkCommandBufferAllocator::AllocateCommandBuffer(const AkDeviceQueue deviceQueue)
+AkCommandBuffer* AkCommandBufferAllocator::AllocateCommandBuffer(const AkDeviceQueue deviceQueue, const AkCommandBufferLevel level)
 {
-	const vk::CommandBufferAllocateInfo bufferAllocateInfo =
-	{
-		.commandPool = sCommandPools[deviceQueue],
-		.level = vk::CommandBufferLevel::ePrimary,
-		.commandBufferCount = 1
-	};
+	AkThreadCommandPools* threadCommandPools = GetThreadCommandPools();
+	if (threadCommandPools == nullptr)
+		return nullptr;
+
+	const AkCommandBufferFrame currentFrame = sCurrentFrame.load(std::memory_order_acquire);
+	AkFrameCommandPools& frameCommandPools = threadCommandPools->frames[currentFrame.frameIndex];
+	if (frameCommandPools.frameCounter != currentFrame.frameCounter && !BeginThreadFrame(frameCommandPools, currentFrame.frameCounter))
+		return nullptr;
+
+	const uint32_t queueIndex = static_cast<uint32_t>(deviceQueue);
+	AkCommandBufferFreeList& freeList = frameCommandPools.freeLists[queueIndex][static_cast<uint32_t>(level)];
+
+	if (freeList.nextFreeIndex < freeList.commandBuffers.size())
+		return freeList.commandBuffers[freeList.nextFreeIndex++].get();
 
 	try
 	{
 		const vk::Device& device = AkDevice::GetDevice();
+
+		// Pools are created the first time a thread records for a queue, most threads never touch the compute or transfer queues
+		if (!frameCommandPools.commandPools[queueIndex])
+		{
+			const std::array<uint32_t, kDeviceQueueCount> queueFamilyIndices =
+			{
+				AkDevice::GetGraphicsQueueFamilyIndex(),
+				AkDevice::GetComputeQueueFamilyIndex(),
+				AkDevice::GetTransferQueueFamilyIndex()
+			};
+
+			// Pools are only ever reset as a whole, which lets the driver skip per command buffer bookkeeping
+			const vk::CommandPoolCreateInfo poolCreateInfo =
+			{
+				.flags = vk::CommandPoolCreateFlagBits::eTransient,
+				.queueFamilyIndex = queueFamilyIndices[queueIndex]
+			};
+
+			frameCommandPools.commandPools[queueIndex] = device.createCommandPool(poolCreateInfo);
+		}
+
+		// Only reached while warming up, once a frame has seen its peak command buffer count it is served from the free list
+		const vk::CommandBufferAllocateInfo bufferAllocateInfo =
+		{
+			.commandPool = frameCommandPools.commandPools[queueIndex],
+			.level = level == AkCommandBufferLevel::SECONDARY ? vk::CommandBufferLevel::eSecondary : vk::CommandBufferLevel::ePrimary,
+			.commandBufferCount = 1
+		};
+
 		std::vector<vk::CommandBuffer> vkCommandBuffer = device.allocateCommandBuffers(bufferAllocateInfo);
-		std::unique_ptr<AkCommandBuffer> commandBuffer = std::make_unique<AkCommandBuffer>(sCommandPools[deviceQueue], vkCommandBuffer[0]);
-		
-		m_CommandBuffers[deviceQueue].push_back(std::move(commandBuffer));
-		return m_CommandBuffers[deviceQueue].back().get();
+
+		freeList.commandBuffers.push_back(std::make_unique<AkCommandBuffer>(vkCommandBuffer[0], level));
+		return freeList.commandBuffers[freeList.nextFreeIndex++].get();
 	}
 	catch (const std::exception& exception)
 	{
@@ -69,48 +178,58 @@ AkCommandBuffer* AkCommandBufferAllocator::AllocateCommandBuffer(const AkDeviceQ
 	}
 }
 
-std::vector<AkCommandBuffer*> AkCommandBufferAllocator::AllocateCommandBuffers(const AkDeviceQueue deviceQueue, const uint32_t count)
+AkThreadCommandPools* AkCommandBufferAllocator::GetThreadCommandPools()
 {
-	const vk::CommandBufferAllocateInfo bufferAllocateInfo =
-	{
-		.commandPool = sCommandPools[deviceQueue],
-		.level = vk::CommandBufferLevel::ePrimary,
-		.commandBufferCount = count
-	};
+	if (sCurrentThreadCommandPools.threadCommandPools)
+		return sCurrentThreadCommandPools.threadCommandPools;
 
-	try
+	std::scoped_lock lock(sThreadCommandPoolsMutex);
+
+	// Pools left behind by an exited thread are adopted before creating new ones
+	if (!sFreeThreadCommandPools.empty())
 	{
-		const vk::Device& device = AkDevice::GetDevice();
-		std::vector<vk::CommandBuffer> vkCommandBuffers = device.allocateCommandBuffers(bufferAllocateInfo);
+		sCurrentThreadCommandPools.threadCommandPools = sFreeThreadCommandPools.back();
+		sFreeThreadCommandPools.pop_back();
+		return sCurrentThreadCommandPools.threadCommandPools;
+	}
 
-		std::vector<AkCommandBuffer*> commandBuffers;
-		commandBuffers.resize(count);
+	// Freshly created pools count as reset for the current frame
+	const uint32_t frameCounter = sCurrentFrame.load(std::memory_order_acquire).frameCounter;
+	std::unique_ptr<AkThreadCommandPools> threadCommandPools = std::make_unique<AkThreadCommandPools>();
 
-		for (uint32_t i = 0; i < count; ++i)
-		{
-			std::unique_ptr<AkCommandBuffer> commandBuffer = std::make_unique<AkCommandBuffer>(sCommandPools[deviceQueue], vkCommandBuffers[i]);
-			m_CommandBuffers[deviceQueue].push_back(std::move(commandBuffer));
-			commandBuffers[i] = m_CommandBuffers[deviceQueue].back().get();
-		}
+	for (AkFrameCommandPools& frameCommandPools : threadCommandPools->frames)
+		frameCommandPools.frameCounter = frameCounter;
 
-		return commandBuffers;
-	}
-	catch (const std::exception& exception)
-	{
-		AkLogError("Failed to allocate command buffer: {}", exception.what());
-		return {};
-	}
+	sCurrentThreadCommandPools.threadCommandPools = threadCommandPools.get();
+	sThreadCommandPools.push_back(std::move(threadCommandPools));
+	return sCurrentThreadCommandPools.threadCommandPools;
 }
 
-void AkCommandBufferAllocator::ReturnCommandBuffer(AkCommandBuffer* commandBuffer)
+bool AkCommandBufferAllocator::BeginThreadFrame(AkFrameCommandPools& frameCommandPools, const uint32_t frameCounter)
 {
-	for (auto& [deviceQueue, commandBuffers] : m_CommandBuffers)
+	// Everything this thread recorded the last time this frame slot was in use has completed, so it is all reclaimed at once
+	const vk::Device& device = AkDevice::GetDevice();
+
+	for (uint32_t i = 0; i < kDeviceQueueCount; ++i)
 	{
-		auto found = std::find_if(commandBuffers.begin(), commandBuffers.end(), [commandBuffer](const std::unique_ptr<AkCommandBuffer>& other) { return other.get() == commandBuffer; });
-		if (found != commandBuffers.end())
+		if (!frameCommandPools.commandPools[i])
+			continue;
+
+		try
 		{
-			commandBuffers.erase(found);
-			return;
+			device.resetCommandPool(frameCommandPools.commandPools[i]);
 		}
+		catch (const std::exception& exception)
+		{
+			// The free lists are left untouched so command buffers that were never reset are not handed out again
+			AkLogError("Failed to reset command pool: {}", exception.what());
+			return false;
+		}
+
+		for (AkCommandBufferFreeList& freeList : frameCommandPools.freeLists[i])
+			freeList.nextFreeIndex = 0;
 	}
+
+	frameCommandPools.frameCounter = frameCounter;
+	return true;
 }
\ No newline at end of file
@@ -1,9 +1,6 @@
 #pragma once
 #include "CommandBuffer.h"
 
-#include <memory>
-#include <unordered_map>
-
 enum class AkDeviceQueue
 {
 	GRAPHICS,
@@ -17,10 +14,15 @@ public:
 	static bool Initialize();
 	static void Deinitialize();
 
-	static AkCommandBuffer* AllocateCommandBuffer(const AkDeviceQueue deviceQueue);
-	static std::vector<AkCommandBuffer*> AllocateCommandBuffers(const AkDeviceQueue deviceQueue, const uint32_t count);
-	static void ReturnCommandBuffer(AkCommandBuffer* commandBuffer);
+	static void SetFramesInFlight(const uint32_t framesInFlight);
+	static void BeginFrame(const uint32_t frameIndex);
+
+	// Every thread owns its own command pools per frame in flight, so allocation and recording never contend on a lock.
+	// A command buffer must be allocated and recorded by the same thread, secondaries are then executed from any primary.
+	// Command buffers are only valid for the frame they were allocated in, they are reclaimed in bulk by their thread on its first allocation once that frame comes around again.
+	static AkCommandBuffer* AllocateCommandBuffer(const AkDeviceQueue deviceQueue, const AkCommandBufferLevel level = AkCommandBufferLevel::PRIMARY);
 
 private:
-	static inline std::unordered_map<AkDeviceQueue, std::vector<std::unique_ptr<AkCommandBuffer>>> m_CommandBuffers;
+	static struct AkThreadCommandPools* GetThreadCommandPools();
+	static bool BeginThreadFrame(struct AkFrameCommandPools& frameCommandPools, const uint32_t frameCounter);
 };
\ No newline at end of file
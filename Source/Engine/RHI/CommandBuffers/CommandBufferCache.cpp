@@ -0,0 +1,92 @@
+#include "CommandBufferCache.h"
+#include "Core/Log.h"
+#include "RHI/Device.h"
+
+#include <vulkan/vulkan.hpp>
+
+struct AkCommandBufferCacheStorage
+{
+	vk::CommandPool commandPool = {};
+};
+
+AkCommandBufferCache::AkCommandBufferCache(const AkDeviceQueue deviceQueue)
+{
+	uint32_t queueFamilyIndex = AkDevice::GetGraphicsQueueFamilyIndex();
+	switch (deviceQueue)
+	{
+		case AkDeviceQueue::GRAPHICS:	queueFamilyIndex = AkDevice::GetGraphicsQueueFamilyIndex(); break;
+		case AkDeviceQueue::COMPUTE:	queueFamilyIndex = AkDevice::GetComputeQueueFamilyIndex(); break;
+		case AkDeviceQueue::TRANSFER:	queueFamilyIndex = AkDevice::GetTransferQueueFamilyIndex(); break;
+	}
+
+	const vk::CommandPoolCreateInfo poolCreateInfo =
+	{
+		.queueFamilyIndex = queueFamilyIndex
+	};
+
+	try
+	{
+		const vk::Device& device = AkDevice::GetDevice();
+		m_Storage->commandPool = device.createCommandPool(poolCreateInfo);
+	}
+	catch (const std::exception& exception)
+	{
+		AkLogError("Failed to create command pool: {}", exception.what());
+		throw std::runtime_error("Failed to create AkCommandBufferCache");
+	}
+}
+
+AkCommandBufferCache::~AkCommandBufferCache()
+{
+	m_RecordedCommandBuffers.clear();
+	m_CommandBuffers.clear();
+
+	const vk::Device& device = AkDevice::GetDevice();
+	device.destroyCommandPool(m_Storage->commandPool);
+}
+
+void AkCommandBufferCache::Invalidate()
+{
+	if (m_RecordedCommandBuffers.empty())
+		return;
+
+	try
+	{
+		const vk::Device& device = AkDevice::GetDevice();
+		device.resetCommandPool(m_Storage->commandPool);
+	}
+	catch (const std::exception& exception)
+	{
+		AkLogError("Failed to reset command pool: {}", exception.what());
+	}
+
+	m_NextFreeIndex = 0;
+	m_RecordedCommandBuffers.clear();
+}
+
+AkCommandBuffer* AkCommandBufferCache::AllocateCommandBuffer()
+{
+	if (m_NextFreeIndex < m_CommandBuffers.size())
+		return m_CommandBuffers[m_NextFreeIndex++].get();
+
+	const vk::CommandBufferAllocateInfo bufferAllocateInfo =
+	{
+		.commandPool = m_Storage->commandPool,
+		.level = vk::CommandBufferLevel::ePrimary,
+		.commandBufferCount = 1
+	};
+
+	try
+	{
+		const vk::Device& device = AkDevice::GetDevice();
+		std::vector<vk::CommandBuffer> vkCommandBuffer = device.allocateCommandBuffers(bufferAllocateInfo);
+
+		m_CommandBuffers.push_back(std::make_unique<AkCommandBuffer>(vkCommandBuffer[0], AkCommandBufferLevel::PRIMARY));
+		return m_CommandBuffers[m_NextFreeIndex++].get();
+	}
+	catch (const std::exception& exception)
+	{
+		AkLogError("Failed to allocate command buffer: {}", exception.what());
+		return nullptr;
+	}
+}
\ No newline at end of file
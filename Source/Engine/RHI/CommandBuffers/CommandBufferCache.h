@@ -0,0 +1,60 @@
+#pragma once
+#include "CommandBufferAllocator.h"
+#include "Utilities/ForwardStorage.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <functional>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+
+// Keeps command buffers that are recorded once and resubmitted every frame until the inputs in their key change.
+// Recordings must leave every texture they touch in the same state on every replay, as states are only tracked while recording.
+class AkCommandBufferCache
+{
+public:
+	AkCommandBufferCache(const AkDeviceQueue deviceQueue);
+	~AkCommandBufferCache();
+
+	// Keys are structs of every input the recording depends on, they are compared in full so colliding hashes never replay the wrong recording.
+	template<typename Key, typename RecordFunction>
+	AkCommandBuffer* GetOrRecord(const Key& key, RecordFunction&& recordFunction)
+	{
+		static_assert(std::has_unique_object_representations_v<Key>, "Command buffer cache keys are compared bytewise and must not contain padding");
+		const std::string_view keyBytes(reinterpret_cast<const char*>(&key), sizeof(Key));
+
+		auto found = m_RecordedCommandBuffers.find(keyBytes);
+		if (found != m_RecordedCommandBuffers.end())
+			return found->second;
+
+		AkCommandBuffer* commandBuffer = AllocateCommandBuffer();
+		if (commandBuffer == nullptr)
+			return nullptr;
+
+		commandBuffer->Begin(AkCommandBufferUsage::REUSABLE);
+		recordFunction(commandBuffer);
+		commandBuffer->End();
+
+		m_RecordedCommandBuffers.emplace(keyBytes, commandBuffer);
+		return commandBuffer;
+	}
+
+	// Drops every recording, the GPU must not be executing any of them anymore
+	void Invalidate();
+
+private:
+	struct AkRecordingKeyHash
+	{
+		using is_transparent = void;
+		size_t operator()(const std::string_view keyBytes) const { return std::hash<std::string_view>{}(keyBytes); }
+	};
+
+	uint32_t m_NextFreeIndex = 0;
+	std::vector<std::unique_ptr<AkCommandBuffer>> m_CommandBuffers;
+	std::unordered_map<std::string, AkCommandBuffer*, AkRecordingKeyHash, std::equal_to<>> m_RecordedCommandBuffers;
+	ForwardStorage<struct AkCommandBufferCacheStorage, 8> m_Storage;
+
+	AkCommandBuffer* AllocateCommandBuffer();
+};
\ No newline at end of file
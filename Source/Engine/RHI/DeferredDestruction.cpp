@@ -0,0 +1,79 @@
+#include "DeferredDestruction.h"
+
+#include <mutex>
+#include <vector>
+#include <algorithm>
+
+struct AkPendingDestruction
+{
+	uint64_t frame = 0;
+	AkDestroyFunction destroyFunction = nullptr;
+};
+
+static std::mutex sPendingDestructionsMutex;
+static std::vector<AkPendingDestruction> sPendingDestructions;
+
+bool AkDeferredDestruction::Initialize()
+{
+	m_FrameCounter = 0;
+	return true;
+}
+
+void AkDeferredDestruction::Deinitialize()
+{
+	Flush();
+}
+
+void AkDeferredDestruction::SetFramesInFlight(const uint32_t framesInFlight)
+{
+	std::scoped_lock lock(sPendingDestructionsMutex);
+	m_FramesInFlight = std::max(framesInFlight, m_FramesInFlight);
+}
+
+void AkDeferredDestruction::BeginFrame()
+{
+	std::vector<AkPendingDestruction> readyDestructions;
+
+	{
+		std::scoped_lock lock(sPendingDestructionsMutex);
+		++m_FrameCounter;
+
+		// Entries are appended in frame order, so the ready ones are always at the front
+		auto firstPending = std::find_if(sPendingDestructions.begin(), sPendingDestructions.end(), [](const AkPendingDestruction& pendingDestruction)
+		{
+			return pendingDestruction.frame + m_FramesInFlight > m_FrameCounter;
+		});
+
+		readyDestructions.assign(std::make_move_iterator(sPendingDestructions.begin()), std::make_move_iterator(firstPending));
+		sPendingDestructions.erase(sPendingDestructions.begin(), firstPending);
+	}
+
+	// Run outside of the lock, destroying an object is allowed to queue more of them
+	for (AkPendingDestruction& readyDestruction : readyDestructions)
+		readyDestruction.destroyFunction();
+}
+
+void AkDeferredDestruction::Enqueue(AkDestroyFunction&& destroyFunction)
+{
+	std::scoped_lock lock(sPendingDestructionsMutex);
+	sPendingDestructions.push_back({ m_FrameCounter, std::move(destroyFunction) });
+}
+
+void AkDeferredDestruction::Flush()
+{
+	while (true)
+	{
+		std::vector<AkPendingDestruction> readyDestructions;
+
+		{
+			std::scoped_lock lock(sPendingDestructionsMutex);
+			readyDestructions.swap(sPendingDestructions);
+		}
+
+		if (readyDestructions.empty())
+			return;
+
+		for (AkPendingDestruction& readyDestruction : readyDestructions)
+			readyDestruction.destroyFunction();
+	}
+}
\ No newline at end of file
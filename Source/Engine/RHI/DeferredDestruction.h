@@ -0,0 +1,28 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+
+using AkDestroyFunction = std::move_only_function<void()>;
+
+// Releases GPU objects once every frame that could still reference them completed on the GPU, so nothing has to wait for the device to go idle.
+// Objects queued during a frame are destroyed when that frame slot comes around again after all the frames in flight.
+class AkDeferredDestruction
+{
+public:
+	static bool Initialize();
+	static void Deinitialize();
+
+	static void SetFramesInFlight(const uint32_t framesInFlight);
+
+	// Must be called once the fence of the frame being started has signaled
+	static void BeginFrame();
+
+	static void Enqueue(AkDestroyFunction&& destroyFunction);
+
+	// Destroys everything still queued right away, the GPU must be idle
+	static void Flush();
+
+private:
+	static inline uint32_t m_FramesInFlight = 1;
+	static inline uint64_t m_FrameCounter = 0;
+};
\ No newline at end of file
@@ -1,5 +1,14 @@
 #include "Device.h"
 #include "Core/Log.h"
+#include "RHI/GpuCompletion.h"
+#include "RHI/DeferredDestruction.h"
+#include "RHI/Memory/MemoryAllocator.h"
+#include "RHI/Textures/TextureReadback.h"
+#include "RHI/Textures/MipGenerator.h"
+#include "RHI/Textures/TextureStreamer.h"
+#include "RHI/Textures/TexturePool.h"
+#include "RHI/SubmissionQueue.h"
+#include "RHI/VulkanPipelineStates.h"
 #include "RHI/CommandBuffers/CommandBufferAllocator.h"
 
 #include <SDL3/SDL.h>
@@ -70,15 +79,49 @@ bool AkDevice::Initialize()
 	if (!InitializeExtensions())
 		return false;
 
+	CacheFormatFeatures();
+
+	if (!AkMemoryAllocator::Initialize())
+		return false;
+
 	if (!AkCommandBufferAllocator::Initialize())
 		return false;
 
+	if (!AkSubmissionQueue::Initialize())
+		return false;
+
+	if (!AkGpuCompletion::Initialize())
+		return false;
+
+	if (!AkDeferredDestruction::Initialize())
+		return false;
+
+	if (!AkTextureReadback::Initialize())
+		return false;
+
+	if (!AkTextureStreamer::Initialize())
+		return false;
+
+	if (!AkMipGenerator::Initialize())
+		return false;
+
+	if (!AkTexturePool::Initialize())
+		return false;
+
 	return true;
 }
 
 void AkDevice::Deinitialize()
 {
+	AkTexturePool::Deinitialize();
+	AkMipGenerator::Deinitialize();
+	AkTextureStreamer::Deinitialize();
+	AkTextureReadback::Deinitialize();
+	AkDeferredDestruction::Deinitialize();
+	AkGpuCompletion::Deinitialize();
+	AkSubmissionQueue::Deinitialize();
 	AkCommandBufferAllocator::Deinitialize();
+	AkMemoryAllocator::Deinitialize();
 
 #if DEBUG
 	sInstance.destroyDebugUtilsMessengerEXT(sDebugMessenger);
@@ -90,6 +133,7 @@ void AkDevice::Deinitialize()
 
 void AkDevice::WaitIdle()
 {
+	AkSubmissionQueue::WaitIdle();
 	sDevice.waitIdle();
 }
 
@@ -148,6 +192,36 @@ bool AkDevice::SupportsAsyncTransfer()
 	return m_SupportsAsyncTransfer;
 }
 
+float AkDevice::GetTimestampPeriod()
+{
+	return m_TimestampPeriod;
+}
+
+bool AkDevice::SupportsPresentWait()
+{
+	return m_SupportsPresentWait;
+}
+
+bool AkDevice::SupportsMemoryBudget()
+{
+	return m_SupportsMemoryBudget;
+}
+
+bool AkDevice::SupportsPushDescriptors()
+{
+	return m_SupportsPushDescriptors;
+}
+
+bool AkDevice::SupportsFormatlessStorageWrites()
+{
+	return m_SupportsFormatlessStorageWrites;
+}
+
+bool AkDevice::SupportsFormatFeatures(const AkPixelFormat format, const AkFormatFeatureFlags features)
+{
+	return (m_FormatFeatures[static_cast<size_t>(format)] & features) == features;
+}
+
 bool AkDevice::CreateInstance()
 {
 	VULKAN_HPP_DEFAULT_DISPATCHER.init();
@@ -340,13 +414,53 @@ bool AkDevice::CreateLogicalDevices()
 
 	extensionToEnable.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
 
+	if (!IsExtensionAvailable(deviceExtensions, VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME))
+	{
+		AkLogError("Required extension '{}' is not available", VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME);
+		return false;
+	}
+
+	extensionToEnable.push_back(VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME);
+
 	//Optional Extensions
+	vk::PhysicalDevicePresentIdFeaturesKHR presentIdFeatures = {};
+	vk::PhysicalDevicePresentWaitFeaturesKHR presentWaitFeatures = {};
+
+	if (IsExtensionAvailable(deviceExtensions, VK_KHR_PRESENT_ID_EXTENSION_NAME) && IsExtensionAvailable(deviceExtensions, VK_KHR_PRESENT_WAIT_EXTENSION_NAME))
+	{
+		const auto supportedFeatures = sPhysicalDevice.getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDevicePresentIdFeaturesKHR, vk::PhysicalDevicePresentWaitFeaturesKHR>();
+		m_SupportsPresentWait = supportedFeatures.get<vk::PhysicalDevicePresentIdFeaturesKHR>().presentId && supportedFeatures.get<vk::PhysicalDevicePresentWaitFeaturesKHR>().presentWait;
+
+		if (m_SupportsPresentWait)
+		{
+			presentIdFeatures.presentId = true;
+			presentWaitFeatures.presentWait = true;
+			presentIdFeatures.pNext = &presentWaitFeatures;
+
+			extensionToEnable.push_back(VK_KHR_PRESENT_ID_EXTENSION_NAME);
+			extensionToEnable.push_back(VK_KHR_PRESENT_WAIT_EXTENSION_NAME);
+		}
+	}
+
+	// Texture streaming sizes its residency from the budget, so it is needed in every build
+	m_SupportsMemoryBudget = IsExtensionAvailable(deviceExtensions, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+	if (m_SupportsMemoryBudget)
+		extensionToEnable.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+
+	// Compute mip generation pushes its descriptors and writes every storage format through a single shader
+	m_SupportsPushDescriptors = IsExtensionAvailable(deviceExtensions, VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME);
+	if (m_SupportsPushDescriptors)
+		extensionToEnable.push_back(VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME);
+
+	m_SupportsFormatlessStorageWrites = sPhysicalDevice.getFeatures().shaderStorageImageWriteWithoutFormat;
+	const vk::PhysicalDeviceFeatures enabledFeatures =
+	{
+		.shaderStorageImageWriteWithoutFormat = m_SupportsFormatlessStorageWrites
+	};
+
 #if DEBUG
 	if (IsExtensionAvailable(deviceExtensions, VK_EXT_DEBUG_MARKER_EXTENSION_NAME))
 		extensionToEnable.push_back(VK_EXT_DEBUG_MARKER_EXTENSION_NAME);
-
-	if (IsExtensionAvailable(deviceExtensions, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME))
-		extensionToEnable.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
 #endif
 
 	//Get Device queues
@@ -379,11 +493,19 @@ bool AkDevice::CreateLogicalDevices()
 		deviceQueueInfos.push_back(queueCreateInfo);
 	}
 
+	vk::PhysicalDeviceSynchronization2FeaturesKHR synchronization2Features =
+	{
+		.pNext = m_SupportsPresentWait ? &presentIdFeatures : nullptr,
+		.synchronization2 = true
+	};
+
 	vk::DeviceCreateInfo deviceCreateInfo = {};
+	deviceCreateInfo.pNext = &synchronization2Features;
 	deviceCreateInfo.queueCreateInfoCount = static_cast<uint32_t>(deviceQueueInfos.size());
 	deviceCreateInfo.pQueueCreateInfos = deviceQueueInfos.data();
 	deviceCreateInfo.enabledExtensionCount = static_cast<uint32_t>(extensionToEnable.size());
 	deviceCreateInfo.ppEnabledExtensionNames = extensionToEnable.data();
+	deviceCreateInfo.pEnabledFeatures = &enabledFeatures;
 
 	try
 	{
@@ -404,6 +526,9 @@ bool AkDevice::CreateLogicalDevices()
 
 	sTransferQueueFamilyIndex = selectedDeviceTransferQueueFamilyIndex;
 	sTransferQueue = sDevice.getQueue(selectedDeviceTransferQueueFamilyIndex, 0);
+
+	const uint32_t timestampValidBits = sPhysicalDevice.getQueueFamilyProperties()[selectedDeviceGraphicsQueueFamilyIndex].timestampValidBits;
+	m_TimestampPeriod = timestampValidBits > 0 ? sPhysicalDevice.getProperties().limits.timestampPeriod : 0.f;
 	return true;
 }
 
@@ -429,4 +554,30 @@ bool AkDevice::InitializeExtensions()
 #endif
 
 	return true;
+}
+
+void AkDevice::CacheFormatFeatures()
+{
+	static constexpr std::pair<vk::FormatFeatureFlagBits, AkFormatFeatureBits> kFeatureMapping[] =
+	{
+		{ vk::FormatFeatureFlagBits::eSampledImage,				AkFormatFeatures_SAMPLED },
+		{ vk::FormatFeatureFlagBits::eSampledImageFilterLinear,	AkFormatFeatures_LINEAR_FILTER },
+		{ vk::FormatFeatureFlagBits::eStorageImage,				AkFormatFeatures_STORAGE },
+		{ vk::FormatFeatureFlagBits::eColorAttachment,			AkFormatFeatures_RENDER_TARGET },
+		{ vk::FormatFeatureFlagBits::eColorAttachmentBlend,		AkFormatFeatures_BLEND },
+		{ vk::FormatFeatureFlagBits::eDepthStencilAttachment,	AkFormatFeatures_DEPTH_STENCIL },
+		{ vk::FormatFeatureFlagBits::eBlitSrc,					AkFormatFeatures_BLIT_SOURCE },
+		{ vk::FormatFeatureFlagBits::eBlitDst,					AkFormatFeatures_BLIT_DESTINATION }
+	};
+
+	m_FormatFeatures.fill(0);
+	for (size_t i = 1; i < kPixelFormatCount; ++i)
+	{
+		const vk::FormatFeatureFlags optimalTilingFeatures = sPhysicalDevice.getFormatProperties(GetVkFormat(static_cast<AkPixelFormat>(i))).optimalTilingFeatures;
+		for (const auto& [vkFeature, feature] : kFeatureMapping)
+		{
+			if (optimalTilingFeatures & vkFeature)
+				m_FormatFeatures[i] |= feature;
+		}
+	}
 }
\ No newline at end of file
@@ -1,4 +1,7 @@
 #pragma once
+#include "RHI/Textures/PixelFormats.h"
+
+#include <array>
 #include <cstdint>
 
 namespace vk 
@@ -9,6 +12,20 @@ namespace vk
 	class PhysicalDevice; 
 }
 
+// Features of optimally tiled images, as reported by the device for each pixel format
+enum AkFormatFeatureBits
+{
+	AkFormatFeatures_SAMPLED			= 1 << 0,
+	AkFormatFeatures_LINEAR_FILTER		= 1 << 1,
+	AkFormatFeatures_STORAGE			= 1 << 2,
+	AkFormatFeatures_RENDER_TARGET		= 1 << 3,
+	AkFormatFeatures_BLEND				= 1 << 4,
+	AkFormatFeatures_DEPTH_STENCIL		= 1 << 5,
+	AkFormatFeatures_BLIT_SOURCE		= 1 << 6,
+	AkFormatFeatures_BLIT_DESTINATION	= 1 << 7
+};
+using AkFormatFeatureFlags = std::underlying_type_t<AkFormatFeatureBits>;
+
 class AkDevice
 {
 public:
@@ -30,12 +47,29 @@ public:
 
 	static bool SupportsAsyncCompute();
 	static bool SupportsAsyncTransfer();
+	static bool SupportsPresentWait();
+	static bool SupportsMemoryBudget();
+	static bool SupportsPushDescriptors();
+	static bool SupportsFormatlessStorageWrites();
+
+	// Answered from the properties queried once at startup, so it is cheap enough for hot paths
+	static bool SupportsFormatFeatures(const AkPixelFormat format, const AkFormatFeatureFlags features);
+
+	// Nanoseconds per timestamp tick, zero when the graphics queue can not write timestamps
+	static float GetTimestampPeriod();
 
 private:
 	static bool CreateInstance();
 	static bool CreateLogicalDevices();
 	static bool InitializeExtensions();
+	static void CacheFormatFeatures();
 
 	static inline bool m_SupportsAsyncCompute = false;
 	static inline bool m_SupportsAsyncTransfer = false;
+	static inline bool m_SupportsPresentWait = false;
+	static inline bool m_SupportsMemoryBudget = false;
+	static inline bool m_SupportsPushDescriptors = false;
+	static inline bool m_SupportsFormatlessStorageWrites = false;
+	static inline float m_TimestampPeriod = 0.f;
+	static inline std::array<AkFormatFeatureFlags, kPixelFormatCount> m_FormatFeatures = {};
 };
\ No newline at end of file
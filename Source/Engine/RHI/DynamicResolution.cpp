@@ -0,0 +1,164 @@
+#include "DynamicResolution.h"
+#include "Core/Log.h"
+#include "RHI/Device.h"
+#include "RHI/DeferredDestruction.h"
+#include "RHI/Textures/Texture.h"
+#include "RHI/CommandBuffers/CommandBuffer.h"
+
+#include <array>
+#include <cmath>
+#include <algorithm>
+#include <vulkan/vulkan.hpp>
+
+// The GPU time is smoothed over a few frames, so a single slow frame does not drop the resolution on its own
+static constexpr float kGpuTimeSmoothing = 0.15f;
+static constexpr float kBudgetHeadroom = 0.9f;
+
+// Scale drops fast to get back under budget and rises slowly to not oscillate around it
+static constexpr float kMaxScaleDecrease = 0.1f;
+static constexpr float kMaxScaleIncrease = 0.02f;
+
+struct AkDynamicResolutionStorage
+{
+	vk::QueryPool queryPool = nullptr;
+};
+
+AkDynamicResolution::AkDynamicResolution(const AkDynamicResolutionDescriptor& descriptor, const uint32_t framesInFlight)
+{
+	m_Descriptor = descriptor;
+	m_Descriptor.maxScale = std::clamp(m_Descriptor.maxScale, 0.1f, 1.f);
+	m_Descriptor.minScale = std::clamp(m_Descriptor.minScale, 0.1f, m_Descriptor.maxScale);
+	m_Scale = m_Descriptor.maxScale;
+	m_HasTimestamps.resize(framesInFlight, false);
+
+	if (AkDevice::GetTimestampPeriod() <= 0.f)
+	{
+		AkLogWarning("Graphics queue does not support timestamps, dynamic resolution stays at its maximum scale");
+		return;
+	}
+
+	const vk::QueryPoolCreateInfo queryPoolCreateInfo =
+	{
+		.queryType = vk::QueryType::eTimestamp,
+		.queryCount = framesInFlight * 2
+	};
+
+	try
+	{
+		m_Storage->queryPool = AkDevice::GetDevice().createQueryPool(queryPoolCreateInfo);
+	}
+	catch (const std::exception& exception)
+	{
+		AkLogError("Failed to create timestamp query pool: {}", exception.what());
+		throw std::runtime_error("Failed to create AkDynamicResolution");
+	}
+}
+
+AkDynamicResolution::~AkDynamicResolution()
+{
+	m_RenderTarget.reset();
+	AkDevice::GetDevice().destroyQueryPool(m_Storage->queryPool);
+}
+
+bool AkDynamicResolution::Resize(const glm::uvec2& outputSize, const AkPixelFormat format)
+{
+	if (m_RenderTarget && m_OutputSize == outputSize && m_RenderTarget->GetDescriptor().format == format)
+		return true;
+
+	// Frames in flight may still render into the previous target
+	if (m_RenderTarget)
+		AkDeferredDestruction::Enqueue([renderTarget = std::move(m_RenderTarget)]() mutable { renderTarget.reset(); });
+
+	const AkTextureDescriptor descriptor =
+	{
+		.width = std::max(1u, static_cast<uint32_t>(std::ceil(outputSize.x * m_Descriptor.maxScale))),
+		.height = std::max(1u, static_cast<uint32_t>(std::ceil(outputSize.y * m_Descriptor.maxScale))),
+		.flags = AkTextureFlags_DEFAULT_RT | AkTextureFlags_COPY_SOURCE | AkTextureFlags_COPY_DESTINATION,
+		.format = format
+	};
+
+	try
+	{
+		m_RenderTarget = std::make_unique<AkTexture>(descriptor);
+	}
+	catch (const std::exception& exception)
+	{
+		AkLogError("Failed to create dynamic resolution render target: {}", exception.what());
+		return false;
+	}
+
+	m_OutputSize = outputSize;
+	UpdateRenderSize();
+
+	return true;
+}
+
+void AkDynamicResolution::BeginFrame(const uint32_t frameIndex)
+{
+	if (!m_HasTimestamps[frameIndex])
+		return;
+
+	m_HasTimestamps[frameIndex] = false;
+
+	// The frame fence has signaled, so the results are available and this never waits
+	std::array<uint64_t, 2> timestamps = {};
+	const vk::Result result = AkDevice::GetDevice().getQueryPoolResults(m_Storage->queryPool, frameIndex * 2, 2, sizeof(timestamps), timestamps.data(), sizeof(uint64_t), vk::QueryResultFlagBits::e64);
+	if (result != vk::Result::eSuccess || timestamps[1] < timestamps[0])
+		return;
+
+	const double gpuTime = static_cast<double>(timestamps[1] - timestamps[0]) * AkDevice::GetTimestampPeriod() / 1'000'000.0;
+	UpdateScale(static_cast<float>(gpuTime));
+}
+
+void AkDynamicResolution::RecordFrameBegin(AkCommandBuffer* commandBuffer, const uint32_t frameIndex)
+{
+	if (!m_Storage->queryPool)
+		return;
+
+	vk::CommandBuffer& vkCommandBuffer = commandBuffer->GetBuffer();
+	vkCommandBuffer.resetQueryPool(m_Storage->queryPool, frameIndex * 2, 2);
+	vkCommandBuffer.writeTimestamp2KHR(vk::PipelineStageFlagBits2::eTopOfPipe, m_Storage->queryPool, frameIndex * 2);
+}
+
+void AkDynamicResolution::RecordUpscale(AkCommandBuffer* commandBuffer, AkTexture* backBuffer, const uint32_t frameIndex)
+{
+	const AkTextureDescriptor& backBufferDescriptor = backBuffer->GetDescriptor();
+	commandBuffer->BlitTexture(m_RenderTarget.get(), m_RenderSize, backBuffer, { backBufferDescriptor.width, backBufferDescriptor.height });
+	commandBuffer->RequireState(backBuffer, AkResourceState::PRESENT);
+	commandBuffer->FlushBarriers();
+
+	if (!m_Storage->queryPool)
+		return;
+
+	commandBuffer->GetBuffer().writeTimestamp2KHR(vk::PipelineStageFlagBits2::eBottomOfPipe, m_Storage->queryPool, frameIndex * 2 + 1);
+	m_HasTimestamps[frameIndex] = true;
+}
+
+void AkDynamicResolution::UpdateScale(const float gpuTime)
+{
+	m_GpuTime = gpuTime;
+	m_FilteredGpuTime = m_FilteredGpuTime > 0.f ? m_FilteredGpuTime + (gpuTime - m_FilteredGpuTime) * kGpuTimeSmoothing : gpuTime;
+	if (m_FilteredGpuTime <= 0.f)
+		return;
+
+	// GPU cost roughly follows the pixel count, which grows with the square of the scale
+	const float scale = m_Scale;
+	const float targetTime = m_Descriptor.gpuBudgetMilliseconds * kBudgetHeadroom;
+	float desiredScale = scale * std::sqrt(targetTime / m_FilteredGpuTime);
+
+	desiredScale = std::clamp(desiredScale, scale * (1.f - kMaxScaleDecrease), scale * (1.f + kMaxScaleIncrease));
+	m_Scale = std::clamp(desiredScale, m_Descriptor.minScale, m_Descriptor.maxScale);
+	UpdateRenderSize();
+}
+
+void AkDynamicResolution::UpdateRenderSize()
+{
+	if (!m_RenderTarget)
+		return;
+
+	const AkTextureDescriptor& descriptor = m_RenderTarget->GetDescriptor();
+	const float scale = m_Scale;
+
+	m_RenderSize.x = std::clamp(static_cast<uint32_t>(std::lround(m_OutputSize.x * scale)), 1u, descriptor.width);
+	m_RenderSize.y = std::clamp(static_cast<uint32_t>(std::lround(m_OutputSize.y * scale)), 1u, descriptor.height);
+}
\ No newline at end of file
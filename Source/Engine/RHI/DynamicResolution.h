@@ -0,0 +1,60 @@
+#pragma once
+#include "RHI/Textures/PixelFormats.h"
+#include "Utilities/ForwardStorage.h"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <glm/vec2.hpp>
+
+struct AkDynamicResolutionDescriptor
+{
+	bool isEnabled = false;
+
+	// Fraction of the back buffer size rendered on each axis
+	float minScale = 0.5f;
+	float maxScale = 1.f;
+
+	// GPU time per frame the controller keeps under, with some headroom to absorb spikes
+	float gpuBudgetMilliseconds = 16.f;
+};
+
+// Renders into a target allocated once at the maximum scale and only uses its top left region, sized from the GPU time of past frames.
+// Scale changes never reallocate anything, the region is upscaled into the back buffer at the end of the frame.
+class AkDynamicResolution
+{
+public:
+	AkDynamicResolution(const AkDynamicResolutionDescriptor& descriptor, const uint32_t framesInFlight);
+	~AkDynamicResolution();
+
+	// Only reallocates the render target when the output size or format changed
+	bool Resize(const glm::uvec2& outputSize, const AkPixelFormat format);
+
+	// Must be called once the fence of the frame has signaled, the GPU time it measured drives the scale of the next frames
+	void BeginFrame(const uint32_t frameIndex);
+
+	void RecordFrameBegin(class AkCommandBuffer* commandBuffer, const uint32_t frameIndex);
+	void RecordUpscale(class AkCommandBuffer* commandBuffer, class AkTexture* backBuffer, const uint32_t frameIndex);
+
+	class AkTexture* GetRenderTarget() const { return m_RenderTarget.get(); }
+	const glm::uvec2& GetRenderSize() const { return m_RenderSize; }
+
+	float GetScale() const { return m_Scale; }
+	float GetGpuTime() const { return m_GpuTime; }
+
+private:
+	AkDynamicResolutionDescriptor m_Descriptor = {};
+	std::atomic<float> m_Scale = 1.f;
+	std::atomic<float> m_GpuTime = 0.f;
+	float m_FilteredGpuTime = 0.f;
+
+	glm::uvec2 m_OutputSize = {};
+	glm::uvec2 m_RenderSize = {};
+	std::vector<uint8_t> m_HasTimestamps;
+
+	std::unique_ptr<class AkTexture> m_RenderTarget = nullptr;
+	ForwardStorage<struct AkDynamicResolutionStorage, 8> m_Storage;
+
+	void UpdateScale(const float gpuTime);
+	void UpdateRenderSize();
+};
\ No newline at end of file
@@ -0,0 +1,148 @@
+#include "GpuCompletion.h"
+#include "Core/Log.h"
+#include "RHI/Device.h"
+
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <condition_variable>
+#include <vulkan/vulkan.hpp>
+
+// Bounds how late a fence submitted while the watcher is already waiting gets picked up
+static constexpr uint64_t kWatchTimeout = 1'000'000;
+
+struct AkFenceWatch
+{
+	vk::Fence fence = {};
+	AkJobFunction callback = nullptr;
+};
+
+static std::thread sWatcherThread;
+static std::mutex sWatchesMutex;
+static std::condition_variable sWatchesCondition;
+
+static bool sShouldExit = false;
+static std::vector<AkFenceWatch> sPendingWatches;
+
+bool AkFenceAwaiter::await_ready() const
+{
+	return AkDevice::GetDevice().getFenceStatus(fence) == vk::Result::eSuccess;
+}
+
+void AkFenceAwaiter::await_suspend(std::coroutine_handle<> handle) const
+{
+	AkGpuCompletion::OnSignaled(fence, [handle]() { handle.resume(); });
+}
+
+void AkFenceAwaiter::await_resume() const
+{
+	// Errors other than the fence not being signaled are thrown by the query itself
+	if (AkDevice::GetDevice().getFenceStatus(fence) != vk::Result::eSuccess)
+		throw std::runtime_error("Fence was resumed before it was signaled");
+}
+
+bool AkGpuCompletion::Initialize()
+{
+	sShouldExit = false;
+
+	try
+	{
+		sWatcherThread = std::thread(&AkGpuCompletion::WatcherThread);
+	}
+	catch (const std::exception& exception)
+	{
+		AkLogError("Failed to start fence watcher thread: {}", exception.what());
+		return false;
+	}
+
+	return true;
+}
+
+void AkGpuCompletion::Deinitialize()
+{
+	{
+		std::scoped_lock lock(sWatchesMutex);
+		sShouldExit = true;
+	}
+
+	sWatchesCondition.notify_all();
+	if (sWatcherThread.joinable())
+		sWatcherThread.join();
+}
+
+void AkGpuCompletion::OnSignaled(const vk::Fence& fence, AkJobFunction&& callback)
+{
+	{
+		std::scoped_lock lock(sWatchesMutex);
+		sPendingWatches.push_back({ .fence = fence, .callback = std::move(callback) });
+	}
+
+	sWatchesCondition.notify_one();
+}
+
+AkFenceAwaiter AkGpuCompletion::WhenSignaled(const vk::Fence& fence)
+{
+	return { .fence = fence };
+}
+
+void AkGpuCompletion::WatcherThread()
+{
+	const vk::Device& device = AkDevice::GetDevice();
+
+	std::vector<AkFenceWatch> watches;
+	std::vector<vk::Fence> fences;
+
+	while (true)
+	{
+		{
+			std::unique_lock lock(sWatchesMutex);
+			sWatchesCondition.wait(lock, [&watches]() { return sShouldExit || !sPendingWatches.empty() || !watches.empty(); });
+
+			if (sShouldExit)
+			{
+				if (!watches.empty() || !sPendingWatches.empty())
+					AkLogWarning("Fence watcher exiting with unsignaled fences, their continuations are dropped");
+
+				return;
+			}
+
+			for (AkFenceWatch& pendingWatch : sPendingWatches)
+				watches.push_back(std::move(pendingWatch));
+
+			sPendingWatches.clear();
+		}
+
+		fences.clear();
+		for (const AkFenceWatch& watch : watches)
+			fences.push_back(watch.fence);
+
+		try
+		{
+			if (device.waitForFences(fences, false, kWatchTimeout) == vk::Result::eTimeout)
+				continue;
+
+			for (size_t i = 0; i < watches.size();)
+			{
+				if (device.getFenceStatus(watches[i].fence) == vk::Result::eSuccess)
+				{
+					AkJobSystem::Schedule(std::move(watches[i].callback));
+					watches[i] = std::move(watches.back());
+					watches.pop_back();
+				}
+				else
+				{
+					++i;
+				}
+			}
+		}
+		catch (const std::exception& exception)
+		{
+			// Every continuation still runs, awaiting tasks would otherwise stay suspended forever, they see the error through the fence status
+			AkLogError("Failed to wait for fences: {}", exception.what());
+			for (AkFenceWatch& watch : watches)
+				AkJobSystem::Schedule(std::move(watch.callback));
+
+			watches.clear();
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,34 @@
+#pragma once
+#include "Core/JobSystem.h"
+
+#include <coroutine>
+#include <vulkan/vulkan.hpp>
+
+struct AkFenceAwaiter
+{
+	// Held by value, the handle it was created from may be a temporary that is gone once the awaiting task suspends
+	vk::Fence fence = {};
+
+	bool await_ready() const;
+	void await_suspend(std::coroutine_handle<> handle) const;
+	// Throws into the awaiting task when the fence could not be waited on, e.g. because the device was lost
+	void await_resume() const;
+};
+
+// Watches fences on a dedicated thread and hands their continuations to the job system once the GPU signaled them
+class AkGpuCompletion
+{
+public:
+	static bool Initialize();
+	static void Deinitialize();
+
+	// The callback runs as a job, the fence must stay alive and must not be reset until then.
+	// It also runs when waiting on the fence failed, so callbacks that depend on the result query the fence status.
+	static void OnSignaled(const vk::Fence& fence, AkJobFunction&& callback);
+
+	// Suspends the awaiting task until the fence is signaled, it resumes on the job system
+	static AkFenceAwaiter WhenSignaled(const vk::Fence& fence);
+
+private:
+	static void WatcherThread();
+};
\ No newline at end of file
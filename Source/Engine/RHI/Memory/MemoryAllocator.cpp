@@ -0,0 +1,239 @@
+#include "MemoryAllocator.h"
+#include "Core/Log.h"
+#include "RHI/Device.h"
+
+#include <array>
+#include <span>
+#include <atomic>
+
+static vk::PhysicalDeviceMemoryProperties sMemoryProperties = {};
+static std::array<std::atomic<uint64_t>, VK_MAX_MEMORY_HEAPS> sAllocatedBytes = {};
+
+static uint32_t FindMemoryType(const uint32_t memoryTypeBits, const vk::MemoryPropertyFlags requiredFlags)
+{
+	for (uint32_t i = 0; i < sMemoryProperties.memoryTypeCount; ++i)
+	{
+		if ((memoryTypeBits & (1u << i)) && (sMemoryProperties.memoryTypes[i].propertyFlags & requiredFlags) == requiredFlags)
+			return i;
+	}
+
+	return UINT32_MAX;
+}
+
+static uint32_t FindMemoryType(const uint32_t memoryTypeBits, const AkMemoryUsage usage)
+{
+	using enum vk::MemoryPropertyFlagBits;
+
+	// Candidates are ordered from the best match to the minimum requirement
+	static const std::array kGpuOnlyCandidates = std::to_array<vk::MemoryPropertyFlags>({ eDeviceLocal, {} });
+	static const std::array kUploadCandidates = std::to_array<vk::MemoryPropertyFlags>({ eHostVisible | eHostCoherent, eHostVisible });
+	static const std::array kReadbackCandidates = std::to_array<vk::MemoryPropertyFlags>({ eHostVisible | eHostCached, eHostVisible | eHostCoherent, eHostVisible });
+
+	std::span<const vk::MemoryPropertyFlags> candidates = kGpuOnlyCandidates;
+	switch (usage)
+	{
+		case AkMemoryUsage::GPU_ONLY:	candidates = kGpuOnlyCandidates; break;
+		case AkMemoryUsage::UPLOAD:		candidates = kUploadCandidates; break;
+		case AkMemoryUsage::READBACK:	candidates = kReadbackCandidates; break;
+	}
+
+	for (const vk::MemoryPropertyFlags& candidate : candidates)
+	{
+		const uint32_t memoryTypeIndex = FindMemoryType(memoryTypeBits, candidate);
+		if (memoryTypeIndex != UINT32_MAX)
+			return memoryTypeIndex;
+	}
+
+	return UINT32_MAX;
+}
+
+bool AkMemoryAllocator::Initialize()
+{
+	sMemoryProperties = AkDevice::GetPhysicalDevice().getMemoryProperties();
+	for (std::atomic<uint64_t>& allocatedBytes : sAllocatedBytes)
+		allocatedBytes = 0;
+
+	return true;
+}
+
+void AkMemoryAllocator::Deinitialize()
+{
+	for (uint32_t i = 0; i < sMemoryProperties.memoryHeapCount; ++i)
+	{
+		if (sAllocatedBytes[i] != 0)
+			AkLogWarning("{} bytes are still allocated from memory heap {}", sAllocatedBytes[i].load(), i);
+	}
+}
+
+bool AkMemoryAllocator::CreateBuffer(const vk::BufferCreateInfo& createInfo, const AkMemoryUsage usage, vk::Buffer& outBuffer, AkMemoryAllocation& outAllocation)
+{
+	const vk::Device& device = AkDevice::GetDevice();
+
+	try
+	{
+		outBuffer = device.createBuffer(createInfo);
+		if (Allocate(device.getBufferMemoryRequirements(outBuffer), usage, outAllocation))
+		{
+			device.bindBufferMemory(outBuffer, outAllocation.memory, 0);
+			return true;
+		}
+	}
+	catch (const std::exception& exception)
+	{
+		AkLogError("Failed to create buffer: {}", exception.what());
+	}
+
+	DestroyBuffer(outBuffer, outAllocation);
+	return false;
+}
+
+void AkMemoryAllocator::DestroyBuffer(vk::Buffer& buffer, AkMemoryAllocation& allocation)
+{
+	AkDevice::GetDevice().destroyBuffer(buffer);
+	buffer = nullptr;
+	Free(allocation);
+}
+
+bool AkMemoryAllocator::CreateImage(const vk::ImageCreateInfo& createInfo, const AkMemoryUsage usage, vk::Image& outImage, AkMemoryAllocation& outAllocation)
+{
+	const vk::Device& device = AkDevice::GetDevice();
+
+	try
+	{
+		outImage = device.createImage(createInfo);
+		if (Allocate(device.getImageMemoryRequirements(outImage), usage, outAllocation))
+		{
+			device.bindImageMemory(outImage, outAllocation.memory, 0);
+			return true;
+		}
+	}
+	catch (const std::exception& exception)
+	{
+		AkLogError("Failed to create image: {}", exception.what());
+	}
+
+	DestroyImage(outImage, outAllocation);
+	return false;
+}
+
+void AkMemoryAllocator::DestroyImage(vk::Image& image, AkMemoryAllocation& allocation)
+{
+	AkDevice::GetDevice().destroyImage(image);
+	image = nullptr;
+	Free(allocation);
+}
+
+void AkMemoryAllocator::Flush(const AkMemoryAllocation& allocation)
+{
+	if (allocation.isCoherent || allocation.mappedData == nullptr)
+		return;
+
+	try
+	{
+		AkDevice::GetDevice().flushMappedMemoryRanges(vk::MappedMemoryRange{ .memory = allocation.memory, .offset = 0, .size = VK_WHOLE_SIZE });
+	}
+	catch (const std::exception& exception)
+	{
+		AkLogError("Failed to flush mapped memory: {}", exception.what());
+	}
+}
+
+void AkMemoryAllocator::Invalidate(const AkMemoryAllocation& allocation)
+{
+	if (allocation.isCoherent || allocation.mappedData == nullptr)
+		return;
+
+	try
+	{
+		AkDevice::GetDevice().invalidateMappedMemoryRanges(vk::MappedMemoryRange{ .memory = allocation.memory, .offset = 0, .size = VK_WHOLE_SIZE });
+	}
+	catch (const std::exception& exception)
+	{
+		AkLogError("Failed to invalidate mapped memory: {}", exception.what());
+	}
+}
+
+uint64_t AkMemoryAllocator::GetAllocatedBytes(const uint32_t heapIndex)
+{
+	return heapIndex < sMemoryProperties.memoryHeapCount ? sAllocatedBytes[heapIndex].load(std::memory_order_relaxed) : 0;
+}
+
+AkMemoryBudget AkMemoryAllocator::GetBudget(const AkMemoryUsage usage)
+{
+	// Without the extension a share of the heap is kept free for the rest of the system and other processes
+	static constexpr double kEstimatedBudgetFraction = 0.8;
+
+	// Any memory type works to find the heap the usage allocates from
+	const uint32_t memoryTypeIndex = FindMemoryType(UINT32_MAX, usage);
+	if (memoryTypeIndex == UINT32_MAX)
+		return {};
+
+	const uint32_t heapIndex = sMemoryProperties.memoryTypes[memoryTypeIndex].heapIndex;
+	if (AkDevice::SupportsMemoryBudget())
+	{
+		const auto memoryProperties = AkDevice::GetPhysicalDevice().getMemoryProperties2<vk::PhysicalDeviceMemoryProperties2, vk::PhysicalDeviceMemoryBudgetPropertiesEXT>();
+		const vk::PhysicalDeviceMemoryBudgetPropertiesEXT& budgetProperties = memoryProperties.get<vk::PhysicalDeviceMemoryBudgetPropertiesEXT>();
+		return { .budget = budgetProperties.heapBudget[heapIndex], .usage = budgetProperties.heapUsage[heapIndex] };
+	}
+
+	return
+	{
+		.budget = static_cast<uint64_t>(static_cast<double>(sMemoryProperties.memoryHeaps[heapIndex].size) * kEstimatedBudgetFraction),
+		.usage = GetAllocatedBytes(heapIndex)
+	};
+}
+
+bool AkMemoryAllocator::Allocate(const vk::MemoryRequirements& requirements, const AkMemoryUsage usage, AkMemoryAllocation& outAllocation)
+{
+	const uint32_t memoryTypeIndex = FindMemoryType(requirements.memoryTypeBits, usage);
+	if (memoryTypeIndex == UINT32_MAX)
+	{
+		AkLogError("No memory type matches the requirements of the resource");
+		return false;
+	}
+
+	const vk::MemoryAllocateInfo allocateInfo =
+	{
+		.allocationSize = requirements.size,
+		.memoryTypeIndex = memoryTypeIndex
+	};
+
+	const vk::Device& device = AkDevice::GetDevice();
+	const vk::MemoryPropertyFlags propertyFlags = sMemoryProperties.memoryTypes[memoryTypeIndex].propertyFlags;
+
+	try
+	{
+		outAllocation.memory = device.allocateMemory(allocateInfo);
+		if (propertyFlags & vk::MemoryPropertyFlagBits::eHostVisible)
+			outAllocation.mappedData = device.mapMemory(outAllocation.memory, 0, VK_WHOLE_SIZE);
+	}
+	catch (const std::exception& exception)
+	{
+		AkLogError("Failed to allocate {} bytes of device memory: {}", requirements.size, exception.what());
+		Free(outAllocation);
+		return false;
+	}
+
+	outAllocation.size = requirements.size;
+	outAllocation.memoryTypeIndex = memoryTypeIndex;
+	outAllocation.isCoherent = static_cast<bool>(propertyFlags & vk::MemoryPropertyFlagBits::eHostCoherent);
+
+	sAllocatedBytes[sMemoryProperties.memoryTypes[memoryTypeIndex].heapIndex] += outAllocation.size;
+	return true;
+}
+
+void AkMemoryAllocator::Free(AkMemoryAllocation& allocation)
+{
+	if (!allocation.memory)
+	{
+		allocation = {};
+		return;
+	}
+
+	// Freeing memory implicitly unmaps it, the size is only set once the allocation was accounted for
+	AkDevice::GetDevice().freeMemory(allocation.memory);
+	if (allocation.size != 0)
+		sAllocatedBytes[sMemoryProperties.memoryTypes[allocation.memoryTypeIndex].heapIndex] -= allocation.size;
+
+	allocation = {};
+}
\ No newline at end of file
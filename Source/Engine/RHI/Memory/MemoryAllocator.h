@@ -0,0 +1,63 @@
+#pragma once
+#include <cstdint>
+#include <vulkan/vulkan.hpp>
+
+enum class AkMemoryUsage
+{
+	// Device local, only accessed by the GPU
+	GPU_ONLY,
+
+	// Host visible and written by the CPU every frame, coherent where available, otherwise writes need a Flush
+	UPLOAD,
+
+	// Host visible and read by the CPU, cached where available as uncached reads are very slow
+	READBACK
+};
+
+struct AkMemoryAllocation
+{
+	vk::DeviceMemory memory = nullptr;
+	vk::DeviceSize size = 0;
+	uint32_t memoryTypeIndex = UINT32_MAX;
+	bool isCoherent = true;
+
+	// Host visible memory stays mapped for the whole lifetime of the allocation
+	void* mappedData = nullptr;
+};
+
+struct AkMemoryBudget
+{
+	// Bytes the process can use from the heap before the system starts to demote or fail allocations
+	uint64_t budget = 0;
+
+	// Bytes the process currently uses from the heap, including memory not allocated by the engine allocator
+	uint64_t usage = 0;
+};
+
+// Every resource gets its own dedicated allocation, the allocator picks the memory type and accounts for the bytes allocated per heap
+class AkMemoryAllocator
+{
+public:
+	static bool Initialize();
+	static void Deinitialize();
+
+	static bool CreateBuffer(const vk::BufferCreateInfo& createInfo, const AkMemoryUsage usage, vk::Buffer& outBuffer, AkMemoryAllocation& outAllocation);
+	static void DestroyBuffer(vk::Buffer& buffer, AkMemoryAllocation& allocation);
+
+	static bool CreateImage(const vk::ImageCreateInfo& createInfo, const AkMemoryUsage usage, vk::Image& outImage, AkMemoryAllocation& outAllocation);
+	static void DestroyImage(vk::Image& image, AkMemoryAllocation& allocation);
+
+	// Makes writes of the host visible to the GPU, must happen before the submission that reads them, does nothing for coherent memory
+	static void Flush(const AkMemoryAllocation& allocation);
+	// Makes writes of the GPU visible to the host, does nothing for coherent memory
+	static void Invalidate(const AkMemoryAllocation& allocation);
+
+	static uint64_t GetAllocatedBytes(const uint32_t heapIndex);
+
+	// Queried from VK_EXT_memory_budget when available, otherwise estimated from the heap size and the bytes allocated by the engine
+	static AkMemoryBudget GetBudget(const AkMemoryUsage usage);
+
+private:
+	static bool Allocate(const vk::MemoryRequirements& requirements, const AkMemoryUsage usage, AkMemoryAllocation& outAllocation);
+	static void Free(AkMemoryAllocation& allocation);
+};
\ No newline at end of file
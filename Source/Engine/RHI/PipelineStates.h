@@ -1,4 +1,6 @@
 #pragma once
+#include <cstdint>
+#include <type_traits>
 
 enum class AkResourceState
 {
@@ -15,4 +17,25 @@ enum class AkResourceState
 	COPY_DESTINATION,
 	COPY_SOURCE,
 	PRESENT
+};
+
+enum AkShaderStageFlagBits : uint8_t
+{
+	AkShaderStage_NONE			= 0,
+	AkShaderStage_VERTEX		= 1 << 0,
+	AkShaderStage_FRAGMENT		= 1 << 1,
+	AkShaderStage_COMPUTE		= 1 << 2,
+
+	AkShaderStage_ALL_GRAPHICS	= AkShaderStage_VERTEX | AkShaderStage_FRAGMENT,
+	AkShaderStage_ALL			= AkShaderStage_ALL_GRAPHICS | AkShaderStage_COMPUTE
+};
+using AkShaderStageFlags = std::underlying_type_t<AkShaderStageFlagBits>;
+
+// Shader stages are only meaningful for states that are accessed from shaders (constant buffers, shader resources and unordered access)
+struct AkSubresourceState
+{
+	AkResourceState state = AkResourceState::UNDEFINED;
+	AkShaderStageFlags shaderStages = AkShaderStage_NONE;
+
+	bool operator==(const AkSubresourceState& other) const = default;
 };
\ No newline at end of file
@@ -0,0 +1,330 @@
+#include "SubmissionQueue.h"
+#include "Core/Log.h"
+#include "Core/Assert.h"
+#include "RHI/Device.h"
+#include "RHI/VulkanPipelineStates.h"
+
+#include <array>
+#include <deque>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <condition_variable>
+#include <vulkan/vulkan.hpp>
+
+static constexpr uint32_t kDeviceQueueCount = 3;
+
+struct AkSubmitBatch
+{
+	std::vector<vk::SemaphoreSubmitInfo> waitSemaphores;
+	std::vector<vk::CommandBufferSubmitInfo> commandBuffers;
+	std::vector<vk::SemaphoreSubmitInfo> signalSemaphores;
+};
+
+struct AkQueueSubmission
+{
+	uint32_t batchCount = 0;
+	std::vector<AkSubmitBatch> batches;
+	std::vector<vk::SubmitInfo2> submitInfos;
+	vk::Fence fence = {};
+};
+
+struct AkPresentRequest
+{
+	vk::SwapchainKHR swapchain = {};
+	uint32_t imageIndex = 0;
+	uint64_t presentId = 0;
+	vk::Semaphore waitSemaphore = {};
+	std::atomic<bool>* needsRecreation = nullptr;
+};
+
+struct AkSubmissionFrame
+{
+	std::array<AkQueueSubmission, kDeviceQueueCount> queues;
+	std::vector<uint32_t> queueOrder;
+	std::vector<AkPresentRequest> presents;
+};
+
+static std::thread sSubmitThread;
+static std::mutex sPresentMutex;
+static std::mutex sFramesMutex;
+static std::condition_variable sFramesCondition;
+
+static bool sShouldExit = false;
+static bool sIsProcessing = false;
+static std::deque<std::unique_ptr<AkSubmissionFrame>> sPendingFrames;
+static std::vector<std::unique_ptr<AkSubmissionFrame>> sFreeFrames;
+static std::unique_ptr<AkSubmissionFrame> sRecordingFrame;
+
+static const vk::Queue& GetQueue(const AkDeviceQueue deviceQueue)
+{
+	switch (deviceQueue)
+	{
+		default:
+		case AkDeviceQueue::GRAPHICS:	return AkDevice::GetGraphicsQueue();
+		case AkDeviceQueue::COMPUTE:	return AkDevice::GetComputeQueue();
+		case AkDeviceQueue::TRANSFER:	return AkDevice::GetTransferQueue();
+	}
+}
+
+static AkQueueSubmission& GetQueueSubmission(const AkDeviceQueue deviceQueue)
+{
+	const uint32_t queueIndex = static_cast<uint32_t>(deviceQueue);
+	AkQueueSubmission& queueSubmission = sRecordingFrame->queues[queueIndex];
+
+	// Queues are submitted in the order they were first used in a frame, so cross queue semaphores are signaled before they are waited on
+	if (std::find(sRecordingFrame->queueOrder.begin(), sRecordingFrame->queueOrder.end(), queueIndex) == sRecordingFrame->queueOrder.end())
+		sRecordingFrame->queueOrder.push_back(queueIndex);
+
+	if (queueSubmission.batchCount == 0)
+		queueSubmission.batchCount = 1;
+
+	if (queueSubmission.batches.size() < queueSubmission.batchCount)
+		queueSubmission.batches.resize(queueSubmission.batchCount);
+
+	return queueSubmission;
+}
+
+static AkSubmitBatch& BeginBatch(AkQueueSubmission& queueSubmission)
+{
+	++queueSubmission.batchCount;
+	if (queueSubmission.batches.size() < queueSubmission.batchCount)
+		queueSubmission.batches.resize(queueSubmission.batchCount);
+
+	return queueSubmission.batches[queueSubmission.batchCount - 1];
+}
+
+bool AkSubmissionQueue::Initialize()
+{
+	sShouldExit = false;
+	sRecordingFrame = std::make_unique<AkSubmissionFrame>();
+
+	try
+	{
+		sSubmitThread = std::thread(&AkSubmissionQueue::SubmitThread);
+	}
+	catch (const std::exception& exception)
+	{
+		AkLogError("Failed to start submission thread: {}", exception.what());
+		return false;
+	}
+
+	return true;
+}
+
+void AkSubmissionQueue::Deinitialize()
+{
+	WaitIdle();
+
+	{
+		std::scoped_lock lock(sFramesMutex);
+		sShouldExit = true;
+	}
+
+	sFramesCondition.notify_all();
+	if (sSubmitThread.joinable())
+		sSubmitThread.join();
+
+	sFreeFrames.clear();
+	sRecordingFrame.reset();
+}
+
+void AkSubmissionQueue::Wait(const AkDeviceQueue deviceQueue, const vk::Semaphore& semaphore, const AkSubresourceState& firstUse)
+{
+	AkQueueSubmission& queueSubmission = GetQueueSubmission(deviceQueue);
+	AkSubmitBatch* batch = &queueSubmission.batches[queueSubmission.batchCount - 1];
+
+	// Waits only apply to the work that comes after them, so anything already gathered goes into an earlier batch
+	if (!batch->commandBuffers.empty() || !batch->signalSemaphores.empty())
+		batch = &BeginBatch(queueSubmission);
+
+	batch->waitSemaphores.push_back(
+	{
+		.semaphore = semaphore,
+		.stageMask = GetPipelineStageFlags(firstUse)
+	});
+}
+
+void AkSubmissionQueue::Submit(const AkDeviceQueue deviceQueue, AkCommandBuffer* commandBuffer)
+{
+	AkQueueSubmission& queueSubmission = GetQueueSubmission(deviceQueue);
+	AkSubmitBatch* batch = &queueSubmission.batches[queueSubmission.batchCount - 1];
+
+	if (!batch->signalSemaphores.empty())
+		batch = &BeginBatch(queueSubmission);
+
+	batch->commandBuffers.push_back(
+	{
+		.commandBuffer = commandBuffer->GetBuffer()
+	});
+}
+
+void AkSubmissionQueue::Signal(const AkDeviceQueue deviceQueue, const vk::Semaphore& semaphore)
+{
+	AkQueueSubmission& queueSubmission = GetQueueSubmission(deviceQueue);
+	queueSubmission.batches[queueSubmission.batchCount - 1].signalSemaphores.push_back(
+	{
+		.semaphore = semaphore,
+		.stageMask = vk::PipelineStageFlagBits2::eAllCommands
+	});
+}
+
+void AkSubmissionQueue::Signal(const AkDeviceQueue deviceQueue, const vk::Fence& fence)
+{
+	AkQueueSubmission& queueSubmission = GetQueueSubmission(deviceQueue);
+	AkAssert(!queueSubmission.fence, "Only one fence can be signaled per queue and frame");
+	queueSubmission.fence = fence;
+}
+
+void AkSubmissionQueue::Present(const vk::SwapchainKHR& swapchain, const uint32_t imageIndex, const vk::Semaphore& waitSemaphore, std::atomic<bool>& outNeedsRecreation, const uint64_t presentId)
+{
+	sRecordingFrame->presents.push_back(
+	{
+		.swapchain = swapchain,
+		.imageIndex = imageIndex,
+		.presentId = presentId,
+		.waitSemaphore = waitSemaphore,
+		.needsRecreation = &outNeedsRecreation
+	});
+}
+
+void AkSubmissionQueue::Flush()
+{
+	{
+		std::scoped_lock lock(sFramesMutex);
+		sPendingFrames.push_back(std::move(sRecordingFrame));
+
+		if (!sFreeFrames.empty())
+		{
+			sRecordingFrame = std::move(sFreeFrames.back());
+			sFreeFrames.pop_back();
+		}
+	}
+
+	if (!sRecordingFrame)
+		sRecordingFrame = std::make_unique<AkSubmissionFrame>();
+
+	sFramesCondition.notify_all();
+}
+
+void AkSubmissionQueue::WaitIdle()
+{
+	std::unique_lock lock(sFramesMutex);
+	sFramesCondition.wait(lock, []() { return sPendingFrames.empty() && !sIsProcessing; });
+}
+
+std::mutex& AkSubmissionQueue::GetPresentMutex()
+{
+	return sPresentMutex;
+}
+
+void AkSubmissionQueue::SubmitThread()
+{
+	while (true)
+	{
+		std::unique_ptr<AkSubmissionFrame> frame = nullptr;
+
+		{
+			std::unique_lock lock(sFramesMutex);
+			sFramesCondition.wait(lock, []() { return sShouldExit || !sPendingFrames.empty(); });
+
+			if (sPendingFrames.empty())
+				return;
+
+			frame = std::move(sPendingFrames.front());
+			sPendingFrames.pop_front();
+			sIsProcessing = true;
+		}
+
+		ProcessFrame(*frame);
+
+		{
+			std::scoped_lock lock(sFramesMutex);
+			sFreeFrames.push_back(std::move(frame));
+			sIsProcessing = false;
+		}
+
+		sFramesCondition.notify_all();
+	}
+}
+
+void AkSubmissionQueue::ProcessFrame(AkSubmissionFrame& frame)
+{
+	for (const uint32_t queueIndex : frame.queueOrder)
+	{
+		AkQueueSubmission& queueSubmission = frame.queues[queueIndex];
+		queueSubmission.submitInfos.clear();
+
+		for (uint32_t i = 0; i < queueSubmission.batchCount; ++i)
+		{
+			const AkSubmitBatch& batch = queueSubmission.batches[i];
+			queueSubmission.submitInfos.push_back(
+			{
+				.waitSemaphoreInfoCount = static_cast<uint32_t>(batch.waitSemaphores.size()),
+				.pWaitSemaphoreInfos = batch.waitSemaphores.data(),
+				.commandBufferInfoCount = static_cast<uint32_t>(batch.commandBuffers.size()),
+				.pCommandBufferInfos = batch.commandBuffers.data(),
+				.signalSemaphoreInfoCount = static_cast<uint32_t>(batch.signalSemaphores.size()),
+				.pSignalSemaphoreInfos = batch.signalSemaphores.data()
+			});
+		}
+
+		try
+		{
+			GetQueue(static_cast<AkDeviceQueue>(queueIndex)).submit2KHR(queueSubmission.submitInfos, queueSubmission.fence);
+		}
+		catch (const std::exception& exception)
+		{
+			AkLogError("Failed to submit workload: {}", exception.what());
+		}
+
+		for (uint32_t i = 0; i < queueSubmission.batchCount; ++i)
+		{
+			queueSubmission.batches[i].waitSemaphores.clear();
+			queueSubmission.batches[i].commandBuffers.clear();
+			queueSubmission.batches[i].signalSemaphores.clear();
+		}
+
+		queueSubmission.batchCount = 0;
+		queueSubmission.fence = nullptr;
+	}
+
+	frame.queueOrder.clear();
+
+	const vk::Queue& graphicsQueue = AkDevice::GetGraphicsQueue();
+	for (const AkPresentRequest& presentRequest : frame.presents)
+	{
+		const vk::PresentIdKHR presentIdInfo =
+		{
+			.swapchainCount = 1,
+			.pPresentIds = &presentRequest.presentId
+		};
+
+		const vk::PresentInfoKHR presentInfo =
+		{
+			.pNext = presentRequest.presentId != 0 ? &presentIdInfo : nullptr,
+			.waitSemaphoreCount = 1,
+			.pWaitSemaphores = &presentRequest.waitSemaphore,
+			.swapchainCount = 1,
+			.pSwapchains = &presentRequest.swapchain,
+			.pImageIndices = &presentRequest.imageIndex
+		};
+
+		try
+		{
+			std::scoped_lock lock(sPresentMutex);
+			if (graphicsQueue.presentKHR(presentInfo) == vk::Result::eSuboptimalKHR)
+				*presentRequest.needsRecreation = true;
+		}
+		catch (const vk::OutOfDateKHRError&)
+		{
+			*presentRequest.needsRecreation = true;
+		}
+		catch (const std::exception& exception)
+		{
+			AkLogError("Failed to present image to screen: {}", exception.what());
+		}
+	}
+
+	frame.presents.clear();
+}
\ No newline at end of file
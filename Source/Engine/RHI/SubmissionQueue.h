@@ -0,0 +1,41 @@
+#pragma once
+#include "RHI/PipelineStates.h"
+#include "RHI/CommandBuffers/CommandBufferAllocator.h"
+
+#include <mutex>
+#include <atomic>
+
+namespace vk
+{
+	class Fence;
+	class Semaphore;
+	class SwapchainKHR;
+}
+
+// Gathers the work of a frame and hands it to a dedicated thread that merges it into one vkQueueSubmit2 per queue and presents,
+// so the thread producing frames never blocks inside the driver submit or present paths.
+class AkSubmissionQueue
+{
+public:
+	static bool Initialize();
+	static void Deinitialize();
+
+	// Recording a frame is only allowed from a single thread, the frame is handed to the submit thread on Flush
+	static void Wait(const AkDeviceQueue deviceQueue, const vk::Semaphore& semaphore, const AkSubresourceState& firstUse);
+	static void Submit(const AkDeviceQueue deviceQueue, AkCommandBuffer* commandBuffer);
+	static void Signal(const AkDeviceQueue deviceQueue, const vk::Semaphore& semaphore);
+	static void Signal(const AkDeviceQueue deviceQueue, const vk::Fence& fence);
+	// A non zero present id is attached through VK_KHR_present_id, so the present can be waited on
+	static void Present(const vk::SwapchainKHR& swapchain, const uint32_t imageIndex, const vk::Semaphore& waitSemaphore, std::atomic<bool>& outNeedsRecreation, const uint64_t presentId = 0);
+	static void Flush();
+
+	// Blocks until every flushed frame has been submitted and presented
+	static void WaitIdle();
+
+	// Acquiring and presenting both require exclusive access to the swapchain
+	static std::mutex& GetPresentMutex();
+
+private:
+	static void SubmitThread();
+	static void ProcessFrame(struct AkSubmissionFrame& frame);
+};
\ No newline at end of file
@@ -2,31 +2,47 @@
 #include "Core/Log.h"
 #include "Platform/Window.h"
 #include "RHI/Device.h"
+#include "RHI/SubmissionQueue.h"
+#include "RHI/VulkanPipelineStates.h"
+#include "RHI/DeferredDestruction.h"
 #include "RHI/Textures/Texture.h"
+#include "RHI/Textures/TextureReadback.h"
+#include "RHI/CommandBuffers/CommandBufferCache.h"
 
+#include <algorithm>
 #include <glm/vec2.hpp>
+#include <glm/common.hpp>
 #include <vulkan/vulkan.hpp>
 #include <SDL3/SDL_vulkan.h>
 
-AkPixelFormat GetAkPixelFormat(const vk::Format format)
+static vk::PresentModeKHR GetVkPresentMode(const AkPresentMode presentMode)
 {
-	switch (format)
+	switch (presentMode)
 	{
-		case vk::Format::eR8G8B8A8Unorm:			return AkPixelFormat::RGBA8_UNORM;
-		case vk::Format::eR8G8B8A8Srgb:				return AkPixelFormat::RGBA8_SRGB;
-		case vk::Format::eB8G8R8A8Unorm:			return AkPixelFormat::BGRA8_UNORM;
-		case vk::Format::eB8G8R8A8Srgb:				return AkPixelFormat::BGRA8_SRGB;
-		case vk::Format::eA2B10G10R10UnormPack32:	return AkPixelFormat::R10G10B10A2_UNORM;
+		case AkPresentMode::IMMEDIATE:		return vk::PresentModeKHR::eImmediate;
+		case AkPresentMode::MAILBOX:		return vk::PresentModeKHR::eMailbox;
+		case AkPresentMode::FIFO:			return vk::PresentModeKHR::eFifo;
+		case AkPresentMode::FIFO_RELAXED:	return vk::PresentModeKHR::eFifoRelaxed;
 
 		default:
-			AkLogCritical("Vulkan format not registered on this function");
-			return AkPixelFormat::UNDEFINED;
+			AkLogCritical("Present mode not registered on this function");
+			return vk::PresentModeKHR::eFifo;
 	}
 }
 
+struct AkBackBufferClearKey
+{
+	uint32_t backBufferIndex = 0;
+	uint32_t width = 0;
+	uint32_t height = 0;
+};
+
 struct AkSwapchainStorage
 {
+	// The implementation can create more images than requested, only the requested count is passed on recreation
+	uint32_t requestedBackBuffersCount = 1;
 	uint32_t backBuffersCount = 1;
+	uint32_t framesInFlight = 1;
 	vk::PresentModeKHR presentationMode = vk::PresentModeKHR::eFifo;
 
 	std::vector<vk::Image> backBufferImages;
@@ -37,19 +53,40 @@ struct AkSwapchainStorage
 	vk::SwapchainKHR swapchain = {};
 	glm::uvec2 swapchainExtents = {};
 
+	// A failed creation still retires the old swapchain, which then can neither be acquired from nor passed as the old one again
+	bool isSwapchainRetired = false;
+
+	// Queried again before every creation, the current extent is undefined when the swapchain decides the size of the surface
+	glm::uvec2 currentImageExtents = {};
+	glm::uvec2 minImageExtents = {};
+	glm::uvec2 maxImageExtents = {};
+	vk::ImageUsageFlags supportedImageUsage = {};
+
+	// Per frame in flight
 	std::vector<vk::Fence> fences = {};
 	std::vector<vk::Semaphore> imageAcquireSemaphores = {};
+
+	// Per back buffer, a present only waits on the semaphore of its image, so it is free again once that image is acquired
 	std::vector<vk::Semaphore> finishedRenderingSemaphores = {};
+
+	// Per frame in flight, cleared once the latency of the frame was measured
+	std::vector<uint64_t> presentIds = {};
+	std::vector<std::chrono::steady_clock::time_point> inputSampleTimes = {};
 };
 
-AkSwapchain::AkSwapchain(const std::shared_ptr<AkWindow>& window)
+AkSwapchain::AkSwapchain(const std::shared_ptr<AkWindow>& window, const AkSwapchainDescriptor& descriptor)
 {
 	m_Window = window;
 
 	if (!CreatePresentationSurface())
 		throw std::runtime_error("Failed to create AkSwapchain");
 
-	InitializePersistentData();
+	InitializePersistentData(descriptor);
+	m_CommandBufferCache = std::make_unique<AkCommandBufferCache>(AkDeviceQueue::GRAPHICS);
+
+	if (descriptor.dynamicResolution.isEnabled)
+		m_DynamicResolution = std::make_unique<AkDynamicResolution>(descriptor.dynamicResolution, m_Storage->framesInFlight);
+	m_WindowResizeCount = m_Window->GetResizeCount();
 
 	if (!CreateSwapchain())
 		throw std::runtime_error("Failed to create AkSwapchain");
@@ -59,20 +96,30 @@ AkSwapchain::AkSwapchain(const std::shared_ptr<AkWindow>& window)
 
 	if (!CreateSynchronizationPrimitives())
 		throw std::runtime_error("Failed to create AkSwapchain");
+
+	if (m_DynamicResolution && !m_DynamicResolution->Resize(m_Storage->swapchainExtents, GetAkPixelFormat(m_Storage->presentationSurfaceFormat.format)))
+		throw std::runtime_error("Failed to create AkSwapchain");
 }
 
 AkSwapchain::~AkSwapchain()
 {
+	// The device is idle by now and retired swapchains have to go before the surface they were created from
+	AkDeferredDestruction::Flush();
+
+	m_DynamicResolution.reset();
+	m_CommandBufferCache.reset();
 	m_BackBufferTextures.clear();
 
 	const vk::Device& device = AkDevice::GetDevice();
-	for (uint32_t i = 0; i < m_Storage->backBuffersCount; ++i)
+	for (uint32_t i = 0; i < m_Storage->framesInFlight; ++i)
 	{
 		device.destroyFence(m_Storage->fences[i]);
 		device.destroySemaphore(m_Storage->imageAcquireSemaphores[i]);
-		device.destroySemaphore(m_Storage->finishedRenderingSemaphores[i]);
 	}
 
+	for (const vk::Semaphore& finishedRenderingSemaphore : m_Storage->finishedRenderingSemaphores)
+		device.destroySemaphore(finishedRenderingSemaphore);
+
 	device.destroySwapchainKHR(m_Storage->swapchain);
 
 	const vk::Instance& instance = AkDevice::GetInstance();
@@ -81,117 +128,170 @@ AkSwapchain::~AkSwapchain()
 
 bool AkSwapchain::Prepare()
 {
-	const glm::uvec2& windowSize = m_Window->GetSize();
-	bool windowStateChanged = m_Window->IsMinimized();
-	windowStateChanged |= windowSize.x != m_Storage->swapchainExtents.x || windowSize.y != m_Storage->swapchainExtents.y;
+	// Nothing can be presented to a minimized window, it is recreated once restored if its size changed meanwhile
+	if (m_Window->IsMinimized())
+		return false;
 
-	if (m_NeedsRecreation || windowStateChanged)
+	if (m_NeedsRecreation || m_WindowResizeCount != m_Window->GetResizeCount())
 	{
-		const vk::PhysicalDevice& physicalDevice = AkDevice::GetPhysicalDevice();
-		const vk::SurfaceCapabilitiesKHR& surfaceCapabilities = physicalDevice.getSurfaceCapabilitiesKHR(m_Storage->presentationSurface);
-		if (surfaceCapabilities.maxImageExtent.width == 0 || surfaceCapabilities.maxImageExtent.height == 0)
+		if (!RecreateSwapchain())
 			return false;
-
-		if (!CreateSwapchain())
-			return false;
-
-		if (!CreateBackBuffersRenderTargets())
-			return false;
-
-		m_NeedsRecreation = false;
 	}
 
+	// The acquire semaphore of this frame is only free again once its last submission completed
 	try
 	{
 		const vk::Device& device = AkDevice::GetDevice();
 		device.waitForFences(m_Storage->fences[m_CurrentFrameIndex], true, UINT64_MAX);
-		device.resetFences(m_Storage->fences[m_CurrentFrameIndex]);
 	}
 	catch (const std::exception& exception)
 	{
-		AkLogError("Error while processing frame fence: {}", exception.what());
+		AkLogError("Error while waiting for frame fence: {}", exception.what());
 		return false;
 	}
 
+	// Nothing is submitted for a frame that failed to acquire, so the fence is only reset and the frame begun once an image is ours
 	if (!AcquireNextImageIndex())
 		return false;
 
-	return true;
-}
+	try
+	{
+		const vk::Device& device = AkDevice::GetDevice();
+		device.resetFences(m_Storage->fences[m_CurrentFrameIndex]);
+		RecordInputLatency(m_CurrentFrameIndex);
+		AkCommandBufferAllocator::BeginFrame(m_CurrentFrameIndex);
+		AkDeferredDestruction::BeginFrame();
+		AkTextureReadback::BeginFrame();
 
-#include "CommandBuffers/CommandBufferAllocator.h"
-void AkSwapchain::Present()
-{
-	static constexpr vk::PipelineStageFlags kDefaultWaitStage = vk::PipelineStageFlagBits::eBottomOfPipe;
-	const vk::Queue& graphicsQueue = AkDevice::GetGraphicsQueue();
+		if (m_DynamicResolution)
+			m_DynamicResolution->BeginFrame(m_CurrentFrameIndex);
+	}
+	catch (const std::exception& exception)
+	{
+		AkLogError("Error while processing frame fence: {}", exception.what());
+		return false;
+	}
 
 	// -- Testing it Works
-	static const std::vector<AkCommandBuffer*> commandBuffers = AkCommandBufferAllocator::AllocateCommandBuffers(AkDeviceQueue::GRAPHICS, m_Storage->backBuffersCount);
+	// Recorded before the frame command buffer, which then starts from the state the clear leaves the back buffer in
 	AkTexture* currentBackBufferTexture = m_BackBufferTextures[m_CurrentBackBufferIndex].get();
+	const AkBackBufferClearKey recordingKey = { .backBufferIndex = m_CurrentBackBufferIndex, .width = m_Storage->swapchainExtents.x, .height = m_Storage->swapchainExtents.y };
 
-	commandBuffers[m_CurrentFrameIndex]->Begin();
-	commandBuffers[m_CurrentFrameIndex]->TransitionTexture(currentBackBufferTexture, AkResourceState::UNDEFINED, AkResourceState::COPY_DESTINATION);
-	commandBuffers[m_CurrentFrameIndex]->ClearColor(currentBackBufferTexture, AkResourceState::COPY_DESTINATION, glm::vec4(0.1f, 0.2f, 0.3f, 1.f));
-	commandBuffers[m_CurrentFrameIndex]->TransitionTexture(currentBackBufferTexture, AkResourceState::COPY_DESTINATION, AkResourceState::PRESENT);
-	commandBuffers[m_CurrentFrameIndex]->End();
+	m_ClearCommandBuffer = m_CommandBufferCache->GetOrRecord(recordingKey, [currentBackBufferTexture](AkCommandBuffer* recordingCommandBuffer)
+	{
+		recordingCommandBuffer->TransitionTexture(currentBackBufferTexture, AkResourceState::UNDEFINED, AkResourceState::COPY_DESTINATION);
+		recordingCommandBuffer->ClearColor(currentBackBufferTexture, AkResourceState::COPY_DESTINATION, glm::vec4(0.1f, 0.2f, 0.3f, 1.f));
+		recordingCommandBuffer->RequireState(currentBackBufferTexture, AkResourceState::PRESENT);
+	});
 	// -- Testing it Works
 
-	const vk::SubmitInfo submitInfo =
-	{
-		.waitSemaphoreCount = 1,
-		.pWaitSemaphores = &m_Storage->imageAcquireSemaphores[m_CurrentFrameIndex],
-		.pWaitDstStageMask = &kDefaultWaitStage,
-		.commandBufferCount = 1,
-		.pCommandBuffers = &commandBuffers[m_CurrentFrameIndex]->GetBuffer(),
-		.signalSemaphoreCount = 1,
-		.pSignalSemaphores = &m_Storage->finishedRenderingSemaphores[m_CurrentFrameIndex],
-	};
+	return true;
+}
 
-	try
+void AkSwapchain::Present(AkCommandBuffer* frameCommandBuffer, const std::chrono::steady_clock::time_point inputSampleTime)
+{
+	AkTexture* currentBackBufferTexture = m_BackBufferTextures[m_CurrentBackBufferIndex].get();
+	const vk::Semaphore& imageAcquireSemaphore = m_Storage->imageAcquireSemaphores[m_CurrentFrameIndex];
+	const vk::Semaphore& finishedRenderingSemaphore = m_Storage->finishedRenderingSemaphores[m_CurrentBackBufferIndex];
+
+	// Dynamic resolution measures the GPU time of the whole frame, from before the clear to after the upscale
+	AkCommandBuffer* frameBeginCommandBuffer = nullptr;
+	AkCommandBuffer* upscaleCommandBuffer = nullptr;
+	if (m_DynamicResolution)
 	{
-		graphicsQueue.submit(submitInfo, m_Storage->fences[m_CurrentFrameIndex]);
+		frameBeginCommandBuffer = AkCommandBufferAllocator::AllocateCommandBuffer(AkDeviceQueue::GRAPHICS);
+		if (frameBeginCommandBuffer)
+		{
+			frameBeginCommandBuffer->Begin();
+			m_DynamicResolution->RecordFrameBegin(frameBeginCommandBuffer, m_CurrentFrameIndex);
+			frameBeginCommandBuffer->End();
+		}
+
+		upscaleCommandBuffer = AkCommandBufferAllocator::AllocateCommandBuffer(AkDeviceQueue::GRAPHICS);
+		if (upscaleCommandBuffer)
+		{
+			upscaleCommandBuffer->Begin();
+			m_DynamicResolution->RecordUpscale(upscaleCommandBuffer, currentBackBufferTexture, m_CurrentFrameIndex);
+			upscaleCommandBuffer->End();
+		}
 	}
-	catch (const std::exception& exception)
-	{
-		AkLogError("Failed to submit workload: {}", exception.what());
+
+	AkSubmissionQueue::Wait(AkDeviceQueue::GRAPHICS, imageAcquireSemaphore, { AkResourceState::COPY_DESTINATION });
+	if (frameBeginCommandBuffer)
+		AkSubmissionQueue::Submit(AkDeviceQueue::GRAPHICS, frameBeginCommandBuffer);
+
+	// Only valid for the image acquired by the last Prepare
+	if (AkCommandBuffer* clearCommandBuffer = std::exchange(m_ClearCommandBuffer, nullptr))
+		AkSubmissionQueue::Submit(AkDeviceQueue::GRAPHICS, clearCommandBuffer);
+
+	if (frameCommandBuffer)
+		AkSubmissionQueue::Submit(AkDeviceQueue::GRAPHICS, frameCommandBuffer);
+
+	if (upscaleCommandBuffer)
+		AkSubmissionQueue::Submit(AkDeviceQueue::GRAPHICS, upscaleCommandBuffer);
+
+	AkSubmissionQueue::Signal(AkDeviceQueue::GRAPHICS, finishedRenderingSemaphore);
+	AkSubmissionQueue::Signal(AkDeviceQueue::GRAPHICS, m_Storage->fences[m_CurrentFrameIndex]);
+	m_Storage->presentIds[m_CurrentFrameIndex] = AkDevice::SupportsPresentWait() ? ++m_NextPresentId : 0;
+	m_Storage->inputSampleTimes[m_CurrentFrameIndex] = inputSampleTime;
+
+	AkSubmissionQueue::Present(m_Storage->swapchain, m_CurrentBackBufferIndex, finishedRenderingSemaphore, m_NeedsRecreation, m_Storage->presentIds[m_CurrentFrameIndex]);
+	AkSubmissionQueue::Flush();
+
+	m_CurrentFrameIndex = (m_CurrentFrameIndex + 1) % m_Storage->framesInFlight;
+}
+
+void AkSwapchain::WaitForPresentLatency()
+{
+	static constexpr uint64_t kLatencyWaitTimeout = 100'000'000;
+
+	const uint32_t previousFrameIndex = (m_CurrentFrameIndex + m_Storage->framesInFlight - 1) % m_Storage->framesInFlight;
+	if (m_Storage->inputSampleTimes[previousFrameIndex] == std::chrono::steady_clock::time_point{})
 		return;
-	}
 
-	const vk::PresentInfoKHR presentInfo =
-	{
-		.waitSemaphoreCount = 1,
-		.pWaitSemaphores = &m_Storage->finishedRenderingSemaphores[m_CurrentFrameIndex],
-		.swapchainCount = 1,
-		.pSwapchains = &m_Storage->swapchain,
-		.pImageIndices = &m_CurrentBackBufferIndex
-	};
+	// The wait needs exclusive access to the swapchain, so the present it waits for must have left the submission thread first
+	AkSubmissionQueue::WaitIdle();
 
 	try
 	{
-		switch (graphicsQueue.presentKHR(presentInfo))
-		{
-			default:
-			case vk::Result::eSuccess:
-				break;
-			case vk::Result::eSuboptimalKHR:
-			case vk::Result::eErrorOutOfDateKHR:
-			{
-				const vk::PhysicalDevice& physicalDevice = AkDevice::GetPhysicalDevice();
-				const vk::SurfaceCapabilitiesKHR& surfaceCapabilities = physicalDevice.getSurfaceCapabilitiesKHR(m_Storage->presentationSurface);
-				if (surfaceCapabilities.maxImageExtent.width == 0 || surfaceCapabilities.maxImageExtent.height == 0)
-					break;
+		const vk::Device& device = AkDevice::GetDevice();
+		const uint64_t presentId = m_Storage->presentIds[previousFrameIndex];
 
-				m_NeedsRecreation = true;
-				break;
-			}
-		}
+		std::scoped_lock lock(AkSubmissionQueue::GetPresentMutex());
+		const vk::Result result = presentId != 0 ?
+			device.waitForPresentKHR(m_Storage->swapchain, presentId, kLatencyWaitTimeout) :
+			device.waitForFences(m_Storage->fences[previousFrameIndex], true, kLatencyWaitTimeout);
+
+		if (result == vk::Result::eTimeout)
+			return;
+	}
+	catch (const vk::OutOfDateKHRError&)
+	{
+		m_NeedsRecreation = true;
+		return;
 	}
 	catch (const std::exception& exception)
 	{
-		AkLogError("Failed to present image to screen: {}", exception.what());
+		AkLogError("Failed to wait for frame presentation: {}", exception.what());
+		return;
 	}
 
-	m_CurrentFrameIndex = (m_CurrentFrameIndex + 1) % m_Storage->backBuffersCount;
+	RecordInputLatency(previousFrameIndex);
+}
+
+AkTexture* AkSwapchain::GetCurrentBackBuffer() const
+{
+	return m_BackBufferTextures[m_CurrentBackBufferIndex].get();
+}
+
+AkTexture* AkSwapchain::GetRenderTarget() const
+{
+	return m_DynamicResolution ? m_DynamicResolution->GetRenderTarget() : GetCurrentBackBuffer();
+}
+
+glm::uvec2 AkSwapchain::GetRenderSize() const
+{
+	return m_DynamicResolution ? m_DynamicResolution->GetRenderSize() : m_Storage->swapchainExtents;
 }
 
 bool AkSwapchain::CreatePresentationSurface()
@@ -207,7 +307,7 @@ bool AkSwapchain::CreatePresentationSurface()
 	return true;
 }
 
-void AkSwapchain::InitializePersistentData()
+void AkSwapchain::InitializePersistentData(const AkSwapchainDescriptor& descriptor)
 {
 	const vk::PhysicalDevice& physicalDevice = AkDevice::GetPhysicalDevice();
 	const vk::SurfaceCapabilitiesKHR surfaceCapabilities = physicalDevice.getSurfaceCapabilitiesKHR(m_Storage->presentationSurface);
@@ -215,9 +315,9 @@ void AkSwapchain::InitializePersistentData()
 	const std::vector<vk::PresentModeKHR> surfacePresentModes = physicalDevice.getSurfacePresentModesKHR(m_Storage->presentationSurface);
 
 	//Get the number of backbuffer images to create
-	m_Storage->backBuffersCount = surfaceCapabilities.minImageCount + 1;
-	if (surfaceCapabilities.maxImageCount > 0 && m_Storage->backBuffersCount > surfaceCapabilities.maxImageCount)
-		m_Storage->backBuffersCount = surfaceCapabilities.maxImageCount;
+	m_Storage->requestedBackBuffersCount = surfaceCapabilities.minImageCount + 1;
+	if (surfaceCapabilities.maxImageCount > 0 && m_Storage->requestedBackBuffersCount > surfaceCapabilities.maxImageCount)
+		m_Storage->requestedBackBuffersCount = surfaceCapabilities.maxImageCount;
 
 	//There is no preference for surface format
 	if (surfaceFormats.size() == 1 && surfaceFormats[0].format == vk::Format::eUndefined)
@@ -235,80 +335,127 @@ void AkSwapchain::InitializePersistentData()
 		}
 	}
 
-	auto SelectBestVSyncMode = [surfacePresentModes]()
+	//Select presentation mode
+	m_Storage->presentationMode = GetVkPresentMode(descriptor.presentMode);
+	if (std::find(surfacePresentModes.begin(), surfacePresentModes.end(), m_Storage->presentationMode) == surfacePresentModes.end())
 	{
-		if (std::find(surfacePresentModes.begin(), surfacePresentModes.end(), vk::PresentModeKHR::eMailbox) != surfacePresentModes.end())
-			return vk::PresentModeKHR::eMailbox;
+		AkLogWarning("Requested present mode is not supported by the surface, falling back to FIFO");
+		m_Storage->presentationMode = vk::PresentModeKHR::eFifo;
+	}
 
-		if (std::find(surfacePresentModes.begin(), surfacePresentModes.end(), vk::PresentModeKHR::eFifo) != surfacePresentModes.end())
-			return vk::PresentModeKHR::eFifo;
+	//Resize persistent arrays
+	m_Storage->framesInFlight = std::clamp(descriptor.framesInFlight, 1u, kMaxFramesInFlight);
+	m_Storage->fences.resize(m_Storage->framesInFlight);
+	m_Storage->imageAcquireSemaphores.resize(m_Storage->framesInFlight);
+	m_Storage->presentIds.resize(m_Storage->framesInFlight);
+	m_Storage->inputSampleTimes.resize(m_Storage->framesInFlight);
+	AkCommandBufferAllocator::SetFramesInFlight(m_Storage->framesInFlight);
+	AkDeferredDestruction::SetFramesInFlight(m_Storage->framesInFlight);
+	AkTextureReadback::SetFramesInFlight(m_Storage->framesInFlight);
+}
 
-		return surfacePresentModes[0];
-	};
+bool AkSwapchain::QuerySurfaceExtents()
+{
+	try
+	{
+		const vk::PhysicalDevice& physicalDevice = AkDevice::GetPhysicalDevice();
+		const vk::SurfaceCapabilitiesKHR surfaceCapabilities = physicalDevice.getSurfaceCapabilitiesKHR(m_Storage->presentationSurface);
 
-	//Select presentation mode
-	m_Storage->presentationMode = SelectBestVSyncMode();
+		m_Storage->currentImageExtents = { surfaceCapabilities.currentExtent.width, surfaceCapabilities.currentExtent.height };
+		m_Storage->minImageExtents = { surfaceCapabilities.minImageExtent.width, surfaceCapabilities.minImageExtent.height };
+		m_Storage->maxImageExtents = { surfaceCapabilities.maxImageExtent.width, surfaceCapabilities.maxImageExtent.height };
+		m_Storage->supportedImageUsage = surfaceCapabilities.supportedUsageFlags;
+	}
+	catch (const std::exception& exception)
+	{
+		AkLogError("Failed to query surface capabilities: {}", exception.what());
+		return false;
+	}
 
-	//Resize persistent arrays
-	m_Storage->fences.resize(m_Storage->backBuffersCount);
-	m_Storage->imageAcquireSemaphores.resize(m_Storage->backBuffersCount);
-	m_Storage->finishedRenderingSemaphores.resize(m_Storage->backBuffersCount);
+	return true;
 }
 
 bool AkSwapchain::CreateSwapchain()
 {
-	const vk::Device& device = AkDevice::GetDevice();
-	const vk::PhysicalDevice& physicalDevice = AkDevice::GetPhysicalDevice();
-	const vk::SurfaceCapabilitiesKHR surfaceCapabilities = physicalDevice.getSurfaceCapabilitiesKHR(m_Storage->presentationSurface);
+	if (!QuerySurfaceExtents())
+		return false;
+
+	glm::uvec2 swapchainExtents = m_Storage->currentImageExtents;
+	if (swapchainExtents.x == UINT32_MAX && swapchainExtents.y == UINT32_MAX)
+		swapchainExtents = glm::clamp(m_Window->GetSize(), m_Storage->minImageExtents, m_Storage->maxImageExtents);
+
+	if (swapchainExtents.x == 0 || swapchainExtents.y == 0)
+		return false;
+
+	// Copying out of the back buffer is only needed for readbacks, which are unavailable on surfaces that do not support it
+	const vk::ImageUsageFlags imageUsage = vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eSampled | vk::ImageUsageFlagBits::eTransferDst
+		| (m_Storage->supportedImageUsage & vk::ImageUsageFlagBits::eTransferSrc);
 
 	const vk::SwapchainCreateInfoKHR swapchainCreateInfo =
 	{
 		.surface = m_Storage->presentationSurface,
-		.minImageCount = m_Storage->backBuffersCount,
+		.minImageCount = m_Storage->requestedBackBuffersCount,
 		.imageFormat = m_Storage->presentationSurfaceFormat.format,
 		.imageColorSpace = m_Storage->presentationSurfaceFormat.colorSpace,
-		.imageExtent = { surfaceCapabilities.maxImageExtent.width, surfaceCapabilities.maxImageExtent.height },
+		.imageExtent = { swapchainExtents.x, swapchainExtents.y },
 		.imageArrayLayers = 1,
-		.imageUsage = vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eSampled | vk::ImageUsageFlagBits::eTransferDst,
+		.imageUsage = imageUsage,
 		.presentMode = m_Storage->presentationMode,
-		.oldSwapchain = m_Storage->swapchain
+		.oldSwapchain = m_Storage->isSwapchainRetired ? nullptr : m_Storage->swapchain
 	};
 
+	// The current swapchain is only replaced once the new one and its images exist, the caller releases the old one
+	const vk::Device& device = AkDevice::GetDevice();
+	vk::SwapchainKHR swapchain = nullptr;
 	try
 	{
-		vk::SwapchainKHR oldSwapchain = m_Storage->swapchain;
-
-		m_Storage->swapchain = device.createSwapchainKHR(swapchainCreateInfo);
-		m_Storage->backBufferImages = device.getSwapchainImagesKHR(m_Storage->swapchain);
-		m_Storage->swapchainExtents = { surfaceCapabilities.maxImageExtent.width, surfaceCapabilities.maxImageExtent.height };
-
-		device.destroySwapchainKHR(oldSwapchain);
+		swapchain = device.createSwapchainKHR(swapchainCreateInfo);
+		m_Storage->backBufferImages = device.getSwapchainImagesKHR(swapchain);
 	}
 	catch (const std::exception& exception)
 	{
+		if (swapchain)
+			device.destroySwapchainKHR(swapchain);
+
+		m_Storage->isSwapchainRetired = static_cast<bool>(m_Storage->swapchain);
 		AkLogError("Failed to create swapchain: {}", exception.what());
 		return false;
 	}
 
+	m_Storage->swapchain = swapchain;
+	m_Storage->isSwapchainRetired = false;
+	m_Storage->backBuffersCount = static_cast<uint32_t>(m_Storage->backBufferImages.size());
+	m_Storage->swapchainExtents = swapchainExtents;
 	return true;
 }
 
 bool AkSwapchain::CreateBackBuffersRenderTargets()
 {
 	m_BackBufferTextures.clear();
+
+	// The flags mirror the usage the swapchain images were created with, readbacks reject back buffers that can not be copied from
+	AkTextureFlags flags = AkTextureFlags_DEFAULT_RT | AkTextureFlags_COPY_DESTINATION;
+	if (m_Storage->supportedImageUsage & vk::ImageUsageFlagBits::eTransferSrc)
+		flags |= AkTextureFlags_COPY_SOURCE;
+
 	const AkTextureDescriptor descriptor =
 	{
 		.width = m_Storage->swapchainExtents.x,
 		.height = m_Storage->swapchainExtents.y,
-		.flags = AkTextureFlags_DEFAULT_RT,
+		.flags = flags,
 		.format = GetAkPixelFormat(m_Storage->presentationSurfaceFormat.format)
 	};
 
+	// The implementation can hand out more images than requested, every one of them needs its own semaphore
+	const vk::Device& device = AkDevice::GetDevice();
 	for (uint32_t i = 0; i < m_Storage->backBuffersCount; ++i)
 	{
 		try
 		{
 			m_BackBufferTextures.push_back(std::make_unique<AkTexture>(descriptor, m_Storage->backBufferImages[i]));
+
+			if (i >= m_Storage->finishedRenderingSemaphores.size())
+				m_Storage->finishedRenderingSemaphores.push_back(device.createSemaphore({}));
 		}
 		catch (const std::exception& exception)
 		{
@@ -326,13 +473,12 @@ bool AkSwapchain::CreateSynchronizationPrimitives()
 	const vk::SemaphoreCreateInfo semaphoreCreateInfo = { };
 	const vk::FenceCreateInfo fenceCreateInfo = { .flags = vk::FenceCreateFlagBits::eSignaled };
 
-	for (uint32_t i = 0; i < m_Storage->backBuffersCount; ++i)
+	for (uint32_t i = 0; i < m_Storage->framesInFlight; ++i)
 	{
 		try
 		{
 			m_Storage->fences[i] = device.createFence(fenceCreateInfo);
 			m_Storage->imageAcquireSemaphores[i] = device.createSemaphore(semaphoreCreateInfo);
-			m_Storage->finishedRenderingSemaphores[i] = device.createSemaphore(semaphoreCreateInfo);
 		}
 		catch (const std::exception& exception)
 		{
@@ -344,29 +490,121 @@ bool AkSwapchain::CreateSynchronizationPrimitives()
 	return true;
 }
 
+bool AkSwapchain::RecreateSwapchain()
+{
+	// Drains the presents still queued for the old swapchain, this only waits for the submission thread and not for the GPU
+	AkSubmissionQueue::WaitIdle();
+
+	// Any failure flags the swapchain again, so the next Prepare retries instead of acquiring from a swapchain that is gone
+	m_NeedsRecreation = false;
+	const uint32_t windowResizeCount = m_Window->GetResizeCount();
+	const auto onFailure = [this]()
+	{
+		m_NeedsRecreation = true;
+		return false;
+	};
+
+	// Nothing renders to a retired swapchain anymore once the GPU is idle, it is destroyed before creating one from scratch
+	if (m_Storage->isSwapchainRetired)
+	{
+		AkDevice::WaitIdle();
+		m_BackBufferTextures.clear();
+
+		const vk::Device& device = AkDevice::GetDevice();
+		for (const vk::Semaphore& finishedRenderingSemaphore : m_Storage->finishedRenderingSemaphores)
+			device.destroySemaphore(finishedRenderingSemaphore);
+
+		device.destroySwapchainKHR(m_Storage->swapchain);
+		m_Storage->finishedRenderingSemaphores.clear();
+		m_Storage->swapchain = nullptr;
+		m_Storage->isSwapchainRetired = false;
+	}
+
+	std::unique_ptr<AkCommandBufferCache> commandBufferCache = nullptr;
+	try
+	{
+		commandBufferCache = std::make_unique<AkCommandBufferCache>(AkDeviceQueue::GRAPHICS);
+	}
+	catch (const std::exception& exception)
+	{
+		AkLogError("Failed to recreate swapchain: {}", exception.what());
+		return onFailure();
+	}
+
+	const vk::SwapchainKHR retiredSwapchain = m_Storage->swapchain;
+	{
+		std::scoped_lock lock(AkSubmissionQueue::GetPresentMutex());
+		if (!CreateSwapchain())
+			return onFailure();
+	}
+
+	// Present ids belong to the retired swapchain
+	std::fill(m_Storage->presentIds.begin(), m_Storage->presentIds.end(), 0);
+
+	// The frames in flight may still render to the retired back buffers, so they are only released once those frames completed
+	std::vector<vk::Semaphore> retiredSemaphores = std::exchange(m_Storage->finishedRenderingSemaphores, {});
+	std::vector<std::unique_ptr<AkTexture>> retiredBackBufferTextures = std::exchange(m_BackBufferTextures, {});
+	std::unique_ptr<AkCommandBufferCache> retiredCommandBufferCache = std::exchange(m_CommandBufferCache, std::move(commandBufferCache));
+
+	AkDeferredDestruction::Enqueue([retiredSwapchain, retiredSemaphores = std::move(retiredSemaphores), retiredBackBufferTextures = std::move(retiredBackBufferTextures), retiredCommandBufferCache = std::move(retiredCommandBufferCache)]() mutable
+	{
+		retiredCommandBufferCache.reset();
+		retiredBackBufferTextures.clear();
+
+		const vk::Device& device = AkDevice::GetDevice();
+		for (const vk::Semaphore& retiredSemaphore : retiredSemaphores)
+			device.destroySemaphore(retiredSemaphore);
+
+		device.destroySwapchainKHR(retiredSwapchain);
+	});
+
+	// The new swapchain is valid from here, a failure below recreates it again with this one as the old swapchain
+	if (!CreateBackBuffersRenderTargets())
+		return onFailure();
+
+	if (m_DynamicResolution && !m_DynamicResolution->Resize(m_Storage->swapchainExtents, GetAkPixelFormat(m_Storage->presentationSurfaceFormat.format)))
+		return onFailure();
+
+	m_WindowResizeCount = windowResizeCount;
+	return true;
+}
+
 bool AkSwapchain::AcquireNextImageIndex()
 {
+	// Presenting happens on the submission thread, so the swapchain is only held for short attempts to never stall it
+	static constexpr uint64_t kAcquireAttemptTimeout = 1'000'000;
 	const vk::Device& device = AkDevice::GetDevice();
 
-	vk::ResultValue result = device.acquireNextImageKHR(m_Storage->swapchain, UINT64_MAX, m_Storage->imageAcquireSemaphores[m_CurrentFrameIndex]);
-	m_CurrentBackBufferIndex = result.has_value() ? result.value : UINT32_MAX;
+	vk::ResultValue<uint32_t> result(vk::Result::eNotReady, UINT32_MAX);
+	while (result.result == vk::Result::eNotReady || result.result == vk::Result::eTimeout)
+	{
+		try
+		{
+			std::scoped_lock lock(AkSubmissionQueue::GetPresentMutex());
+			result = device.acquireNextImageKHR(m_Storage->swapchain, kAcquireAttemptTimeout, m_Storage->imageAcquireSemaphores[m_CurrentFrameIndex]);
+		}
+		catch (const vk::OutOfDateKHRError&)
+		{
+			result.result = vk::Result::eErrorOutOfDateKHR;
+		}
+	}
+
+	m_CurrentBackBufferIndex = result.result == vk::Result::eSuccess || result.result == vk::Result::eSuboptimalKHR ? result.value : UINT32_MAX;
 
 	switch (result.result)
 	{
 		case vk::Result::eSuccess:
 			break;
 		case vk::Result::eSuboptimalKHR:
+		{
+			// The image was acquired and its semaphore will be signaled, so it is still rendered and the swapchain recreated next frame
+			m_NeedsRecreation = true;
+			break;
+		}
 		case vk::Result::eErrorOutOfDateKHR:
 		{
-			const vk::PhysicalDevice& physicalDevice = AkDevice::GetPhysicalDevice();
-			const vk::SurfaceCapabilitiesKHR& surfaceCapabilities = physicalDevice.getSurfaceCapabilitiesKHR(m_Storage->presentationSurface);
-			if (surfaceCapabilities.maxImageExtent.width == 0 || surfaceCapabilities.maxImageExtent.height == 0)
-				return false;
-
-			if (!CreateSwapchain())
-				return false;
-
-			if (!CreateBackBuffersRenderTargets())
+			m_NeedsRecreation = true;
+			if (!RecreateSwapchain())
 				return false;
 
 			return AcquireNextImageIndex();
@@ -380,4 +618,14 @@ bool AkSwapchain::AcquireNextImageIndex()
 	}
 
 	return true;
+}
+
+void AkSwapchain::RecordInputLatency(const uint32_t frameIndex)
+{
+	std::chrono::steady_clock::time_point& inputSampleTime = m_Storage->inputSampleTimes[frameIndex];
+	if (inputSampleTime == std::chrono::steady_clock::time_point{})
+		return;
+
+	m_InputLatency = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - inputSampleTime).count();
+	inputSampleTime = {};
 }
\ No newline at end of file
@@ -1,32 +1,84 @@
 #pragma once
+#include "RHI/DynamicResolution.h"
 #include "Utilities/ForwardStorage.h"
 
+#include <atomic>
+#include <chrono>
 #include <memory>
 #include <vector>
 
+enum class AkPresentMode
+{
+	IMMEDIATE,
+	MAILBOX,
+	FIFO,
+	FIFO_RELAXED
+};
+
+struct AkSwapchainDescriptor
+{
+	// Falls back to FIFO, the only mode every surface supports, when the requested one is not available
+	AkPresentMode presentMode = AkPresentMode::MAILBOX;
+
+	// Frames the CPU can record ahead of the GPU, independent from the number of swapchain images
+	uint32_t framesInFlight = 2;
+
+	AkDynamicResolutionDescriptor dynamicResolution = {};
+};
+
 class AkSwapchain
 {
 public:
-	AkSwapchain(const std::shared_ptr<class AkWindow>& window);
+	static constexpr uint32_t kMaxFramesInFlight = 3;
+
+	AkSwapchain(const std::shared_ptr<class AkWindow>& window, const AkSwapchainDescriptor& descriptor = {});
 	~AkSwapchain();
 
 	bool Prepare();
-	void Present();
+
+	// The frame command buffer runs after the back buffer clear, which Prepare records, and must leave the render target in the PRESENT state when it is the back buffer.
+	// With dynamic resolution the render target is upscaled into the back buffer after it.
+	void Present(class AkCommandBuffer* frameCommandBuffer = nullptr, const std::chrono::steady_clock::time_point inputSampleTime = {});
+
+	// Blocks until the last presented frame reached the display, or finished on the GPU without VK_KHR_present_wait.
+	// Must not run concurrently with Prepare or Present, frames already handed to the submission thread are drained first.
+	void WaitForPresentLatency();
+
+	// Milliseconds from sampling the input of the last measured frame to it being presented
+	float GetInputLatency() const { return m_InputLatency; }
+
+	class AkTexture* GetCurrentBackBuffer() const;
+
+	// The internal render target with dynamic resolution, only its top left region of the render size is presented
+	class AkTexture* GetRenderTarget() const;
+	glm::uvec2 GetRenderSize() const;
+
+	float GetRenderScale() const { return m_DynamicResolution ? m_DynamicResolution->GetScale() : 1.f; }
+	float GetGpuTime() const { return m_DynamicResolution ? m_DynamicResolution->GetGpuTime() : 0.f; }
 
 private:
-	bool m_NeedsRecreation = false;
+	std::atomic<bool> m_NeedsRecreation = false;
+	std::atomic<float> m_InputLatency = 0.f;
+	uint64_t m_NextPresentId = 0;
 	uint8_t m_CurrentFrameIndex = 0;
 	uint32_t m_CurrentBackBufferIndex = 0;
+	uint32_t m_WindowResizeCount = 0;
 
 	std::shared_ptr<class AkWindow> m_Window = nullptr;
-	ForwardStorage<struct AkSwapchainStorage, 168> m_Storage;
+	ForwardStorage<struct AkSwapchainStorage, 256> m_Storage;
 	std::vector<std::unique_ptr<class AkTexture>> m_BackBufferTextures;
+	std::unique_ptr<class AkCommandBufferCache> m_CommandBufferCache = nullptr;
+	class AkCommandBuffer* m_ClearCommandBuffer = nullptr;
+	std::unique_ptr<AkDynamicResolution> m_DynamicResolution = nullptr;
 
 	bool CreatePresentationSurface();
-	void InitializePersistentData();
+	void InitializePersistentData(const AkSwapchainDescriptor& descriptor);
+	bool QuerySurfaceExtents();
 	bool CreateSwapchain();
 	bool CreateBackBuffersRenderTargets();
 	bool CreateSynchronizationPrimitives();
+	bool RecreateSwapchain();
 
 	bool AcquireNextImageIndex();
+	void RecordInputLatency(const uint32_t frameIndex);
 };
\ No newline at end of file
@@ -0,0 +1,271 @@
+#include "BlockCompression.h"
+#include "BlockCompressionKernels.h"
+#include "Core/Log.h"
+#include "Core/JobSystem.h"
+
+#include <chrono>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+struct AkBlockEncoders
+{
+	AkBlockEncodeFunction bc1 = nullptr;
+	AkBlockEncodeFunction bc3 = nullptr;
+	AkBlockEncodeFunction bc4 = nullptr;
+	AkBlockEncodeFunction bc5 = nullptr;
+	AkBlockEncodeFunction bc7 = nullptr;
+};
+
+static constexpr AkBlockEncoders kScalarEncoders = { &EncodeBC1BlockScalar, &EncodeBC3BlockScalar, &EncodeBC4BlockScalar, &EncodeBC5BlockScalar, &EncodeBC7BlockScalar };
+static constexpr AkBlockEncoders kSseEncoders = { &EncodeBC1BlockSse, &EncodeBC3BlockSse, &EncodeBC4BlockSse, &EncodeBC5BlockSse, &EncodeBC7BlockSse };
+static constexpr AkBlockEncoders kAvx2Encoders = { &EncodeBC1BlockAvx2, &EncodeBC3BlockAvx2, &EncodeBC4BlockAvx2, &EncodeBC5BlockAvx2, &EncodeBC7BlockAvx2 };
+
+static AkBlockBounds ComputeBoundsScalar(const uint8_t* pixels)
+{
+	AkBlockBounds bounds = { .min = { 255, 255, 255, 255 } };
+	for (uint32_t i = 0; i < 64; ++i)
+	{
+		bounds.min[i % 4] = std::min(bounds.min[i % 4], pixels[i]);
+		bounds.max[i % 4] = std::max(bounds.max[i % 4], pixels[i]);
+	}
+
+	return bounds;
+}
+
+// Channels are centered on their bounds at twice the scale, so the center stays integer
+static void ComputeGreenCovarianceScalar(const uint8_t* pixels, const AkBlockBounds& bounds, int32_t outCovariance[4])
+{
+	for (uint32_t channel = 0; channel < 4; ++channel)
+	{
+		outCovariance[channel] = 0;
+		for (uint32_t i = 0; i < 16; ++i)
+		{
+			const int32_t centered = 2 * pixels[i * 4 + channel] - (bounds.min[channel] + bounds.max[channel]);
+			const int32_t centeredGreen = 2 * pixels[i * 4 + 1] - (bounds.min[1] + bounds.max[1]);
+			outCovariance[channel] += centered * centeredGreen;
+		}
+	}
+}
+
+static void ComputeLinearIndicesScalar(const uint8_t* pixels, const AkBlockAxis& axis, uint8_t outIndices[16])
+{
+	for (uint32_t i = 0; i < 16; ++i)
+	{
+		int32_t dot = 0;
+		for (uint32_t channel = 0; channel < 4; ++channel)
+			dot += pixels[i * 4 + channel] * axis.direction[channel];
+
+		const int32_t projection = (dot - axis.base) * axis.scale;
+
+		outIndices[i] = 0;
+		for (uint32_t threshold = 0; threshold < axis.thresholdCount; ++threshold)
+			outIndices[i] += projection > axis.thresholds[threshold] ? 1 : 0;
+	}
+}
+
+static void EncodeBC4ChannelScalar(const uint8_t* pixels, const uint32_t channel, uint8_t* destination)
+{
+	uint8_t minimum = 255;
+	uint8_t maximum = 0;
+	for (uint32_t i = 0; i < 16; ++i)
+	{
+		minimum = std::min(minimum, pixels[i * 4 + channel]);
+		maximum = std::max(maximum, pixels[i * 4 + channel]);
+	}
+
+	const AkBC4Endpoints endpoints = ComputeBC4Endpoints(minimum, maximum);
+
+	uint8_t indices[16] = {};
+	for (uint32_t i = 0; i < 16; ++i)
+	{
+		const int32_t scaled = 14 * (pixels[i * 4 + channel] - minimum);
+		for (const int16_t threshold : endpoints.thresholds)
+			indices[i] += scaled > threshold ? 1 : 0;
+	}
+
+	WriteBC4Block(endpoints, indices, destination);
+}
+
+void EncodeBC1BlockScalar(const uint8_t* pixels, uint8_t* destination)
+{
+	const AkBlockBounds bounds = ComputeBoundsScalar(pixels);
+
+	int32_t covariance[4] = {};
+	ComputeGreenCovarianceScalar(pixels, bounds, covariance);
+
+	const AkBC1Endpoints endpoints = ComputeBC1Endpoints(bounds, covariance);
+
+	uint8_t indices[16] = {};
+	ComputeLinearIndicesScalar(pixels, endpoints.axis, indices);
+	WriteBC1Block(endpoints, indices, destination);
+}
+
+void EncodeBC3BlockScalar(const uint8_t* pixels, uint8_t* destination)
+{
+	EncodeBC4ChannelScalar(pixels, 3, destination);
+	EncodeBC1BlockScalar(pixels, destination + 8);
+}
+
+void EncodeBC4BlockScalar(const uint8_t* pixels, uint8_t* destination)
+{
+	EncodeBC4ChannelScalar(pixels, 0, destination);
+}
+
+void EncodeBC5BlockScalar(const uint8_t* pixels, uint8_t* destination)
+{
+	EncodeBC4ChannelScalar(pixels, 0, destination);
+	EncodeBC4ChannelScalar(pixels, 1, destination + 8);
+}
+
+void EncodeBC7BlockScalar(const uint8_t* pixels, uint8_t* destination)
+{
+	const AkBlockBounds bounds = ComputeBoundsScalar(pixels);
+
+	int32_t covariance[4] = {};
+	ComputeGreenCovarianceScalar(pixels, bounds, covariance);
+
+	const AkBC7Endpoints endpoints = ComputeBC7Endpoints(bounds, covariance);
+
+	uint8_t indices[16] = {};
+	ComputeLinearIndicesScalar(pixels, endpoints.axis, indices);
+	WriteBC7Block(endpoints, indices, destination);
+}
+
+static bool SupportsAvx2()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+	int cpuInfo[4] = {};
+	__cpuid(cpuInfo, 0);
+	if (cpuInfo[0] < 7)
+		return false;
+
+	// The OS must also preserve the upper halves of the ymm registers
+	__cpuidex(cpuInfo, 7, 0);
+	return (cpuInfo[1] & (1 << 5)) != 0 && (_xgetbv(0) & 0x6) == 0x6;
+#else
+	return __builtin_cpu_supports("avx2");
+#endif
+}
+
+static const AkBlockEncoders& GetEncoders(const AkBlockCompressionKernel kernel)
+{
+	switch (kernel)
+	{
+		case AkBlockCompressionKernel::SSE:		return kSseEncoders;
+		case AkBlockCompressionKernel::AVX2:	return kAvx2Encoders;
+		default:								return kScalarEncoders;
+	}
+}
+
+static AkBlockEncodeFunction GetEncodeFunction(const AkBlockEncoders& encoders, const AkPixelFormat format)
+{
+	switch (format)
+	{
+		case AkPixelFormat::BC1_RGB_UNORM:
+		case AkPixelFormat::BC1_RGB_SRGB:
+		case AkPixelFormat::BC1_RGBA_UNORM:
+		case AkPixelFormat::BC1_RGBA_SRGB:
+			return encoders.bc1;
+
+		case AkPixelFormat::BC3_UNORM:
+		case AkPixelFormat::BC3_SRGB:
+			return encoders.bc3;
+
+		case AkPixelFormat::BC4_UNORM:
+			return encoders.bc4;
+
+		case AkPixelFormat::BC5_UNORM:
+			return encoders.bc5;
+
+		case AkPixelFormat::BC7_UNORM:
+		case AkPixelFormat::BC7_SRGB:
+			return encoders.bc7;
+
+		default:
+			return nullptr;
+	}
+}
+
+bool AkBlockCompressor::IsFormatSupported(const AkPixelFormat format)
+{
+	return GetEncodeFunction(kScalarEncoders, format) != nullptr;
+}
+
+AkBlockCompressionKernel AkBlockCompressor::GetBestKernel()
+{
+	// The engine is built for AVX, which includes every SSE extension the SSE kernels use
+	static const AkBlockCompressionKernel sBestKernel = SupportsAvx2() ? AkBlockCompressionKernel::AVX2 : AkBlockCompressionKernel::SSE;
+	return sBestKernel;
+}
+
+bool AkBlockCompressor::Compress(const AkBlockCompressionSource& source, const AkPixelFormat format, std::span<uint8_t> destination, const AkBlockCompressionKernel kernel, AkBlockCompressionStats* outStats)
+{
+	const AkBlockCompressionKernel resolvedKernel = kernel == AkBlockCompressionKernel::AUTO ? GetBestKernel() : kernel;
+	if (resolvedKernel == AkBlockCompressionKernel::AVX2 && !SupportsAvx2())
+	{
+		AkLogError("The CPU does not support the AVX2 block compression kernels");
+		return false;
+	}
+
+	const AkBlockEncodeFunction encodeFunction = GetEncodeFunction(GetEncoders(resolvedKernel), format);
+	if (encodeFunction == nullptr)
+	{
+		AkLogError("Block compression does not support pixel format {}", static_cast<uint32_t>(format));
+		return false;
+	}
+
+	const uint32_t rowPitch = source.rowPitch != 0 ? source.rowPitch : source.width * 4;
+	if (source.width == 0 || source.height == 0 || source.pixels.size() < static_cast<size_t>(rowPitch) * (source.height - 1) + source.width * 4)
+	{
+		AkLogError("The source pixels do not cover a {}x{} surface", source.width, source.height);
+		return false;
+	}
+
+	if (destination.size() < GetSurfaceByteSize(format, source.width, source.height))
+	{
+		AkLogError("The destination is too small for a {}x{} surface", source.width, source.height);
+		return false;
+	}
+
+	const uint32_t blockCountX = (source.width + 3) / 4;
+	const uint32_t blockCountY = (source.height + 3) / 4;
+	const size_t blockSize = GetCompressedBlockSize(format);
+	const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+	AkJobSystem::ParallelFor(blockCountY, [&](const uint32_t blockY)
+	{
+		alignas(32) uint8_t blockPixels[64];
+		uint8_t* blockDestination = destination.data() + blockY * blockCountX * blockSize;
+
+		for (uint32_t blockX = 0; blockX < blockCountX; ++blockX, blockDestination += blockSize)
+		{
+			const bool isInterior = blockX * 4 + 4 <= source.width;
+			for (uint32_t y = 0; y < 4; ++y)
+			{
+				const uint8_t* sourceRow = source.pixels.data() + std::min(blockY * 4 + y, source.height - 1) * static_cast<size_t>(rowPitch);
+				if (isInterior)
+				{
+					std::memcpy(blockPixels + y * 16, sourceRow + blockX * 16, 16);
+					continue;
+				}
+
+				for (uint32_t x = 0; x < 4; ++x)
+					std::memcpy(blockPixels + y * 16 + x * 4, sourceRow + std::min(blockX * 4 + x, source.width - 1) * 4, 4);
+			}
+
+			encodeFunction(blockPixels, blockDestination);
+		}
+	});
+
+	if (outStats != nullptr)
+	{
+		const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+		outStats->kernel = resolvedKernel;
+		outStats->milliseconds = seconds * 1000.0;
+		outStats->megapixelsPerSecond = seconds > 0.0 ? static_cast<double>(source.width) * source.height / seconds / 1'000'000.0 : 0.0;
+	}
+
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,46 @@
+#pragma once
+#include "PixelFormats.h"
+
+#include <span>
+#include <cstdint>
+
+enum class AkBlockCompressionKernel
+{
+	// Picks the widest kernel the CPU supports
+	AUTO,
+	SCALAR,
+	SSE,
+	AVX2
+};
+
+struct AkBlockCompressionSource
+{
+	// RGBA8 pixels, BC4 encodes the red channel and BC5 the red and green ones
+	std::span<const uint8_t> pixels = {};
+	uint32_t width = 0;
+	uint32_t height = 0;
+
+	// Bytes between the start of two rows, zero for tightly packed rows
+	uint32_t rowPitch = 0;
+};
+
+struct AkBlockCompressionStats
+{
+	AkBlockCompressionKernel kernel = AkBlockCompressionKernel::SCALAR;
+	double milliseconds = 0.0;
+	double megapixelsPerSecond = 0.0;
+};
+
+// Encodes RGBA8 surfaces into BC1, BC3, BC4, BC5 and BC7 on the CPU with bounding box endpoints, fast enough for textures generated at runtime.
+// BC1 is always encoded opaque and BC7 only uses mode 6, a single subset with 4 bit indices that covers RGBA.
+// Every kernel writes the exact same bytes, so the scalar one is the reference the SIMD ones are checked against.
+class AkBlockCompressor
+{
+public:
+	static bool IsFormatSupported(const AkPixelFormat format);
+	static AkBlockCompressionKernel GetBestKernel();
+
+	// The destination holds GetSurfaceByteSize bytes of the format, block rows are encoded in parallel on the job system.
+	// Blocks crossing the edges of the surface repeat its last row and column.
+	static bool Compress(const AkBlockCompressionSource& source, const AkPixelFormat format, std::span<uint8_t> destination, const AkBlockCompressionKernel kernel = AkBlockCompressionKernel::AUTO, AkBlockCompressionStats* outStats = nullptr);
+};
\ No newline at end of file
@@ -0,0 +1,197 @@
+#include "BlockCompressionKernels.h"
+
+#include <immintrin.h>
+
+// Compiled for AVX2 per function, these kernels are only picked once the CPU reported support for it.
+// Every register holds four pixels widened to 16 bits, so a block is processed in four steps instead of eight.
+struct AkAvx2Block
+{
+	__m128i pixels[4];
+	__m256i widePixels[4];
+};
+
+AK_TARGET_AVX2 static AkAvx2Block LoadBlockAvx2(const uint8_t* pixels)
+{
+	AkAvx2Block block;
+	for (uint32_t i = 0; i < 4; ++i)
+	{
+		block.pixels[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels + i * 16));
+		block.widePixels[i] = _mm256_cvtepu8_epi16(block.pixels[i]);
+	}
+
+	return block;
+}
+
+AK_TARGET_AVX2 static AkBlockBounds ComputeBoundsAvx2(const AkAvx2Block& block)
+{
+	const __m256i firstHalf = _mm256_set_m128i(block.pixels[1], block.pixels[0]);
+	const __m256i secondHalf = _mm256_set_m128i(block.pixels[3], block.pixels[2]);
+	const __m256i wideMinimum = _mm256_min_epu8(firstHalf, secondHalf);
+	const __m256i wideMaximum = _mm256_max_epu8(firstHalf, secondHalf);
+
+	__m128i minimum = _mm_min_epu8(_mm256_castsi256_si128(wideMinimum), _mm256_extracti128_si256(wideMinimum, 1));
+	__m128i maximum = _mm_max_epu8(_mm256_castsi256_si128(wideMaximum), _mm256_extracti128_si256(wideMaximum, 1));
+
+	minimum = _mm_min_epu8(minimum, _mm_shuffle_epi32(minimum, _MM_SHUFFLE(1, 0, 3, 2)));
+	minimum = _mm_min_epu8(minimum, _mm_shuffle_epi32(minimum, _MM_SHUFFLE(2, 3, 0, 1)));
+	maximum = _mm_max_epu8(maximum, _mm_shuffle_epi32(maximum, _MM_SHUFFLE(1, 0, 3, 2)));
+	maximum = _mm_max_epu8(maximum, _mm_shuffle_epi32(maximum, _MM_SHUFFLE(2, 3, 0, 1)));
+
+	AkBlockBounds bounds;
+	const int32_t packedMinimum = _mm_cvtsi128_si32(minimum);
+	const int32_t packedMaximum = _mm_cvtsi128_si32(maximum);
+	std::memcpy(bounds.min, &packedMinimum, 4);
+	std::memcpy(bounds.max, &packedMaximum, 4);
+	return bounds;
+}
+
+AK_TARGET_AVX2 static void ComputeGreenCovarianceAvx2(const AkAvx2Block& block, const AkBlockBounds& bounds, int32_t outCovariance[4])
+{
+	int64_t packedCenter = 0;
+	for (uint32_t channel = 0; channel < 4; ++channel)
+		packedCenter |= static_cast<int64_t>(bounds.min[channel] + bounds.max[channel]) << (channel * 16);
+
+	const __m256i center = _mm256_set1_epi64x(packedCenter);
+	const __m256i broadcastGreen = _mm256_setr_epi8(2, 3, 2, 3, 2, 3, 2, 3, 10, 11, 10, 11, 10, 11, 10, 11, 2, 3, 2, 3, 2, 3, 2, 3, 10, 11, 10, 11, 10, 11, 10, 11);
+	const __m256i evenLanes = _mm256_set1_epi32(0xFFFF);
+
+	__m256i redBlue = _mm256_setzero_si256();
+	__m256i greenAlpha = _mm256_setzero_si256();
+	for (const __m256i& fourPixels : block.widePixels)
+	{
+		const __m256i centered = _mm256_sub_epi16(_mm256_slli_epi16(fourPixels, 1), center);
+		const __m256i green = _mm256_shuffle_epi8(centered, broadcastGreen);
+		redBlue = _mm256_add_epi32(redBlue, _mm256_madd_epi16(centered, _mm256_and_si256(green, evenLanes)));
+		greenAlpha = _mm256_add_epi32(greenAlpha, _mm256_madd_epi16(centered, _mm256_andnot_si256(evenLanes, green)));
+	}
+
+	const __m128i redBlueHalves = _mm_add_epi32(_mm256_castsi256_si128(redBlue), _mm256_extracti128_si256(redBlue, 1));
+	const __m128i greenAlphaHalves = _mm_add_epi32(_mm256_castsi256_si128(greenAlpha), _mm256_extracti128_si256(greenAlpha, 1));
+
+	alignas(16) int32_t redBlueSums[4];
+	alignas(16) int32_t greenAlphaSums[4];
+	_mm_store_si128(reinterpret_cast<__m128i*>(redBlueSums), redBlueHalves);
+	_mm_store_si128(reinterpret_cast<__m128i*>(greenAlphaSums), greenAlphaHalves);
+
+	outCovariance[0] = redBlueSums[0] + redBlueSums[2];
+	outCovariance[1] = greenAlphaSums[0] + greenAlphaSums[2];
+	outCovariance[2] = redBlueSums[1] + redBlueSums[3];
+	outCovariance[3] = greenAlphaSums[1] + greenAlphaSums[3];
+}
+
+AK_TARGET_AVX2 static void ComputeLinearIndicesAvx2(const AkAvx2Block& block, const AkBlockAxis& axis, uint8_t outIndices[16])
+{
+	int64_t packedDirection = 0;
+	for (uint32_t channel = 0; channel < 4; ++channel)
+		packedDirection |= static_cast<int64_t>(static_cast<uint16_t>(axis.direction[channel])) << (channel * 16);
+
+	const __m256i direction = _mm256_set1_epi64x(packedDirection);
+	const __m256i base = _mm256_set1_epi32(axis.base);
+	const __m256i scale = _mm256_set1_epi32(axis.scale);
+
+	__m256i thresholds[15];
+	for (uint32_t i = 0; i < axis.thresholdCount; ++i)
+		thresholds[i] = _mm256_set1_epi32(axis.thresholds[i]);
+
+	__m256i counts[2];
+	for (uint32_t i = 0; i < 2; ++i)
+	{
+		// Horizontal adds work within 128 bit lanes, the permute restores the pixel order
+		const __m256i firstDots = _mm256_madd_epi16(block.widePixels[i * 2], direction);
+		const __m256i secondDots = _mm256_madd_epi16(block.widePixels[i * 2 + 1], direction);
+		const __m256i dots = _mm256_permute4x64_epi64(_mm256_hadd_epi32(firstDots, secondDots), _MM_SHUFFLE(3, 1, 2, 0));
+		const __m256i projection = _mm256_mullo_epi32(_mm256_sub_epi32(dots, base), scale);
+
+		counts[i] = _mm256_setzero_si256();
+		for (uint32_t threshold = 0; threshold < axis.thresholdCount; ++threshold)
+			counts[i] = _mm256_sub_epi32(counts[i], _mm256_cmpgt_epi32(projection, thresholds[threshold]));
+	}
+
+	const __m256i packedCounts = _mm256_permute4x64_epi64(_mm256_packs_epi32(counts[0], counts[1]), _MM_SHUFFLE(3, 1, 2, 0));
+	const __m128i indices = _mm_packus_epi16(_mm256_castsi256_si128(packedCounts), _mm256_extracti128_si256(packedCounts, 1));
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(outIndices), indices);
+}
+
+AK_TARGET_AVX2 static void EncodeBC4ChannelAvx2(const AkAvx2Block& block, const int8_t channel, uint8_t* destination)
+{
+	const __m128i gather = _mm_setr_epi8(channel, channel + 4, channel + 8, channel + 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+	const __m128i firstHalf = _mm_unpacklo_epi32(_mm_shuffle_epi8(block.pixels[0], gather), _mm_shuffle_epi8(block.pixels[1], gather));
+	const __m128i secondHalf = _mm_unpacklo_epi32(_mm_shuffle_epi8(block.pixels[2], gather), _mm_shuffle_epi8(block.pixels[3], gather));
+	const __m128i values = _mm_unpacklo_epi64(firstHalf, secondHalf);
+
+	__m128i minimum = _mm_min_epu8(values, _mm_srli_si128(values, 8));
+	minimum = _mm_min_epu8(minimum, _mm_srli_si128(minimum, 4));
+	minimum = _mm_min_epu8(minimum, _mm_srli_si128(minimum, 2));
+	minimum = _mm_min_epu8(minimum, _mm_srli_si128(minimum, 1));
+
+	__m128i maximum = _mm_max_epu8(values, _mm_srli_si128(values, 8));
+	maximum = _mm_max_epu8(maximum, _mm_srli_si128(maximum, 4));
+	maximum = _mm_max_epu8(maximum, _mm_srli_si128(maximum, 2));
+	maximum = _mm_max_epu8(maximum, _mm_srli_si128(maximum, 1));
+
+	const AkBC4Endpoints endpoints = ComputeBC4Endpoints(static_cast<uint8_t>(_mm_cvtsi128_si32(minimum)), static_cast<uint8_t>(_mm_cvtsi128_si32(maximum)));
+
+	// All 16 values fit a single register once widened
+	const __m256i scaled = _mm256_mullo_epi16(_mm256_sub_epi16(_mm256_cvtepu8_epi16(values), _mm256_set1_epi16(endpoints.minimum)), _mm256_set1_epi16(14));
+
+	__m256i counts = _mm256_setzero_si256();
+	for (const int16_t threshold : endpoints.thresholds)
+		counts = _mm256_sub_epi16(counts, _mm256_cmpgt_epi16(scaled, _mm256_set1_epi16(threshold)));
+
+	alignas(16) uint8_t indices[16];
+	_mm_store_si128(reinterpret_cast<__m128i*>(indices), _mm_packus_epi16(_mm256_castsi256_si128(counts), _mm256_extracti128_si256(counts, 1)));
+	WriteBC4Block(endpoints, indices, destination);
+}
+
+AK_TARGET_AVX2 static void EncodeBC1ColorAvx2(const AkAvx2Block& block, uint8_t* destination)
+{
+	const AkBlockBounds bounds = ComputeBoundsAvx2(block);
+
+	int32_t covariance[4] = {};
+	ComputeGreenCovarianceAvx2(block, bounds, covariance);
+
+	const AkBC1Endpoints endpoints = ComputeBC1Endpoints(bounds, covariance);
+
+	alignas(16) uint8_t indices[16];
+	ComputeLinearIndicesAvx2(block, endpoints.axis, indices);
+	WriteBC1Block(endpoints, indices, destination);
+}
+
+AK_TARGET_AVX2 void EncodeBC1BlockAvx2(const uint8_t* pixels, uint8_t* destination)
+{
+	EncodeBC1ColorAvx2(LoadBlockAvx2(pixels), destination);
+}
+
+AK_TARGET_AVX2 void EncodeBC3BlockAvx2(const uint8_t* pixels, uint8_t* destination)
+{
+	const AkAvx2Block block = LoadBlockAvx2(pixels);
+	EncodeBC4ChannelAvx2(block, 3, destination);
+	EncodeBC1ColorAvx2(block, destination + 8);
+}
+
+AK_TARGET_AVX2 void EncodeBC4BlockAvx2(const uint8_t* pixels, uint8_t* destination)
+{
+	EncodeBC4ChannelAvx2(LoadBlockAvx2(pixels), 0, destination);
+}
+
+AK_TARGET_AVX2 void EncodeBC5BlockAvx2(const uint8_t* pixels, uint8_t* destination)
+{
+	const AkAvx2Block block = LoadBlockAvx2(pixels);
+	EncodeBC4ChannelAvx2(block, 0, destination);
+	EncodeBC4ChannelAvx2(block, 1, destination + 8);
+}
+
+AK_TARGET_AVX2 void EncodeBC7BlockAvx2(const uint8_t* pixels, uint8_t* destination)
+{
+	const AkAvx2Block block = LoadBlockAvx2(pixels);
+	const AkBlockBounds bounds = ComputeBoundsAvx2(block);
+
+	int32_t covariance[4] = {};
+	ComputeGreenCovarianceAvx2(block, bounds, covariance);
+
+	const AkBC7Endpoints endpoints = ComputeBC7Endpoints(bounds, covariance);
+
+	alignas(16) uint8_t indices[16];
+	ComputeLinearIndicesAvx2(block, endpoints.axis, indices);
+	WriteBC7Block(endpoints, indices, destination);
+}
\ No newline at end of file
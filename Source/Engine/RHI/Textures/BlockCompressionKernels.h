@@ -0,0 +1,277 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <algorithm>
+
+// Kernels only vectorize the per pixel passes, endpoints and packing are shared so every kernel writes the exact same bytes
+#if defined(_MSC_VER) && !defined(__clang__)
+#define AK_TARGET_AVX2
+#else
+#define AK_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+// A block is 16 RGBA8 pixels in row order
+using AkBlockEncodeFunction = void(*)(const uint8_t* pixels, uint8_t* destination);
+
+struct AkBlockBounds
+{
+	uint8_t min[4] = {};
+	uint8_t max[4] = {};
+};
+
+// The projection of a pixel onto the endpoint axis, scaled then compared against the thresholds, gives its index counted from the first endpoint
+struct AkBlockAxis
+{
+	int16_t direction[4] = {};
+	int32_t base = 0;
+	int32_t scale = 1;
+	uint32_t thresholdCount = 0;
+	std::array<int32_t, 15> thresholds = {};
+};
+
+struct AkBC1Endpoints
+{
+	uint16_t color0 = 0;
+	uint16_t color1 = 0;
+	AkBlockAxis axis = {};
+};
+
+struct AkBC4Endpoints
+{
+	uint8_t minimum = 0;
+	uint8_t maximum = 0;
+
+	// Compared against 14 times the distance of a value to the minimum
+	std::array<int16_t, 7> thresholds = {};
+};
+
+struct AkBC7Endpoints
+{
+	uint8_t endpoints[2][4] = {};
+	uint8_t pBits[2] = {};
+	AkBlockAxis axis = {};
+};
+
+inline constexpr std::array<int32_t, 16> kBC7Weights = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+inline uint16_t PackRGB565(const int32_t color[3])
+{
+	const int32_t red = (color[0] * 31 + 127) / 255;
+	const int32_t green = (color[1] * 63 + 127) / 255;
+	const int32_t blue = (color[2] * 31 + 127) / 255;
+	return static_cast<uint16_t>((red << 11) | (green << 5) | blue);
+}
+
+inline void UnpackRGB565(const uint16_t packed, int32_t outColor[3])
+{
+	const int32_t red = packed >> 11;
+	const int32_t green = (packed >> 5) & 63;
+	const int32_t blue = packed & 31;
+	outColor[0] = (red << 3) | (red >> 2);
+	outColor[1] = (green << 2) | (green >> 4);
+	outColor[2] = (blue << 3) | (blue >> 2);
+}
+
+// Endpoints are the bounding box inset by a share of its extent, along the diagonal that follows the sign of each channel's covariance with green
+inline void ComputeBoxEndpoints(const AkBlockBounds& bounds, const int32_t covariance[4], const uint32_t channelCount, const int32_t insetShift, int32_t outEndpoint0[4], int32_t outEndpoint1[4])
+{
+	for (uint32_t channel = 0; channel < channelCount; ++channel)
+	{
+		const int32_t inset = (bounds.max[channel] - bounds.min[channel]) >> insetShift;
+		outEndpoint0[channel] = bounds.min[channel] + inset;
+		outEndpoint1[channel] = bounds.max[channel] - inset;
+
+		if (channel != 1 && covariance[channel] < 0)
+			std::swap(outEndpoint0[channel], outEndpoint1[channel]);
+	}
+}
+
+inline void SetAxisThresholds(AkBlockAxis& axis, const int32_t endpoint0[4], const int32_t endpoint1[4])
+{
+	int32_t lengthSquared = 0;
+	axis.base = 0;
+	for (uint32_t channel = 0; channel < 4; ++channel)
+	{
+		axis.direction[channel] = static_cast<int16_t>(endpoint1[channel] - endpoint0[channel]);
+		axis.base += endpoint0[channel] * axis.direction[channel];
+		lengthSquared += axis.direction[channel] * axis.direction[channel];
+	}
+
+	// Thresholds sit halfway between two palette entries, lowered by one as kernels compare with greater than
+	if (axis.thresholdCount == 3)
+	{
+		axis.scale = 6;
+		for (uint32_t i = 0; i < 3; ++i)
+			axis.thresholds[i] = static_cast<int32_t>(2 * i + 1) * lengthSquared - 1;
+	}
+	else
+	{
+		axis.scale = 128;
+		for (uint32_t i = 0; i < 15; ++i)
+			axis.thresholds[i] = (kBC7Weights[i] + kBC7Weights[i + 1]) * lengthSquared - 1;
+	}
+}
+
+inline AkBC1Endpoints ComputeBC1Endpoints(const AkBlockBounds& bounds, const int32_t covariance[4])
+{
+	int32_t endpoint0[4] = {};
+	int32_t endpoint1[4] = {};
+	ComputeBoxEndpoints(bounds, covariance, 3, 4, endpoint0, endpoint1);
+
+	AkBC1Endpoints endpoints = {};
+	endpoints.color0 = PackRGB565(endpoint0);
+	endpoints.color1 = PackRGB565(endpoint1);
+
+	// The four color mode requires the first endpoint to be the larger one
+	if (endpoints.color0 < endpoints.color1)
+		std::swap(endpoints.color0, endpoints.color1);
+
+	UnpackRGB565(endpoints.color0, endpoint0);
+	UnpackRGB565(endpoints.color1, endpoint1);
+	endpoint0[3] = 0;
+	endpoint1[3] = 0;
+
+	endpoints.axis.thresholdCount = 3;
+	SetAxisThresholds(endpoints.axis, endpoint0, endpoint1);
+	return endpoints;
+}
+
+inline AkBC4Endpoints ComputeBC4Endpoints(const uint8_t minimum, const uint8_t maximum)
+{
+	AkBC4Endpoints endpoints = { .minimum = minimum, .maximum = maximum };
+	for (int16_t i = 0; i < 7; ++i)
+		endpoints.thresholds[i] = static_cast<int16_t>((2 * i + 1) * (maximum - minimum) - 1);
+
+	return endpoints;
+}
+
+// Mode 6 stores 7 bits per channel and a parity bit per endpoint, shared by its channels
+inline void QuantizeBC7Endpoint(const int32_t endpoint[4], uint8_t outQuantized[4], uint8_t& outPBit, int32_t outDecoded[4])
+{
+	int32_t bestError = INT32_MAX;
+	for (int32_t pBit = 0; pBit < 2; ++pBit)
+	{
+		int32_t quantized[4] = {};
+		int32_t error = 0;
+		for (uint32_t channel = 0; channel < 4; ++channel)
+		{
+			quantized[channel] = std::min((endpoint[channel] + 1 - pBit) >> 1, 127);
+			const int32_t difference = ((quantized[channel] << 1) | pBit) - endpoint[channel];
+			error += difference * difference;
+		}
+
+		if (error >= bestError)
+			continue;
+
+		bestError = error;
+		outPBit = static_cast<uint8_t>(pBit);
+		for (uint32_t channel = 0; channel < 4; ++channel)
+		{
+			outQuantized[channel] = static_cast<uint8_t>(quantized[channel]);
+			outDecoded[channel] = (quantized[channel] << 1) | pBit;
+		}
+	}
+}
+
+inline AkBC7Endpoints ComputeBC7Endpoints(const AkBlockBounds& bounds, const int32_t covariance[4])
+{
+	int32_t endpoint0[4] = {};
+	int32_t endpoint1[4] = {};
+	ComputeBoxEndpoints(bounds, covariance, 4, 5, endpoint0, endpoint1);
+
+	AkBC7Endpoints endpoints = {};
+	int32_t decoded0[4] = {};
+	int32_t decoded1[4] = {};
+	QuantizeBC7Endpoint(endpoint0, endpoints.endpoints[0], endpoints.pBits[0], decoded0);
+	QuantizeBC7Endpoint(endpoint1, endpoints.endpoints[1], endpoints.pBits[1], decoded1);
+
+	endpoints.axis.thresholdCount = 15;
+	SetAxisThresholds(endpoints.axis, decoded0, decoded1);
+	return endpoints;
+}
+
+inline void WriteBC1Block(const AkBC1Endpoints& endpoints, const uint8_t linearIndices[16], uint8_t* destination)
+{
+	// Palette entries are stored as both endpoints first, then the two interpolated ones
+	static constexpr uint8_t kIndexFromLinear[4] = { 0, 2, 3, 1 };
+
+	uint32_t indices = 0;
+	for (uint32_t i = 0; i < 16; ++i)
+		indices |= static_cast<uint32_t>(kIndexFromLinear[linearIndices[i]]) << (2 * i);
+
+	std::memcpy(destination, &endpoints.color0, 2);
+	std::memcpy(destination + 2, &endpoints.color1, 2);
+	std::memcpy(destination + 4, &indices, 4);
+}
+
+inline void WriteBC4Block(const AkBC4Endpoints& endpoints, const uint8_t linearIndices[16], uint8_t* destination)
+{
+	// With the maximum first the eight value mode is used, its palette runs maximum, minimum, then from the maximum down
+	uint64_t indices = 0;
+	for (uint32_t i = 0; i < 16; ++i)
+	{
+		const uint32_t index = (8 - linearIndices[i]) & 7;
+		indices |= static_cast<uint64_t>(index < 2 ? index ^ 1 : index) << (3 * i);
+	}
+
+	destination[0] = endpoints.maximum;
+	destination[1] = endpoints.minimum;
+	std::memcpy(destination + 2, &indices, 6);
+}
+
+inline void WriteBC7Block(const AkBC7Endpoints& endpoints, const uint8_t linearIndices[16], uint8_t* destination)
+{
+	// The index of the first pixel is stored without its top bit, the endpoints are swapped when it is set
+	const bool swapEndpoints = linearIndices[0] >= 8;
+	const uint32_t first = swapEndpoints ? 1 : 0;
+	const uint32_t second = swapEndpoints ? 0 : 1;
+
+	uint64_t bits[2] = {};
+	uint32_t offset = 0;
+	const auto writeBits = [&bits, &offset](const uint64_t value, const uint32_t count)
+	{
+		bits[offset / 64] |= value << (offset % 64);
+		if (offset % 64 + count > 64)
+			bits[offset / 64 + 1] |= value >> (64 - offset % 64);
+
+		offset += count;
+	};
+
+	writeBits(1 << 6, 7);
+	for (uint32_t channel = 0; channel < 4; ++channel)
+	{
+		writeBits(endpoints.endpoints[first][channel], 7);
+		writeBits(endpoints.endpoints[second][channel], 7);
+	}
+
+	writeBits(endpoints.pBits[first], 1);
+	writeBits(endpoints.pBits[second], 1);
+
+	for (uint32_t i = 0; i < 16; ++i)
+	{
+		const uint32_t index = swapEndpoints ? 15 - linearIndices[i] : linearIndices[i];
+		writeBits(index, i == 0 ? 3 : 4);
+	}
+
+	std::memcpy(destination, bits, 16);
+}
+
+void EncodeBC1BlockScalar(const uint8_t* pixels, uint8_t* destination);
+void EncodeBC3BlockScalar(const uint8_t* pixels, uint8_t* destination);
+void EncodeBC4BlockScalar(const uint8_t* pixels, uint8_t* destination);
+void EncodeBC5BlockScalar(const uint8_t* pixels, uint8_t* destination);
+void EncodeBC7BlockScalar(const uint8_t* pixels, uint8_t* destination);
+
+void EncodeBC1BlockSse(const uint8_t* pixels, uint8_t* destination);
+void EncodeBC3BlockSse(const uint8_t* pixels, uint8_t* destination);
+void EncodeBC4BlockSse(const uint8_t* pixels, uint8_t* destination);
+void EncodeBC5BlockSse(const uint8_t* pixels, uint8_t* destination);
+void EncodeBC7BlockSse(const uint8_t* pixels, uint8_t* destination);
+
+void EncodeBC1BlockAvx2(const uint8_t* pixels, uint8_t* destination);
+void EncodeBC3BlockAvx2(const uint8_t* pixels, uint8_t* destination);
+void EncodeBC4BlockAvx2(const uint8_t* pixels, uint8_t* destination);
+void EncodeBC5BlockAvx2(const uint8_t* pixels, uint8_t* destination);
+void EncodeBC7BlockAvx2(const uint8_t* pixels, uint8_t* destination);
\ No newline at end of file
@@ -0,0 +1,189 @@
+#include "BlockCompressionKernels.h"
+
+#include <immintrin.h>
+
+// Four registers of four RGBA pixels each, the SSE4.1 instructions used are implied by the AVX baseline of the engine
+struct AkSseBlock
+{
+	__m128i pixels[4];
+};
+
+static AkSseBlock LoadBlockSse(const uint8_t* pixels)
+{
+	AkSseBlock block;
+	for (uint32_t i = 0; i < 4; ++i)
+		block.pixels[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels + i * 16));
+
+	return block;
+}
+
+static AkBlockBounds ComputeBoundsSse(const AkSseBlock& block)
+{
+	__m128i minimum = _mm_min_epu8(_mm_min_epu8(block.pixels[0], block.pixels[1]), _mm_min_epu8(block.pixels[2], block.pixels[3]));
+	__m128i maximum = _mm_max_epu8(_mm_max_epu8(block.pixels[0], block.pixels[1]), _mm_max_epu8(block.pixels[2], block.pixels[3]));
+
+	minimum = _mm_min_epu8(minimum, _mm_shuffle_epi32(minimum, _MM_SHUFFLE(1, 0, 3, 2)));
+	minimum = _mm_min_epu8(minimum, _mm_shuffle_epi32(minimum, _MM_SHUFFLE(2, 3, 0, 1)));
+	maximum = _mm_max_epu8(maximum, _mm_shuffle_epi32(maximum, _MM_SHUFFLE(1, 0, 3, 2)));
+	maximum = _mm_max_epu8(maximum, _mm_shuffle_epi32(maximum, _MM_SHUFFLE(2, 3, 0, 1)));
+
+	AkBlockBounds bounds;
+	const int32_t packedMinimum = _mm_cvtsi128_si32(minimum);
+	const int32_t packedMaximum = _mm_cvtsi128_si32(maximum);
+	std::memcpy(bounds.min, &packedMinimum, 4);
+	std::memcpy(bounds.max, &packedMaximum, 4);
+	return bounds;
+}
+
+// Multiplying with the green broadcast masked to alternating lanes keeps every channel product in its own 32 bit sum
+static void ComputeGreenCovarianceSse(const AkSseBlock& block, const AkBlockBounds& bounds, int32_t outCovariance[4])
+{
+	const __m128i center = _mm_setr_epi16(
+		static_cast<int16_t>(bounds.min[0] + bounds.max[0]), static_cast<int16_t>(bounds.min[1] + bounds.max[1]), static_cast<int16_t>(bounds.min[2] + bounds.max[2]), static_cast<int16_t>(bounds.min[3] + bounds.max[3]),
+		static_cast<int16_t>(bounds.min[0] + bounds.max[0]), static_cast<int16_t>(bounds.min[1] + bounds.max[1]), static_cast<int16_t>(bounds.min[2] + bounds.max[2]), static_cast<int16_t>(bounds.min[3] + bounds.max[3]));
+	const __m128i broadcastGreen = _mm_setr_epi8(2, 3, 2, 3, 2, 3, 2, 3, 10, 11, 10, 11, 10, 11, 10, 11);
+	const __m128i evenLanes = _mm_setr_epi16(-1, 0, -1, 0, -1, 0, -1, 0);
+
+	__m128i redBlue = _mm_setzero_si128();
+	__m128i greenAlpha = _mm_setzero_si128();
+	for (const __m128i& fourPixels : block.pixels)
+	{
+		const __m128i pixelPairs[2] = { fourPixels, _mm_srli_si128(fourPixels, 8) };
+		for (const __m128i& twoPixels : pixelPairs)
+		{
+			const __m128i centered = _mm_sub_epi16(_mm_slli_epi16(_mm_cvtepu8_epi16(twoPixels), 1), center);
+			const __m128i green = _mm_shuffle_epi8(centered, broadcastGreen);
+			redBlue = _mm_add_epi32(redBlue, _mm_madd_epi16(centered, _mm_and_si128(green, evenLanes)));
+			greenAlpha = _mm_add_epi32(greenAlpha, _mm_madd_epi16(centered, _mm_andnot_si128(evenLanes, green)));
+		}
+	}
+
+	alignas(16) int32_t redBlueSums[4];
+	alignas(16) int32_t greenAlphaSums[4];
+	_mm_store_si128(reinterpret_cast<__m128i*>(redBlueSums), redBlue);
+	_mm_store_si128(reinterpret_cast<__m128i*>(greenAlphaSums), greenAlpha);
+
+	outCovariance[0] = redBlueSums[0] + redBlueSums[2];
+	outCovariance[1] = greenAlphaSums[0] + greenAlphaSums[2];
+	outCovariance[2] = redBlueSums[1] + redBlueSums[3];
+	outCovariance[3] = greenAlphaSums[1] + greenAlphaSums[3];
+}
+
+static void ComputeLinearIndicesSse(const AkSseBlock& block, const AkBlockAxis& axis, uint8_t outIndices[16])
+{
+	const __m128i direction = _mm_setr_epi16(axis.direction[0], axis.direction[1], axis.direction[2], axis.direction[3], axis.direction[0], axis.direction[1], axis.direction[2], axis.direction[3]);
+	const __m128i base = _mm_set1_epi32(axis.base);
+	const __m128i scale = _mm_set1_epi32(axis.scale);
+
+	__m128i thresholds[15];
+	for (uint32_t i = 0; i < axis.thresholdCount; ++i)
+		thresholds[i] = _mm_set1_epi32(axis.thresholds[i]);
+
+	__m128i counts[4];
+	for (uint32_t i = 0; i < 4; ++i)
+	{
+		const __m128i firstPairDots = _mm_madd_epi16(_mm_cvtepu8_epi16(block.pixels[i]), direction);
+		const __m128i secondPairDots = _mm_madd_epi16(_mm_cvtepu8_epi16(_mm_srli_si128(block.pixels[i], 8)), direction);
+		const __m128i projection = _mm_mullo_epi32(_mm_sub_epi32(_mm_hadd_epi32(firstPairDots, secondPairDots), base), scale);
+
+		// Comparisons yield minus one per threshold passed
+		counts[i] = _mm_setzero_si128();
+		for (uint32_t threshold = 0; threshold < axis.thresholdCount; ++threshold)
+			counts[i] = _mm_sub_epi32(counts[i], _mm_cmpgt_epi32(projection, thresholds[threshold]));
+	}
+
+	const __m128i indices = _mm_packus_epi16(_mm_packs_epi32(counts[0], counts[1]), _mm_packs_epi32(counts[2], counts[3]));
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(outIndices), indices);
+}
+
+static void EncodeBC4ChannelSse(const AkSseBlock& block, const int8_t channel, uint8_t* destination)
+{
+	// Gathers the channel of every pixel into a single register
+	const __m128i gather = _mm_setr_epi8(channel, channel + 4, channel + 8, channel + 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+	const __m128i firstHalf = _mm_unpacklo_epi32(_mm_shuffle_epi8(block.pixels[0], gather), _mm_shuffle_epi8(block.pixels[1], gather));
+	const __m128i secondHalf = _mm_unpacklo_epi32(_mm_shuffle_epi8(block.pixels[2], gather), _mm_shuffle_epi8(block.pixels[3], gather));
+	const __m128i values = _mm_unpacklo_epi64(firstHalf, secondHalf);
+
+	__m128i minimum = _mm_min_epu8(values, _mm_srli_si128(values, 8));
+	minimum = _mm_min_epu8(minimum, _mm_srli_si128(minimum, 4));
+	minimum = _mm_min_epu8(minimum, _mm_srli_si128(minimum, 2));
+	minimum = _mm_min_epu8(minimum, _mm_srli_si128(minimum, 1));
+
+	__m128i maximum = _mm_max_epu8(values, _mm_srli_si128(values, 8));
+	maximum = _mm_max_epu8(maximum, _mm_srli_si128(maximum, 4));
+	maximum = _mm_max_epu8(maximum, _mm_srli_si128(maximum, 2));
+	maximum = _mm_max_epu8(maximum, _mm_srli_si128(maximum, 1));
+
+	const AkBC4Endpoints endpoints = ComputeBC4Endpoints(static_cast<uint8_t>(_mm_cvtsi128_si32(minimum)), static_cast<uint8_t>(_mm_cvtsi128_si32(maximum)));
+
+	const __m128i minimumValue = _mm_set1_epi16(endpoints.minimum);
+	const __m128i fourteen = _mm_set1_epi16(14);
+	const __m128i firstScaled = _mm_mullo_epi16(_mm_sub_epi16(_mm_cvtepu8_epi16(values), minimumValue), fourteen);
+	const __m128i secondScaled = _mm_mullo_epi16(_mm_sub_epi16(_mm_cvtepu8_epi16(_mm_srli_si128(values, 8)), minimumValue), fourteen);
+
+	__m128i firstCounts = _mm_setzero_si128();
+	__m128i secondCounts = _mm_setzero_si128();
+	for (const int16_t threshold : endpoints.thresholds)
+	{
+		const __m128i thresholdValue = _mm_set1_epi16(threshold);
+		firstCounts = _mm_sub_epi16(firstCounts, _mm_cmpgt_epi16(firstScaled, thresholdValue));
+		secondCounts = _mm_sub_epi16(secondCounts, _mm_cmpgt_epi16(secondScaled, thresholdValue));
+	}
+
+	alignas(16) uint8_t indices[16];
+	_mm_store_si128(reinterpret_cast<__m128i*>(indices), _mm_packus_epi16(firstCounts, secondCounts));
+	WriteBC4Block(endpoints, indices, destination);
+}
+
+static void EncodeBC1ColorSse(const AkSseBlock& block, uint8_t* destination)
+{
+	const AkBlockBounds bounds = ComputeBoundsSse(block);
+
+	int32_t covariance[4] = {};
+	ComputeGreenCovarianceSse(block, bounds, covariance);
+
+	const AkBC1Endpoints endpoints = ComputeBC1Endpoints(bounds, covariance);
+
+	alignas(16) uint8_t indices[16];
+	ComputeLinearIndicesSse(block, endpoints.axis, indices);
+	WriteBC1Block(endpoints, indices, destination);
+}
+
+void EncodeBC1BlockSse(const uint8_t* pixels, uint8_t* destination)
+{
+	EncodeBC1ColorSse(LoadBlockSse(pixels), destination);
+}
+
+void EncodeBC3BlockSse(const uint8_t* pixels, uint8_t* destination)
+{
+	const AkSseBlock block = LoadBlockSse(pixels);
+	EncodeBC4ChannelSse(block, 3, destination);
+	EncodeBC1ColorSse(block, destination + 8);
+}
+
+void EncodeBC4BlockSse(const uint8_t* pixels, uint8_t* destination)
+{
+	EncodeBC4ChannelSse(LoadBlockSse(pixels), 0, destination);
+}
+
+void EncodeBC5BlockSse(const uint8_t* pixels, uint8_t* destination)
+{
+	const AkSseBlock block = LoadBlockSse(pixels);
+	EncodeBC4ChannelSse(block, 0, destination);
+	EncodeBC4ChannelSse(block, 1, destination + 8);
+}
+
+void EncodeBC7BlockSse(const uint8_t* pixels, uint8_t* destination)
+{
+	const AkSseBlock block = LoadBlockSse(pixels);
+	const AkBlockBounds bounds = ComputeBoundsSse(block);
+
+	int32_t covariance[4] = {};
+	ComputeGreenCovarianceSse(block, bounds, covariance);
+
+	const AkBC7Endpoints endpoints = ComputeBC7Endpoints(bounds, covariance);
+
+	alignas(16) uint8_t indices[16];
+	ComputeLinearIndicesSse(block, endpoints.axis, indices);
+	WriteBC7Block(endpoints, indices, destination);
+}
\ No newline at end of file
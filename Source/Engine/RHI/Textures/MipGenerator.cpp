@@ -0,0 +1,231 @@
+#include "MipGenerator.h"
+#include "Texture.h"
+#include "Core/Log.h"
+#include "RHI/Device.h"
+#include "RHI/VulkanPipelineStates.h"
+#include "RHI/CommandBuffers/CommandBuffer.h"
+#include "Shaders/GenerateMips.comp.h"
+
+#include <array>
+#include <algorithm>
+#include <vulkan/vulkan.hpp>
+
+struct AkGenerateMipsConstants
+{
+	uint32_t sourceWidth = 0;
+	uint32_t sourceHeight = 0;
+	uint32_t mipCount = 0;
+	uint32_t reduction = 0;
+	uint32_t encodeSrgb = 0;
+};
+
+static constexpr uint32_t kGenerateMipsGroupSize = 8;
+
+static vk::DescriptorSetLayout sDescriptorSetLayout = nullptr;
+static vk::PipelineLayout sPipelineLayout = nullptr;
+static vk::Pipeline sPipeline = nullptr;
+
+bool AkMipGenerator::Initialize()
+{
+	// Descriptors are pushed per dispatch and every storage format is written through the same shader
+	if (!AkDevice::SupportsPushDescriptors() || !AkDevice::SupportsFormatlessStorageWrites())
+	{
+		AkLogWarning("Mips are generated with blits, the device lacks push descriptors or formatless storage writes");
+		return true;
+	}
+
+	const vk::Device& device = AkDevice::GetDevice();
+	vk::ShaderModule shaderModule = nullptr;
+
+	try
+	{
+		std::array<vk::DescriptorSetLayoutBinding, 1 + kMipsPerDispatch> bindings;
+		bindings[0] = { .binding = 0, .descriptorType = vk::DescriptorType::eSampledImage, .descriptorCount = 1, .stageFlags = vk::ShaderStageFlagBits::eCompute };
+		for (uint32_t i = 1; i < bindings.size(); ++i)
+			bindings[i] = { .binding = i, .descriptorType = vk::DescriptorType::eStorageImage, .descriptorCount = 1, .stageFlags = vk::ShaderStageFlagBits::eCompute };
+
+		sDescriptorSetLayout = device.createDescriptorSetLayout(
+		{
+			.flags = vk::DescriptorSetLayoutCreateFlagBits::ePushDescriptorKHR,
+			.bindingCount = static_cast<uint32_t>(bindings.size()),
+			.pBindings = bindings.data()
+		});
+
+		const vk::PushConstantRange pushConstantRange = { .stageFlags = vk::ShaderStageFlagBits::eCompute, .size = sizeof(AkGenerateMipsConstants) };
+		sPipelineLayout = device.createPipelineLayout(
+		{
+			.setLayoutCount = 1,
+			.pSetLayouts = &sDescriptorSetLayout,
+			.pushConstantRangeCount = 1,
+			.pPushConstantRanges = &pushConstantRange
+		});
+
+		shaderModule = device.createShaderModule({ .codeSize = sizeof(kGenerateMipsSpirv), .pCode = kGenerateMipsSpirv });
+
+		const vk::ComputePipelineCreateInfo pipelineCreateInfo =
+		{
+			.stage = { .stage = vk::ShaderStageFlagBits::eCompute, .module = shaderModule, .pName = "main" },
+			.layout = sPipelineLayout
+		};
+
+		sPipeline = device.createComputePipeline(nullptr, pipelineCreateInfo).value;
+		device.destroyShaderModule(shaderModule);
+	}
+	catch (const std::exception& exception)
+	{
+		AkLogError("Failed to create the mip generation pipeline: {}", exception.what());
+		device.destroyShaderModule(shaderModule);
+		return false;
+	}
+
+	return true;
+}
+
+void AkMipGenerator::Deinitialize()
+{
+	const vk::Device& device = AkDevice::GetDevice();
+	device.destroyPipeline(sPipeline);
+	device.destroyPipelineLayout(sPipelineLayout);
+	device.destroyDescriptorSetLayout(sDescriptorSetLayout);
+
+	sPipeline = nullptr;
+	sPipelineLayout = nullptr;
+	sDescriptorSetLayout = nullptr;
+}
+
+bool AkMipGenerator::SupportsCompute(const AkTexture* texture)
+{
+	const AkTextureDescriptor& descriptor = texture->GetDescriptor();
+	if (!sPipeline || descriptor.type != AkTextureType::TEXTURE_2D || descriptor.msaa != AkMSAA::X1)
+		return false;
+
+	if (IsDepthPixelFormat(descriptor.format) || IsBlockCompressedPixelFormat(descriptor.format))
+		return false;
+
+	const AkTextureFlags requiredFlags = AkTextureFlags_BIND_AS_SHADER_RESOURCE | AkTextureFlags_ALLOW_UNORDERED_ACCESS | (IsSRGB(descriptor.format) ? AkTextureFlags_SRGB_HINT : 0);
+	if ((descriptor.flags & requiredFlags) != requiredFlags)
+		return false;
+
+	return AkDevice::SupportsFormatFeatures(GetLinear(descriptor.format), AkFormatFeatures_STORAGE);
+}
+
+void AkMipGenerator::Generate(AkCommandBuffer* commandBuffer, AkTexture* texture, const AkMipReduction reduction)
+{
+	if (texture->GetDescriptor().mips <= 1)
+		return;
+
+	if (SupportsCompute(texture))
+	{
+		GenerateWithCompute(commandBuffer, texture, reduction);
+		return;
+	}
+
+	// Linear blits would let the mips of depth pyramids pass values that do not bound the texels below them
+	if (reduction != AkMipReduction::AVERAGE)
+	{
+		AkLogError("Minimum and maximum mip reductions need a texture that supports compute mip generation");
+		return;
+	}
+
+	const AkTextureFlags blitFlags = AkTextureFlags_COPY_SOURCE | AkTextureFlags_COPY_DESTINATION;
+	if ((texture->GetDescriptor().flags & blitFlags) != blitFlags)
+	{
+		AkLogError("Generating mips with blits needs a texture that is both a copy source and destination");
+		return;
+	}
+
+	GenerateWithBlits(commandBuffer, texture);
+}
+
+void AkMipGenerator::GenerateWithCompute(AkCommandBuffer* commandBuffer, AkTexture* texture, const AkMipReduction reduction)
+{
+	const AkTextureDescriptor& descriptor = texture->GetDescriptor();
+	const AkPixelFormat storageFormat = GetLinear(descriptor.format);
+	const auto getMipSize = [&descriptor](const uint32_t mip) { return vk::Extent2D{ std::max(1u, descriptor.width >> mip), std::max(1u, descriptor.height >> mip) }; };
+
+	vk::CommandBuffer& vulkanCommandBuffer = commandBuffer->GetBuffer();
+	vulkanCommandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, sPipeline);
+
+	uint32_t sourceMip = 0;
+	while (sourceMip + 1 < descriptor.mips)
+	{
+		// Shared memory levels only combine whole 2x2 groups, so a batch stops before a mip that has an odd side
+		uint32_t mipCount = 1;
+		while (mipCount < kMipsPerDispatch && sourceMip + mipCount + 1 < descriptor.mips)
+		{
+			const vk::Extent2D size = getMipSize(sourceMip + mipCount);
+			if (size.width % 2 != 0 || size.height % 2 != 0)
+				break;
+
+			++mipCount;
+		}
+
+		commandBuffer->RequireState(texture, AkResourceState::SHADER_RESOURCE, { .baseMip = sourceMip, .mipCount = 1 }, AkShaderStage_COMPUTE);
+		commandBuffer->RequireState(texture, AkResourceState::UNORDERED_ACCESS, { .baseMip = sourceMip + 1, .mipCount = mipCount }, AkShaderStage_COMPUTE);
+		commandBuffer->FlushBarriers();
+
+		// The source is read in the texture's own format, the SRGB hint alone would decode UNORM texels the shader never encodes back
+		// Bindings past the last mip of the batch repeat it, the shader never writes them
+		std::array<vk::DescriptorImageInfo, 1 + kMipsPerDispatch> imageInfos;
+		imageInfos[0] = { .imageView = texture->GetView({ .baseMip = sourceMip, .mipCount = 1 }, descriptor.format), .imageLayout = GetImageLayout(AkResourceState::SHADER_RESOURCE) };
+		for (uint32_t i = 0; i < kMipsPerDispatch; ++i)
+			imageInfos[i + 1] = { .imageView = texture->GetView({ .baseMip = sourceMip + 1 + std::min(i, mipCount - 1), .mipCount = 1 }, storageFormat), .imageLayout = GetImageLayout(AkResourceState::UNORDERED_ACCESS) };
+
+		std::array<vk::WriteDescriptorSet, 1 + kMipsPerDispatch> writes;
+		for (uint32_t i = 0; i < writes.size(); ++i)
+		{
+			writes[i] =
+			{
+				.dstBinding = i,
+				.descriptorCount = 1,
+				.descriptorType = i == 0 ? vk::DescriptorType::eSampledImage : vk::DescriptorType::eStorageImage,
+				.pImageInfo = &imageInfos[i]
+			};
+		}
+
+		const vk::Extent2D sourceSize = getMipSize(sourceMip);
+		const AkGenerateMipsConstants constants =
+		{
+			.sourceWidth = sourceSize.width,
+			.sourceHeight = sourceSize.height,
+			.mipCount = mipCount,
+			.reduction = static_cast<uint32_t>(reduction),
+			.encodeSrgb = IsSRGB(descriptor.format) ? 1u : 0u
+		};
+
+		const vk::Extent2D firstMipSize = getMipSize(sourceMip + 1);
+		vulkanCommandBuffer.pushDescriptorSetKHR(vk::PipelineBindPoint::eCompute, sPipelineLayout, 0, writes);
+		vulkanCommandBuffer.pushConstants(sPipelineLayout, vk::ShaderStageFlagBits::eCompute, 0, sizeof(constants), &constants);
+		vulkanCommandBuffer.dispatch((firstMipSize.width + kGenerateMipsGroupSize - 1) / kGenerateMipsGroupSize, (firstMipSize.height + kGenerateMipsGroupSize - 1) / kGenerateMipsGroupSize, 1);
+
+		sourceMip += mipCount;
+	}
+}
+
+void AkMipGenerator::GenerateWithBlits(AkCommandBuffer* commandBuffer, AkTexture* texture)
+{
+	const AkTextureDescriptor& descriptor = texture->GetDescriptor();
+	const vk::ImageAspectFlags aspectMask = GetAspectMask(descriptor.format);
+	const vk::Filter filter = AkDevice::SupportsFormatFeatures(descriptor.format, AkFormatFeatures_LINEAR_FILTER) ? vk::Filter::eLinear : vk::Filter::eNearest;
+	const auto getMipExtent = [&descriptor](const uint32_t mip)
+	{
+		return vk::Offset3D{ static_cast<int32_t>(std::max(1u, descriptor.width >> mip)), static_cast<int32_t>(std::max(1u, descriptor.height >> mip)), static_cast<int32_t>(std::max(1u, descriptor.depth >> mip)) };
+	};
+
+	for (uint32_t mip = 1; mip < descriptor.mips; ++mip)
+	{
+		commandBuffer->RequireState(texture, AkResourceState::COPY_SOURCE, { .baseMip = mip - 1, .mipCount = 1 });
+		commandBuffer->RequireState(texture, AkResourceState::COPY_DESTINATION, { .baseMip = mip, .mipCount = 1 });
+		commandBuffer->FlushBarriers();
+
+		const vk::ImageBlit blitRegion =
+		{
+			.srcSubresource = { .aspectMask = aspectMask, .mipLevel = mip - 1, .layerCount = descriptor.slices },
+			.srcOffsets = std::array<vk::Offset3D, 2>{ vk::Offset3D{ 0, 0, 0 }, getMipExtent(mip - 1) },
+			.dstSubresource = { .aspectMask = aspectMask, .mipLevel = mip, .layerCount = descriptor.slices },
+			.dstOffsets = std::array<vk::Offset3D, 2>{ vk::Offset3D{ 0, 0, 0 }, getMipExtent(mip) }
+		};
+
+		commandBuffer->GetBuffer().blitImage(texture->GetImage(), GetImageLayout(AkResourceState::COPY_SOURCE), texture->GetImage(), GetImageLayout(AkResourceState::COPY_DESTINATION), blitRegion, filter);
+	}
+}
\ No newline at end of file
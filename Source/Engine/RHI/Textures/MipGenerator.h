@@ -0,0 +1,30 @@
+#pragma once
+#include <cstdint>
+
+enum class AkMipReduction
+{
+	AVERAGE,
+	MINIMUM,
+	MAXIMUM
+};
+
+// Generates mip chains with a compute shader that writes up to four mips per dispatch, reading the previous ones back from shared memory.
+// Textures need unordered access, sRGB ones also the SRGB hint so their mips can be stored through a linear view.
+// Anything else falls back to one blit per mip, which only supports averaging.
+class AkMipGenerator
+{
+public:
+	static constexpr uint32_t kMipsPerDispatch = 4;
+
+	static bool Initialize();
+	static void Deinitialize();
+
+	static bool SupportsCompute(const class AkTexture* texture);
+
+	// Fills every mip after the first from the one before it, called through AkCommandBuffer::GenerateMips
+	static void Generate(class AkCommandBuffer* commandBuffer, class AkTexture* texture, const AkMipReduction reduction);
+
+private:
+	static void GenerateWithCompute(class AkCommandBuffer* commandBuffer, class AkTexture* texture, const AkMipReduction reduction);
+	static void GenerateWithBlits(class AkCommandBuffer* commandBuffer, class AkTexture* texture);
+};
\ No newline at end of file
@@ -0,0 +1,764 @@
+#include "PixelConversion.h"
+#include "Core/Log.h"
+#include "Core/JobSystem.h"
+
+#include <array>
+#include <cmath>
+#include <limits>
+#include <cstring>
+#include <utility>
+#include <type_traits>
+#include <algorithm>
+#include <immintrin.h>
+
+static constexpr size_t kBlockPixels = 64;
+static constexpr size_t kPixelsPerJob = 16 * 1024;
+
+// Planar RGBA floats, the pivot every codec decodes to and encodes from
+struct AkPixelBlock
+{
+	alignas(16) float channels[4][kBlockPixels];
+};
+
+using AkPixelConvertFunction = void(*)(const uint8_t* source, uint8_t* destination, const size_t pixelCount);
+using AkPixelDecodeFunction = void(*)(const uint8_t* source, AkPixelBlock& block, const size_t pixelCount);
+using AkPixelEncodeFunction = void(*)(const AkPixelBlock& block, uint8_t* destination, const size_t pixelCount);
+
+// Scalar paths mirror the SSE semantics of min and max, which return the second operand when comparing against NaN
+static float MinSse(const float a, const float b)
+{
+	return a < b ? a : b;
+}
+
+static float MaxSse(const float a, const float b)
+{
+	return a > b ? a : b;
+}
+
+static uint32_t FloatBits(const float value)
+{
+	uint32_t bits = 0;
+	std::memcpy(&bits, &value, 4);
+	return bits;
+}
+
+static float BitsToFloat(const uint32_t bits)
+{
+	float value = 0.f;
+	std::memcpy(&value, &bits, 4);
+	return value;
+}
+
+// -- sRGB transfer
+
+// Encoding clamps to the smallest float that can still round above zero, then every bucket of 256 mantissa steps crosses at most one rounding threshold
+static constexpr uint32_t kSrgbMinimumBits = (127 - 13) << 23;
+static constexpr uint32_t kSrgbAlmostOneBits = 0x3F7FFFFF;
+static constexpr uint32_t kSrgbBucketShift = 15;
+static constexpr size_t kSrgbBucketCount = ((127u << 23) - kSrgbMinimumBits) >> kSrgbBucketShift;
+
+struct AkSrgbTables
+{
+	// Linear values at which the encoded value steps to the next one, the last is never crossed
+	std::array<float, 256> thresholds = {};
+	std::array<uint8_t, kSrgbBucketCount> bucketBases = {};
+
+	std::array<float, 256> linearFromSrgb = {};
+	std::array<uint8_t, 256> srgbFromUnorm8 = {};
+	std::array<uint8_t, 256> unorm8FromSrgb = {};
+};
+
+static uint8_t EncodeSrgb(const AkSrgbTables& tables, const float linear)
+{
+	const float clamped = MinSse(MaxSse(linear, BitsToFloat(kSrgbMinimumBits)), BitsToFloat(kSrgbAlmostOneBits));
+	const uint8_t base = tables.bucketBases[(FloatBits(clamped) - kSrgbMinimumBits) >> kSrgbBucketShift];
+	return static_cast<uint8_t>(base + (clamped > tables.thresholds[base] ? 1 : 0));
+}
+
+static uint8_t EncodeUnorm8(const float value)
+{
+	return static_cast<uint8_t>(std::nearbyint(MinSse(MaxSse(value, 0.f), 1.f) * 255.f));
+}
+
+static const AkSrgbTables& GetSrgbTables()
+{
+	static const AkSrgbTables sTables = []()
+	{
+		const auto toLinear = [](const double srgb) { return srgb <= 0.04045 ? srgb / 12.92 : std::pow((srgb + 0.055) / 1.055, 2.4); };
+
+		AkSrgbTables tables;
+		for (uint32_t i = 0; i < 255; ++i)
+			tables.thresholds[i] = static_cast<float>(toLinear((i + 0.5) / 255.0));
+
+		tables.thresholds[255] = std::numeric_limits<float>::max();
+
+		for (size_t bucket = 0; bucket < kSrgbBucketCount; ++bucket)
+		{
+			const float bucketStart = BitsToFloat(static_cast<uint32_t>(kSrgbMinimumBits + (bucket << kSrgbBucketShift)));
+			tables.bucketBases[bucket] = static_cast<uint8_t>(std::count_if(tables.thresholds.begin(), tables.thresholds.end(), [bucketStart](const float threshold) { return bucketStart > threshold; }));
+		}
+
+		for (uint32_t i = 0; i < 256; ++i)
+		{
+			tables.linearFromSrgb[i] = static_cast<float>(toLinear(i / 255.0));
+			tables.srgbFromUnorm8[i] = EncodeSrgb(tables, static_cast<float>(i) * (1.f / 255.f));
+			tables.unorm8FromSrgb[i] = EncodeUnorm8(tables.linearFromSrgb[i]);
+		}
+
+		return tables;
+	}();
+
+	return sTables;
+}
+
+static __m128i EncodeSrgb4(const AkSrgbTables& tables, const __m128 linear)
+{
+	const __m128 clamped = _mm_min_ps(_mm_max_ps(linear, _mm_castsi128_ps(_mm_set1_epi32(kSrgbMinimumBits))), _mm_castsi128_ps(_mm_set1_epi32(kSrgbAlmostOneBits)));
+	const __m128i buckets = _mm_srli_epi32(_mm_sub_epi32(_mm_castps_si128(clamped), _mm_set1_epi32(kSrgbMinimumBits)), kSrgbBucketShift);
+
+	// Table lookups have no SSE equivalent, only the bucket and threshold selection stays vectorized
+	alignas(16) uint32_t bucketIndices[4];
+	_mm_store_si128(reinterpret_cast<__m128i*>(bucketIndices), buckets);
+
+	const uint8_t bases[4] = { tables.bucketBases[bucketIndices[0]], tables.bucketBases[bucketIndices[1]], tables.bucketBases[bucketIndices[2]], tables.bucketBases[bucketIndices[3]] };
+	const __m128 thresholds = _mm_setr_ps(tables.thresholds[bases[0]], tables.thresholds[bases[1]], tables.thresholds[bases[2]], tables.thresholds[bases[3]]);
+	const __m128i baseValues = _mm_setr_epi32(bases[0], bases[1], bases[2], bases[3]);
+	return _mm_sub_epi32(baseValues, _mm_castps_si128(_mm_cmpgt_ps(clamped, thresholds)));
+}
+
+// -- Half floats, rounding to nearest even and quieting NaNs while keeping their payload like F16C does
+
+static float HalfToFloat(const uint16_t half)
+{
+	const uint32_t shiftedExponent = 0x7C00 << 13;
+	uint32_t bits = (half & 0x7FFF) << 13;
+	const uint32_t exponent = bits & shiftedExponent;
+	bits += (127 - 15) << 23;
+
+	float value = 0.f;
+	if (exponent == shiftedExponent)
+		value = BitsToFloat((bits + ((128 - 16) << 23)) | ((half & 0x3FF) != 0 ? 0x400000 : 0));
+	else if (exponent == 0)
+		value = BitsToFloat(bits + (1 << 23)) - BitsToFloat(113 << 23);
+	else
+		value = BitsToFloat(bits);
+
+	return BitsToFloat(FloatBits(value) | ((half & 0x8000) << 16));
+}
+
+static uint16_t FloatToHalf(const float value)
+{
+	uint32_t bits = FloatBits(value);
+	const uint32_t sign = bits & 0x80000000u;
+	bits ^= sign;
+
+	uint32_t half = 0;
+	if (bits >= (127 + 16) << 23)
+		half = bits > (255u << 23) ? 0x7E00 | ((bits >> 13) & 0x3FF) : 0x7C00;
+	else if (bits < (113 << 23))
+		half = FloatBits(BitsToFloat(bits) + BitsToFloat(126 << 23)) - (126 << 23);
+	else
+		half = (bits + ((15u - 127u) << 23) + 0xFFF + ((bits >> 13) & 1)) >> 13;
+
+	return static_cast<uint16_t>(half | (sign >> 16));
+}
+
+static __m128 HalfToFloat4(const __m128i halves)
+{
+	const __m128i shiftedExponent = _mm_set1_epi32(0x7C00 << 13);
+	const __m128i bits = _mm_slli_epi32(_mm_and_si128(halves, _mm_set1_epi32(0x7FFF)), 13);
+	const __m128i exponent = _mm_and_si128(bits, shiftedExponent);
+	const __m128i rebiased = _mm_add_epi32(bits, _mm_set1_epi32((127 - 15) << 23));
+
+	const __m128i quietBit = _mm_andnot_si128(_mm_cmpeq_epi32(_mm_and_si128(halves, _mm_set1_epi32(0x3FF)), _mm_setzero_si128()), _mm_set1_epi32(0x400000));
+	const __m128i infinityOrNaN = _mm_or_si128(_mm_add_epi32(rebiased, _mm_set1_epi32((128 - 16) << 23)), quietBit);
+	const __m128 denormal = _mm_sub_ps(_mm_castsi128_ps(_mm_add_epi32(rebiased, _mm_set1_epi32(1 << 23))), _mm_castsi128_ps(_mm_set1_epi32(113 << 23)));
+
+	__m128i result = _mm_blendv_epi8(rebiased, infinityOrNaN, _mm_cmpeq_epi32(exponent, shiftedExponent));
+	result = _mm_blendv_epi8(result, _mm_castps_si128(denormal), _mm_cmpeq_epi32(exponent, _mm_setzero_si128()));
+	return _mm_castsi128_ps(_mm_or_si128(result, _mm_slli_epi32(_mm_and_si128(halves, _mm_set1_epi32(0x8000)), 16)));
+}
+
+static __m128i FloatToHalf4(const __m128 values)
+{
+	const __m128i sign = _mm_and_si128(_mm_castps_si128(values), _mm_set1_epi32(static_cast<int32_t>(0x80000000u)));
+	const __m128i bits = _mm_xor_si128(_mm_castps_si128(values), sign);
+
+	const __m128i nanPayload = _mm_or_si128(_mm_set1_epi32(0x7E00), _mm_and_si128(_mm_srli_epi32(bits, 13), _mm_set1_epi32(0x3FF)));
+	const __m128i infinityOrNaN = _mm_blendv_epi8(_mm_set1_epi32(0x7C00), nanPayload, _mm_cmpgt_epi32(bits, _mm_set1_epi32(255 << 23)));
+
+	const __m128i denormal = _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(_mm_castsi128_ps(bits), _mm_castsi128_ps(_mm_set1_epi32(126 << 23)))), _mm_set1_epi32(126 << 23));
+	const __m128i oddMantissa = _mm_and_si128(_mm_srli_epi32(bits, 13), _mm_set1_epi32(1));
+	const __m128i normal = _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(bits, _mm_set1_epi32(static_cast<int32_t>(((15u - 127u) << 23) + 0xFFF))), oddMantissa), 13);
+
+	__m128i result = _mm_blendv_epi8(normal, denormal, _mm_cmplt_epi32(bits, _mm_set1_epi32(113 << 23)));
+	result = _mm_blendv_epi8(result, infinityOrNaN, _mm_cmpgt_epi32(bits, _mm_set1_epi32(((127 + 16) << 23) - 1)));
+	return _mm_or_si128(result, _mm_srli_epi32(sign, 16));
+}
+
+// -- Elements, a single channel value of an interleaved format
+
+struct AkFloat32Element
+{
+	using Type = float;
+
+	static float Load(const uint8_t* source) { float value = 0.f; std::memcpy(&value, source, 4); return value; }
+	static void Store(const float value, uint8_t* destination) { std::memcpy(destination, &value, 4); }
+
+	static __m128 Load4(const uint8_t* source) { return _mm_loadu_ps(reinterpret_cast<const float*>(source)); }
+	static void Store4(const __m128 values, uint8_t* destination) { _mm_storeu_ps(reinterpret_cast<float*>(destination), values); }
+};
+
+struct AkFloat16Element
+{
+	using Type = uint16_t;
+
+	static float Load(const uint8_t* source) { uint16_t half = 0; std::memcpy(&half, source, 2); return HalfToFloat(half); }
+	static void Store(const float value, uint8_t* destination) { const uint16_t half = FloatToHalf(value); std::memcpy(destination, &half, 2); }
+
+	static __m128 Load4(const uint8_t* source) { return HalfToFloat4(_mm_cvtepu16_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(source)))); }
+	static void Store4(const __m128 values, uint8_t* destination) { _mm_storel_epi64(reinterpret_cast<__m128i*>(destination), _mm_packus_epi32(FloatToHalf4(values), _mm_setzero_si128())); }
+};
+
+template<typename TInteger>
+static __m128i LoadIntegers4(const uint8_t* source)
+{
+	if constexpr (sizeof(TInteger) == 1)
+	{
+		int32_t packed = 0;
+		std::memcpy(&packed, source, 4);
+		return std::is_signed_v<TInteger> ? _mm_cvtepi8_epi32(_mm_cvtsi32_si128(packed)) : _mm_cvtepu8_epi32(_mm_cvtsi32_si128(packed));
+	}
+	else
+	{
+		const __m128i packed = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(source));
+		return std::is_signed_v<TInteger> ? _mm_cvtepi16_epi32(packed) : _mm_cvtepu16_epi32(packed);
+	}
+}
+
+// Keeps the low bytes of every lane, which also holds the two's complement of negative values
+template<typename TInteger>
+static void StoreIntegers4(const __m128i values, uint8_t* destination)
+{
+	if constexpr (sizeof(TInteger) == 1)
+	{
+		const int32_t packed = _mm_cvtsi128_si32(_mm_shuffle_epi8(values, _mm_setr_epi8(0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1)));
+		std::memcpy(destination, &packed, 4);
+	}
+	else
+	{
+		_mm_storel_epi64(reinterpret_cast<__m128i*>(destination), _mm_shuffle_epi8(values, _mm_setr_epi8(0, 1, 4, 5, 8, 9, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1)));
+	}
+}
+
+template<typename TInteger>
+struct AkUnormElement
+{
+	using Type = TInteger;
+	static constexpr float kMaximum = static_cast<float>(std::numeric_limits<TInteger>::max());
+
+	static float Load(const uint8_t* source)
+	{
+		TInteger value = 0;
+		std::memcpy(&value, source, sizeof(TInteger));
+		return static_cast<float>(value) * (1.f / kMaximum);
+	}
+
+	static void Store(const float value, uint8_t* destination)
+	{
+		const TInteger integer = static_cast<TInteger>(std::nearbyint(MinSse(MaxSse(value, 0.f), 1.f) * kMaximum));
+		std::memcpy(destination, &integer, sizeof(TInteger));
+	}
+
+	static __m128 Load4(const uint8_t* source)
+	{
+		return _mm_mul_ps(_mm_cvtepi32_ps(LoadIntegers4<TInteger>(source)), _mm_set1_ps(1.f / kMaximum));
+	}
+
+	static void Store4(const __m128 values, uint8_t* destination)
+	{
+		const __m128 clamped = _mm_min_ps(_mm_max_ps(values, _mm_setzero_ps()), _mm_set1_ps(1.f));
+		StoreIntegers4<TInteger>(_mm_cvtps_epi32(_mm_mul_ps(clamped, _mm_set1_ps(kMaximum))), destination);
+	}
+};
+
+// The most negative value decodes to minus one as well, so zero stays exact
+template<typename TInteger>
+struct AkSnormElement
+{
+	using Type = TInteger;
+	static constexpr float kMaximum = static_cast<float>(std::numeric_limits<TInteger>::max());
+
+	static float Load(const uint8_t* source)
+	{
+		TInteger value = 0;
+		std::memcpy(&value, source, sizeof(TInteger));
+		return MaxSse(static_cast<float>(value) * (1.f / kMaximum), -1.f);
+	}
+
+	static void Store(const float value, uint8_t* destination)
+	{
+		const TInteger integer = static_cast<TInteger>(std::nearbyint(MinSse(MaxSse(value, -1.f), 1.f) * kMaximum));
+		std::memcpy(destination, &integer, sizeof(TInteger));
+	}
+
+	static __m128 Load4(const uint8_t* source)
+	{
+		return _mm_max_ps(_mm_mul_ps(_mm_cvtepi32_ps(LoadIntegers4<TInteger>(source)), _mm_set1_ps(1.f / kMaximum)), _mm_set1_ps(-1.f));
+	}
+
+	static void Store4(const __m128 values, uint8_t* destination)
+	{
+		const __m128 clamped = _mm_min_ps(_mm_max_ps(values, _mm_set1_ps(-1.f)), _mm_set1_ps(1.f));
+		StoreIntegers4<TInteger>(_mm_cvtps_epi32(_mm_mul_ps(clamped, _mm_set1_ps(kMaximum))), destination);
+	}
+};
+
+// -- Codecs, decoding whole pixels to the planar block and back
+
+template<uint32_t kChannels>
+static void InterleavedToPlanar(__m128 interleaved[4], __m128 outChannels[4])
+{
+	if constexpr (kChannels == 1)
+	{
+		outChannels[0] = interleaved[0];
+	}
+	else if constexpr (kChannels == 2)
+	{
+		outChannels[0] = _mm_shuffle_ps(interleaved[0], interleaved[1], _MM_SHUFFLE(2, 0, 2, 0));
+		outChannels[1] = _mm_shuffle_ps(interleaved[0], interleaved[1], _MM_SHUFFLE(3, 1, 3, 1));
+	}
+	else
+	{
+		_MM_TRANSPOSE4_PS(interleaved[0], interleaved[1], interleaved[2], interleaved[3]);
+		for (uint32_t channel = 0; channel < 4; ++channel)
+			outChannels[channel] = interleaved[channel];
+	}
+}
+
+template<uint32_t kChannels>
+static void PlanarToInterleaved(__m128 channels[4], __m128 outInterleaved[4])
+{
+	if constexpr (kChannels == 1)
+	{
+		outInterleaved[0] = channels[0];
+	}
+	else if constexpr (kChannels == 2)
+	{
+		outInterleaved[0] = _mm_unpacklo_ps(channels[0], channels[1]);
+		outInterleaved[1] = _mm_unpackhi_ps(channels[0], channels[1]);
+	}
+	else
+	{
+		_MM_TRANSPOSE4_PS(channels[0], channels[1], channels[2], channels[3]);
+		for (uint32_t channel = 0; channel < 4; ++channel)
+			outInterleaved[channel] = channels[channel];
+	}
+}
+
+template<typename TElement, uint32_t kChannels, bool kSwapRedBlue = false>
+struct AkInterleavedCodec
+{
+	static constexpr size_t kElementSize = sizeof(typename TElement::Type);
+
+	static void Decode(const uint8_t* source, AkPixelBlock& block, const size_t pixelCount)
+	{
+		size_t pixel = 0;
+		for (; pixel + 4 <= pixelCount; pixel += 4)
+		{
+			__m128 interleaved[4];
+			for (uint32_t i = 0; i < kChannels; ++i)
+				interleaved[i] = TElement::Load4(source + (pixel * kChannels + i * 4) * kElementSize);
+
+			__m128 channels[4] = { _mm_setzero_ps(), _mm_setzero_ps(), _mm_setzero_ps(), _mm_set1_ps(1.f) };
+			InterleavedToPlanar<kChannels>(interleaved, channels);
+			if constexpr (kSwapRedBlue)
+				std::swap(channels[0], channels[2]);
+
+			for (uint32_t channel = 0; channel < 4; ++channel)
+				_mm_store_ps(&block.channels[channel][pixel], channels[channel]);
+		}
+
+		for (; pixel < pixelCount; ++pixel)
+		{
+			float channels[4] = { 0.f, 0.f, 0.f, 1.f };
+			for (uint32_t channel = 0; channel < kChannels; ++channel)
+				channels[channel] = TElement::Load(source + (pixel * kChannels + channel) * kElementSize);
+
+			if constexpr (kSwapRedBlue)
+				std::swap(channels[0], channels[2]);
+
+			for (uint32_t channel = 0; channel < 4; ++channel)
+				block.channels[channel][pixel] = channels[channel];
+		}
+	}
+
+	static void Encode(const AkPixelBlock& block, uint8_t* destination, const size_t pixelCount)
+	{
+		size_t pixel = 0;
+		for (; pixel + 4 <= pixelCount; pixel += 4)
+		{
+			__m128 channels[4];
+			for (uint32_t channel = 0; channel < 4; ++channel)
+				channels[channel] = _mm_load_ps(&block.channels[channel][pixel]);
+
+			if constexpr (kSwapRedBlue)
+				std::swap(channels[0], channels[2]);
+
+			__m128 interleaved[4];
+			PlanarToInterleaved<kChannels>(channels, interleaved);
+			for (uint32_t i = 0; i < kChannels; ++i)
+				TElement::Store4(interleaved[i], destination + (pixel * kChannels + i * 4) * kElementSize);
+		}
+
+		for (; pixel < pixelCount; ++pixel)
+		{
+			float channels[4];
+			for (uint32_t channel = 0; channel < 4; ++channel)
+				channels[channel] = block.channels[channel][pixel];
+
+			if constexpr (kSwapRedBlue)
+				std::swap(channels[0], channels[2]);
+
+			for (uint32_t channel = 0; channel < kChannels; ++channel)
+				TElement::Store(channels[channel], destination + (pixel * kChannels + channel) * kElementSize);
+		}
+	}
+};
+
+// Decoding is a table lookup per byte, which has no faster SSE form, encoding vectorizes the bucket search
+template<bool kSwapRedBlue>
+struct AkSrgb8Codec
+{
+	static constexpr uint32_t kRed = kSwapRedBlue ? 2 : 0;
+	static constexpr uint32_t kBlue = kSwapRedBlue ? 0 : 2;
+
+	static void Decode(const uint8_t* source, AkPixelBlock& block, const size_t pixelCount)
+	{
+		const AkSrgbTables& tables = GetSrgbTables();
+		for (size_t pixel = 0; pixel < pixelCount; ++pixel)
+		{
+			block.channels[kRed][pixel] = tables.linearFromSrgb[source[pixel * 4]];
+			block.channels[1][pixel] = tables.linearFromSrgb[source[pixel * 4 + 1]];
+			block.channels[kBlue][pixel] = tables.linearFromSrgb[source[pixel * 4 + 2]];
+			block.channels[3][pixel] = static_cast<float>(source[pixel * 4 + 3]) * (1.f / 255.f);
+		}
+	}
+
+	static void Encode(const AkPixelBlock& block, uint8_t* destination, const size_t pixelCount)
+	{
+		const AkSrgbTables& tables = GetSrgbTables();
+
+		size_t pixel = 0;
+		for (; pixel + 4 <= pixelCount; pixel += 4)
+		{
+			const __m128i red = EncodeSrgb4(tables, _mm_load_ps(&block.channels[kRed][pixel]));
+			const __m128i green = EncodeSrgb4(tables, _mm_load_ps(&block.channels[1][pixel]));
+			const __m128i blue = EncodeSrgb4(tables, _mm_load_ps(&block.channels[kBlue][pixel]));
+
+			const __m128 clampedAlpha = _mm_min_ps(_mm_max_ps(_mm_load_ps(&block.channels[3][pixel]), _mm_setzero_ps()), _mm_set1_ps(1.f));
+			const __m128i alpha = _mm_cvtps_epi32(_mm_mul_ps(clampedAlpha, _mm_set1_ps(255.f)));
+
+			const __m128i packed = _mm_or_si128(_mm_or_si128(red, _mm_slli_epi32(green, 8)), _mm_or_si128(_mm_slli_epi32(blue, 16), _mm_slli_epi32(alpha, 24)));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(destination + pixel * 4), packed);
+		}
+
+		for (; pixel < pixelCount; ++pixel)
+		{
+			destination[pixel * 4] = EncodeSrgb(tables, block.channels[kRed][pixel]);
+			destination[pixel * 4 + 1] = EncodeSrgb(tables, block.channels[1][pixel]);
+			destination[pixel * 4 + 2] = EncodeSrgb(tables, block.channels[kBlue][pixel]);
+			destination[pixel * 4 + 3] = EncodeUnorm8(block.channels[3][pixel]);
+		}
+	}
+};
+
+struct AkRGB10A2Codec
+{
+	static void Decode(const uint8_t* source, AkPixelBlock& block, const size_t pixelCount)
+	{
+		const __m128i tenBits = _mm_set1_epi32(0x3FF);
+		const __m128 colorScale = _mm_set1_ps(1.f / 1023.f);
+
+		size_t pixel = 0;
+		for (; pixel + 4 <= pixelCount; pixel += 4)
+		{
+			const __m128i packed = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + pixel * 4));
+			_mm_store_ps(&block.channels[0][pixel], _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(packed, tenBits)), colorScale));
+			_mm_store_ps(&block.channels[1][pixel], _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(packed, 10), tenBits)), colorScale));
+			_mm_store_ps(&block.channels[2][pixel], _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(packed, 20), tenBits)), colorScale));
+			_mm_store_ps(&block.channels[3][pixel], _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(packed, 30)), _mm_set1_ps(1.f / 3.f)));
+		}
+
+		for (; pixel < pixelCount; ++pixel)
+		{
+			uint32_t packed = 0;
+			std::memcpy(&packed, source + pixel * 4, 4);
+			block.channels[0][pixel] = static_cast<float>(static_cast<int32_t>(packed & 0x3FF)) * (1.f / 1023.f);
+			block.channels[1][pixel] = static_cast<float>(static_cast<int32_t>((packed >> 10) & 0x3FF)) * (1.f / 1023.f);
+			block.channels[2][pixel] = static_cast<float>(static_cast<int32_t>((packed >> 20) & 0x3FF)) * (1.f / 1023.f);
+			block.channels[3][pixel] = static_cast<float>(static_cast<int32_t>(packed >> 30)) * (1.f / 3.f);
+		}
+	}
+
+	static void Encode(const AkPixelBlock& block, uint8_t* destination, const size_t pixelCount)
+	{
+		const auto quantize = [](const __m128 values, const float maximum)
+		{
+			return _mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(values, _mm_setzero_ps()), _mm_set1_ps(1.f)), _mm_set1_ps(maximum)));
+		};
+
+		size_t pixel = 0;
+		for (; pixel + 4 <= pixelCount; pixel += 4)
+		{
+			const __m128i red = quantize(_mm_load_ps(&block.channels[0][pixel]), 1023.f);
+			const __m128i green = quantize(_mm_load_ps(&block.channels[1][pixel]), 1023.f);
+			const __m128i blue = quantize(_mm_load_ps(&block.channels[2][pixel]), 1023.f);
+			const __m128i alpha = quantize(_mm_load_ps(&block.channels[3][pixel]), 3.f);
+
+			const __m128i packed = _mm_or_si128(_mm_or_si128(red, _mm_slli_epi32(green, 10)), _mm_or_si128(_mm_slli_epi32(blue, 20), _mm_slli_epi32(alpha, 30)));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(destination + pixel * 4), packed);
+		}
+
+		for (; pixel < pixelCount; ++pixel)
+		{
+			const auto quantizeScalar = [&block, pixel](const uint32_t channel, const float maximum)
+			{
+				return static_cast<uint32_t>(std::nearbyint(MinSse(MaxSse(block.channels[channel][pixel], 0.f), 1.f) * maximum));
+			};
+
+			const uint32_t packed = quantizeScalar(0, 1023.f) | (quantizeScalar(1, 1023.f) << 10) | (quantizeScalar(2, 1023.f) << 20) | (quantizeScalar(3, 3.f) << 30);
+			std::memcpy(destination + pixel * 4, &packed, 4);
+		}
+	}
+};
+
+// -- Direct kernels for byte formats
+
+static void SwapRedBlue8(const uint8_t* source, uint8_t* destination, const size_t pixelCount)
+{
+	const __m128i swizzle = _mm_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+
+	size_t pixel = 0;
+	for (; pixel + 4 <= pixelCount; pixel += 4)
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(destination + pixel * 4), _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(source + pixel * 4)), swizzle));
+
+	for (; pixel < pixelCount; ++pixel)
+	{
+		destination[pixel * 4] = source[pixel * 4 + 2];
+		destination[pixel * 4 + 1] = source[pixel * 4 + 1];
+		destination[pixel * 4 + 2] = source[pixel * 4];
+		destination[pixel * 4 + 3] = source[pixel * 4 + 3];
+	}
+}
+
+// A 256 entry byte table is looked up as 16 shuffles of 16 entries, every lane keeping the one selected by its high nibble
+template<bool kEncode, bool kSwapRedBlue>
+static void TransferSrgb8(const uint8_t* source, uint8_t* destination, const size_t pixelCount)
+{
+	const AkSrgbTables& tables = GetSrgbTables();
+	const uint8_t* table = kEncode ? tables.srgbFromUnorm8.data() : tables.unorm8FromSrgb.data();
+
+	__m128i tableSlices[16];
+	for (uint32_t i = 0; i < 16; ++i)
+		tableSlices[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(table + i * 16));
+
+	const __m128i lowNibbleMask = _mm_set1_epi8(0x0F);
+	const __m128i alphaMask = _mm_set1_epi32(static_cast<int32_t>(0xFF000000u));
+	const __m128i swizzle = kSwapRedBlue ? _mm_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15) : _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+
+	size_t pixel = 0;
+	for (; pixel + 4 <= pixelCount; pixel += 4)
+	{
+		const __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + pixel * 4));
+		const __m128i lowNibbles = _mm_and_si128(values, lowNibbleMask);
+		const __m128i highNibbles = _mm_and_si128(_mm_srli_epi16(values, 4), lowNibbleMask);
+
+		__m128i transferred = _mm_setzero_si128();
+		for (uint32_t i = 0; i < 16; ++i)
+		{
+			const __m128i isSlice = _mm_cmpeq_epi8(highNibbles, _mm_set1_epi8(static_cast<char>(i)));
+			transferred = _mm_or_si128(transferred, _mm_and_si128(isSlice, _mm_shuffle_epi8(tableSlices[i], lowNibbles)));
+		}
+
+		const __m128i result = _mm_blendv_epi8(transferred, values, alphaMask);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(destination + pixel * 4), _mm_shuffle_epi8(result, swizzle));
+	}
+
+	for (; pixel < pixelCount; ++pixel)
+	{
+		const uint32_t red = kSwapRedBlue ? 2 : 0;
+		const uint32_t blue = kSwapRedBlue ? 0 : 2;
+		destination[pixel * 4 + red] = table[source[pixel * 4]];
+		destination[pixel * 4 + 1] = table[source[pixel * 4 + 1]];
+		destination[pixel * 4 + blue] = table[source[pixel * 4 + 2]];
+		destination[pixel * 4 + 3] = source[pixel * 4 + 3];
+	}
+}
+
+// -- Dispatch table
+
+struct AkPixelCodec
+{
+	AkPixelFormat format = AkPixelFormat::UNDEFINED;
+	AkPixelDecodeFunction decode = nullptr;
+	AkPixelEncodeFunction encode = nullptr;
+};
+
+template<typename TCodec>
+static constexpr AkPixelCodec MakeCodec(const AkPixelFormat format)
+{
+	return { format, &TCodec::Decode, &TCodec::Encode };
+}
+
+static constexpr std::array kPixelCodecs = std::to_array<AkPixelCodec>(
+{
+	MakeCodec<AkInterleavedCodec<AkUnormElement<uint8_t>, 1>>(AkPixelFormat::R8_UNORM),
+	MakeCodec<AkInterleavedCodec<AkSnormElement<int8_t>, 1>>(AkPixelFormat::R8_SNORM),
+	MakeCodec<AkInterleavedCodec<AkUnormElement<uint8_t>, 2>>(AkPixelFormat::RG8_UNORM),
+	MakeCodec<AkInterleavedCodec<AkSnormElement<int8_t>, 2>>(AkPixelFormat::RG8_SNORM),
+	MakeCodec<AkInterleavedCodec<AkUnormElement<uint8_t>, 4>>(AkPixelFormat::RGBA8_UNORM),
+	MakeCodec<AkInterleavedCodec<AkSnormElement<int8_t>, 4>>(AkPixelFormat::RGBA8_SNORM),
+	MakeCodec<AkSrgb8Codec<false>>(AkPixelFormat::RGBA8_SRGB),
+	MakeCodec<AkInterleavedCodec<AkUnormElement<uint8_t>, 4, true>>(AkPixelFormat::BGRA8_UNORM),
+	MakeCodec<AkSrgb8Codec<true>>(AkPixelFormat::BGRA8_SRGB),
+	MakeCodec<AkRGB10A2Codec>(AkPixelFormat::R10G10B10A2_UNORM),
+	MakeCodec<AkInterleavedCodec<AkUnormElement<uint16_t>, 1>>(AkPixelFormat::R16_UNORM),
+	MakeCodec<AkInterleavedCodec<AkSnormElement<int16_t>, 1>>(AkPixelFormat::R16_SNORM),
+	MakeCodec<AkInterleavedCodec<AkFloat16Element, 1>>(AkPixelFormat::R16_FLOAT),
+	MakeCodec<AkInterleavedCodec<AkUnormElement<uint16_t>, 2>>(AkPixelFormat::RG16_UNORM),
+	MakeCodec<AkInterleavedCodec<AkSnormElement<int16_t>, 2>>(AkPixelFormat::RG16_SNORM),
+	MakeCodec<AkInterleavedCodec<AkFloat16Element, 2>>(AkPixelFormat::RG16_FLOAT),
+	MakeCodec<AkInterleavedCodec<AkUnormElement<uint16_t>, 4>>(AkPixelFormat::RGBA16_UNORM),
+	MakeCodec<AkInterleavedCodec<AkSnormElement<int16_t>, 4>>(AkPixelFormat::RGBA16_SNORM),
+	MakeCodec<AkInterleavedCodec<AkFloat16Element, 4>>(AkPixelFormat::RGBA16_FLOAT),
+	MakeCodec<AkInterleavedCodec<AkFloat32Element, 1>>(AkPixelFormat::R32_FLOAT),
+	MakeCodec<AkInterleavedCodec<AkFloat32Element, 2>>(AkPixelFormat::RG32_FLOAT),
+	MakeCodec<AkInterleavedCodec<AkFloat32Element, 4>>(AkPixelFormat::RGBA32_FLOAT)
+});
+
+// A direct kernel replaces the float round trip, otherwise the codecs of both formats are chained block by block
+struct AkPixelConversion
+{
+	AkPixelConvertFunction kernel = nullptr;
+	AkPixelDecodeFunction decode = nullptr;
+	AkPixelEncodeFunction encode = nullptr;
+
+	bool IsValid() const { return kernel != nullptr || (decode != nullptr && encode != nullptr); }
+};
+
+struct AkPixelConversionTable
+{
+	static constexpr uint8_t kNoCodec = UINT8_MAX;
+
+	std::array<uint8_t, kPixelFormatCount> codecIndices = {};
+	std::array<std::array<AkPixelConversion, kPixelCodecs.size()>, kPixelCodecs.size()> conversions = {};
+
+	const AkPixelConversion* Find(const AkPixelFormat sourceFormat, const AkPixelFormat destinationFormat) const
+	{
+		const uint8_t sourceIndex = codecIndices[static_cast<size_t>(sourceFormat)];
+		const uint8_t destinationIndex = codecIndices[static_cast<size_t>(destinationFormat)];
+		if (sourceIndex == kNoCodec || destinationIndex == kNoCodec)
+			return nullptr;
+
+		return &conversions[sourceIndex][destinationIndex];
+	}
+};
+
+static const AkPixelConversionTable& GetConversionTable()
+{
+	static const AkPixelConversionTable sTable = []()
+	{
+		AkPixelConversionTable table;
+		table.codecIndices.fill(AkPixelConversionTable::kNoCodec);
+
+		for (uint8_t source = 0; source < kPixelCodecs.size(); ++source)
+		{
+			table.codecIndices[static_cast<size_t>(kPixelCodecs[source].format)] = source;
+			for (uint8_t destination = 0; destination < kPixelCodecs.size(); ++destination)
+				table.conversions[source][destination] = { .decode = kPixelCodecs[source].decode, .encode = kPixelCodecs[destination].encode };
+		}
+
+		const auto setKernel = [&table](const AkPixelFormat sourceFormat, const AkPixelFormat destinationFormat, const AkPixelConvertFunction kernel)
+		{
+			const uint8_t sourceIndex = table.codecIndices[static_cast<size_t>(sourceFormat)];
+			const uint8_t destinationIndex = table.codecIndices[static_cast<size_t>(destinationFormat)];
+			table.conversions[sourceIndex][destinationIndex].kernel = kernel;
+		};
+
+		using enum AkPixelFormat;
+		setKernel(RGBA8_UNORM, BGRA8_UNORM, &SwapRedBlue8);
+		setKernel(BGRA8_UNORM, RGBA8_UNORM, &SwapRedBlue8);
+		setKernel(RGBA8_SRGB, BGRA8_SRGB, &SwapRedBlue8);
+		setKernel(BGRA8_SRGB, RGBA8_SRGB, &SwapRedBlue8);
+
+		setKernel(RGBA8_UNORM, RGBA8_SRGB, &TransferSrgb8<true, false>);
+		setKernel(BGRA8_UNORM, BGRA8_SRGB, &TransferSrgb8<true, false>);
+		setKernel(RGBA8_UNORM, BGRA8_SRGB, &TransferSrgb8<true, true>);
+		setKernel(BGRA8_UNORM, RGBA8_SRGB, &TransferSrgb8<true, true>);
+
+		setKernel(RGBA8_SRGB, RGBA8_UNORM, &TransferSrgb8<false, false>);
+		setKernel(BGRA8_SRGB, BGRA8_UNORM, &TransferSrgb8<false, false>);
+		setKernel(RGBA8_SRGB, BGRA8_UNORM, &TransferSrgb8<false, true>);
+		setKernel(BGRA8_SRGB, RGBA8_UNORM, &TransferSrgb8<false, true>);
+		return table;
+	}();
+
+	return sTable;
+}
+
+static void ConvertRange(const AkPixelConversion& conversion, const uint8_t* source, const size_t sourcePixelSize, uint8_t* destination, const size_t destinationPixelSize, const size_t pixelCount)
+{
+	if (conversion.kernel != nullptr)
+	{
+		conversion.kernel(source, destination, pixelCount);
+		return;
+	}
+
+	AkPixelBlock block;
+	for (size_t pixel = 0; pixel < pixelCount; pixel += kBlockPixels)
+	{
+		const size_t blockPixelCount = std::min(kBlockPixels, pixelCount - pixel);
+		conversion.decode(source + pixel * sourcePixelSize, block, blockPixelCount);
+		conversion.encode(block, destination + pixel * destinationPixelSize, blockPixelCount);
+	}
+}
+
+bool AkPixelConverter::IsConversionSupported(const AkPixelFormat sourceFormat, const AkPixelFormat destinationFormat)
+{
+	const AkPixelConversion* conversion = GetConversionTable().Find(sourceFormat, destinationFormat);
+	return conversion != nullptr && conversion->IsValid();
+}
+
+bool AkPixelConverter::Convert(std::span<const uint8_t> source, const AkPixelFormat sourceFormat, std::span<uint8_t> destination, const AkPixelFormat destinationFormat, const size_t pixelCount)
+{
+	const AkPixelConversion* conversion = GetConversionTable().Find(sourceFormat, destinationFormat);
+	if (conversion == nullptr || !conversion->IsValid())
+	{
+		AkLogError("No conversion from pixel format {} to {}", static_cast<uint32_t>(sourceFormat), static_cast<uint32_t>(destinationFormat));
+		return false;
+	}
+
+	const size_t sourcePixelSize = GetPixelSize(sourceFormat);
+	const size_t destinationPixelSize = GetPixelSize(destinationFormat);
+	if (source.size() < pixelCount * sourcePixelSize || destination.size() < pixelCount * destinationPixelSize)
+	{
+		AkLogError("The buffers are too small to convert {} pixels", pixelCount);
+		return false;
+	}
+
+	if (sourceFormat == destinationFormat)
+	{
+		std::memcpy(destination.data(), source.data(), pixelCount * sourcePixelSize);
+		return true;
+	}
+
+	const uint32_t jobCount = static_cast<uint32_t>((pixelCount + kPixelsPerJob - 1) / kPixelsPerJob);
+	AkJobSystem::ParallelFor(jobCount, [&](const uint32_t job)
+	{
+		const size_t firstPixel = job * kPixelsPerJob;
+		ConvertRange(*conversion, source.data() + firstPixel * sourcePixelSize, sourcePixelSize, destination.data() + firstPixel * destinationPixelSize, destinationPixelSize, std::min(kPixelsPerJob, pixelCount - firstPixel));
+	});
+
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,18 @@
+#pragma once
+#include "PixelFormats.h"
+
+#include <span>
+#include <cstdint>
+
+// Converts pixels between uncompressed formats with SIMD kernels, picked once per format pair from a dispatch table.
+// Byte formats that only differ in channel order or transfer function are converted directly, every other pair goes through blocks of RGBA floats.
+// Missing channels read as zero and alpha as one, values are clamped to the range of the destination and rounded to nearest even.
+// sRGB only applies to the color channels and is encoded with exact rounding, so direct and float conversions give the same bytes.
+class AkPixelConverter
+{
+public:
+	static bool IsConversionSupported(const AkPixelFormat sourceFormat, const AkPixelFormat destinationFormat);
+
+	// Large conversions are split across the job system, source and destination must not overlap
+	static bool Convert(std::span<const uint8_t> source, const AkPixelFormat sourceFormat, std::span<uint8_t> destination, const AkPixelFormat destinationFormat, const size_t pixelCount);
+};
\ No newline at end of file
@@ -1,6 +1,10 @@
 #pragma once
 #include "Core/Assert.h"
 
+#include <array>
+#include <cstdint>
+#include <type_traits>
+
 enum class AkPixelFormat
 {
 	UNDEFINED,
@@ -86,40 +90,123 @@ enum class AkPixelFormat
 	D16_UNORM
 };
 
-inline constexpr bool IsSRGB(const AkPixelFormat format)
+inline constexpr size_t kPixelFormatCount = static_cast<size_t>(AkPixelFormat::D16_UNORM) + 1;
+
+enum AkPixelFormatTraitBits
+{
+	AkPixelFormatTraits_SRGB				= 1 << 0,
+	AkPixelFormatTraits_HAS_SRGB			= 1 << 1,
+	AkPixelFormatTraits_HDR					= 1 << 2,
+	AkPixelFormatTraits_BLOCK_COMPRESSED	= 1 << 3,
+	AkPixelFormatTraits_DEPTH				= 1 << 4,
+	AkPixelFormatTraits_STENCIL				= 1 << 5
+};
+using AkPixelFormatTraitFlags = std::underlying_type_t<AkPixelFormatTraitBits>;
+
+// Block compressed formats give the size of a 4x4 block instead of a pixel
+struct AkPixelFormatTraits
 {
-	switch (format)
+	AkPixelFormat format = AkPixelFormat::UNDEFINED;
+	uint8_t byteSize = 0;
+	uint8_t channelCount = 0;
+	AkPixelFormatTraitFlags flags = 0;
+};
+
+// Tables indexed by pixel format list every format in declaration order, so a lookup is a single load
+template<typename TEntry, size_t kEntryCount>
+consteval bool IsIndexedByPixelFormat(const std::array<TEntry, kEntryCount>& table)
+{
+	if (kEntryCount != kPixelFormatCount)
+		return false;
+
+	for (size_t i = 0; i < kEntryCount; ++i)
 	{
-		case AkPixelFormat::RGBA8_SRGB:
-		case AkPixelFormat::BGRA8_SRGB:
-		case AkPixelFormat::BC1_RGB_SRGB:
-		case AkPixelFormat::BC1_RGBA_SRGB:
-		case AkPixelFormat::BC2_SRGB:
-		case AkPixelFormat::BC3_SRGB:
-		case AkPixelFormat::BC7_SRGB:
-			return true;
-
-		default:
+		if (table[i].format != static_cast<AkPixelFormat>(i))
 			return false;
 	}
+
+	return true;
+}
+
+inline constexpr std::array kPixelFormatTraits = std::to_array<AkPixelFormatTraits>(
+{
+	{ AkPixelFormat::UNDEFINED,			0,	0,	0 },
+	{ AkPixelFormat::R8_UINT,			1,	1,	0 },
+	{ AkPixelFormat::R8_SINT,			1,	1,	0 },
+	{ AkPixelFormat::R8_UNORM,			1,	1,	0 },
+	{ AkPixelFormat::R8_SNORM,			1,	1,	0 },
+	{ AkPixelFormat::RG8_UINT,			2,	2,	0 },
+	{ AkPixelFormat::RG8_SINT,			2,	2,	0 },
+	{ AkPixelFormat::RG8_UNORM,			2,	2,	0 },
+	{ AkPixelFormat::RG8_SNORM,			2,	2,	0 },
+	{ AkPixelFormat::RGBA8_UINT,		4,	4,	0 },
+	{ AkPixelFormat::RGBA8_SINT,		4,	4,	0 },
+	{ AkPixelFormat::RGBA8_SNORM,		4,	4,	0 },
+	{ AkPixelFormat::RGBA8_UNORM,		4,	4,	AkPixelFormatTraits_HAS_SRGB },
+	{ AkPixelFormat::RGBA8_SRGB,		4,	4,	AkPixelFormatTraits_SRGB },
+	{ AkPixelFormat::BGRA8_UNORM,		4,	4,	AkPixelFormatTraits_HAS_SRGB },
+	{ AkPixelFormat::BGRA8_SRGB,		4,	4,	AkPixelFormatTraits_SRGB },
+	{ AkPixelFormat::R10G10B10A2_UNORM,	4,	4,	AkPixelFormatTraits_HDR },
+	{ AkPixelFormat::R16_UINT,			2,	1,	AkPixelFormatTraits_HDR },
+	{ AkPixelFormat::R16_SINT,			2,	1,	AkPixelFormatTraits_HDR },
+	{ AkPixelFormat::R16_UNORM,			2,	1,	AkPixelFormatTraits_HDR },
+	{ AkPixelFormat::R16_SNORM,			2,	1,	AkPixelFormatTraits_HDR },
+	{ AkPixelFormat::R16_FLOAT,			2,	1,	AkPixelFormatTraits_HDR },
+	{ AkPixelFormat::RG16_UINT,			4,	2,	AkPixelFormatTraits_HDR },
+	{ AkPixelFormat::RG16_SINT,			4,	2,	AkPixelFormatTraits_HDR },
+	{ AkPixelFormat::RG16_UNORM,		4,	2,	AkPixelFormatTraits_HDR },
+	{ AkPixelFormat::RG16_SNORM,		4,	2,	AkPixelFormatTraits_HDR },
+	{ AkPixelFormat::RG16_FLOAT,		4,	2,	AkPixelFormatTraits_HDR },
+	{ AkPixelFormat::RGBA16_UINT,		8,	4,	AkPixelFormatTraits_HDR },
+	{ AkPixelFormat::RGBA16_SINT,		8,	4,	AkPixelFormatTraits_HDR },
+	{ AkPixelFormat::RGBA16_UNORM,		8,	4,	AkPixelFormatTraits_HDR },
+	{ AkPixelFormat::RGBA16_SNORM,		8,	4,	AkPixelFormatTraits_HDR },
+	{ AkPixelFormat::RGBA16_FLOAT,		8,	4,	AkPixelFormatTraits_HDR },
+	{ AkPixelFormat::R32_UINT,			4,	1,	AkPixelFormatTraits_HDR },
+	{ AkPixelFormat::R32_SINT,			4,	1,	AkPixelFormatTraits_HDR },
+	{ AkPixelFormat::R32_FLOAT,			4,	1,	AkPixelFormatTraits_HDR },
+	{ AkPixelFormat::RG32_UINT,			8,	2,	AkPixelFormatTraits_HDR },
+	{ AkPixelFormat::RG32_SINT,			8,	2,	AkPixelFormatTraits_HDR },
+	{ AkPixelFormat::RG32_FLOAT,		8,	2,	AkPixelFormatTraits_HDR },
+	{ AkPixelFormat::RGBA32_UINT,		16,	4,	AkPixelFormatTraits_HDR },
+	{ AkPixelFormat::RGBA32_SINT,		16,	4,	AkPixelFormatTraits_HDR },
+	{ AkPixelFormat::RGBA32_FLOAT,		16,	4,	AkPixelFormatTraits_HDR },
+	{ AkPixelFormat::BC1_RGB_UNORM,		8,	3,	AkPixelFormatTraits_BLOCK_COMPRESSED | AkPixelFormatTraits_HAS_SRGB },
+	{ AkPixelFormat::BC1_RGB_SRGB,		8,	3,	AkPixelFormatTraits_BLOCK_COMPRESSED | AkPixelFormatTraits_SRGB },
+	{ AkPixelFormat::BC1_RGBA_UNORM,	8,	4,	AkPixelFormatTraits_BLOCK_COMPRESSED | AkPixelFormatTraits_HAS_SRGB },
+	{ AkPixelFormat::BC1_RGBA_SRGB,		8,	4,	AkPixelFormatTraits_BLOCK_COMPRESSED | AkPixelFormatTraits_SRGB },
+	{ AkPixelFormat::BC2_UNORM,			16,	4,	AkPixelFormatTraits_BLOCK_COMPRESSED | AkPixelFormatTraits_HAS_SRGB },
+	{ AkPixelFormat::BC2_SRGB,			16,	4,	AkPixelFormatTraits_BLOCK_COMPRESSED | AkPixelFormatTraits_SRGB },
+	{ AkPixelFormat::BC3_UNORM,			16,	4,	AkPixelFormatTraits_BLOCK_COMPRESSED | AkPixelFormatTraits_HAS_SRGB },
+	{ AkPixelFormat::BC3_SRGB,			16,	4,	AkPixelFormatTraits_BLOCK_COMPRESSED | AkPixelFormatTraits_SRGB },
+	{ AkPixelFormat::BC4_UNORM,			8,	1,	AkPixelFormatTraits_BLOCK_COMPRESSED },
+	{ AkPixelFormat::BC4_SNORM,			8,	1,	AkPixelFormatTraits_BLOCK_COMPRESSED },
+	{ AkPixelFormat::BC5_UNORM,			16,	2,	AkPixelFormatTraits_BLOCK_COMPRESSED },
+	{ AkPixelFormat::BC5_SNORM,			16,	2,	AkPixelFormatTraits_BLOCK_COMPRESSED },
+	{ AkPixelFormat::BC6H_UF16,			16,	4,	AkPixelFormatTraits_BLOCK_COMPRESSED },
+	{ AkPixelFormat::BC6H_SF16,			16,	4,	AkPixelFormatTraits_BLOCK_COMPRESSED },
+	{ AkPixelFormat::BC7_UNORM,			16,	4,	AkPixelFormatTraits_BLOCK_COMPRESSED | AkPixelFormatTraits_HAS_SRGB },
+	{ AkPixelFormat::BC7_SRGB,			16,	4,	AkPixelFormatTraits_BLOCK_COMPRESSED | AkPixelFormatTraits_SRGB },
+	{ AkPixelFormat::D32_SFLOAT_S8_UINT,	5,	2,	AkPixelFormatTraits_DEPTH | AkPixelFormatTraits_STENCIL },
+	{ AkPixelFormat::D32_SFLOAT,		4,	1,	AkPixelFormatTraits_DEPTH },
+	{ AkPixelFormat::D24_UNORM_S8_UINT,	4,	2,	AkPixelFormatTraits_DEPTH | AkPixelFormatTraits_STENCIL },
+	{ AkPixelFormat::D16_UNORM,			2,	1,	AkPixelFormatTraits_DEPTH }
+});
+static_assert(IsIndexedByPixelFormat(kPixelFormatTraits), "Every pixel format needs its traits, in declaration order");
+
+inline constexpr const AkPixelFormatTraits& GetPixelFormatTraits(const AkPixelFormat format)
+{
+	return kPixelFormatTraits[static_cast<size_t>(format)];
+}
+
+inline constexpr bool IsSRGB(const AkPixelFormat format)
+{
+	return GetPixelFormatTraits(format).flags & AkPixelFormatTraits_SRGB;
 }
 
 inline constexpr bool SupportsSRGB(const AkPixelFormat format)
 {
-	switch (format)
-	{
-		case AkPixelFormat::RGBA8_UNORM:
-		case AkPixelFormat::BGRA8_UNORM:
-		case AkPixelFormat::BC1_RGB_UNORM:
-		case AkPixelFormat::BC1_RGBA_UNORM:
-		case AkPixelFormat::BC2_UNORM:
-		case AkPixelFormat::BC3_UNORM:
-		case AkPixelFormat::BC7_UNORM:
-			return true;
-
-		default:
-			return false;
-	}
+	return GetPixelFormatTraits(format).flags & AkPixelFormatTraits_HAS_SRGB;
 }
 
 inline constexpr AkPixelFormat GetSRGB(const AkPixelFormat format)
@@ -134,224 +221,60 @@ inline constexpr AkPixelFormat GetSRGB(const AkPixelFormat format)
 		return format;
 }
 
+inline constexpr AkPixelFormat GetLinear(const AkPixelFormat format)
+{
+	if (IsSRGB(format))
+	{
+		AkPixelFormat returnFormat = static_cast<AkPixelFormat>(static_cast<uint32_t>(format) - 1);
+		AkAssert(SupportsSRGB(returnFormat), "Return pixel format is not the linear counterpart.");
+		return returnFormat;
+	}
+	else
+		return format;
+}
+
 inline constexpr bool IsDepthPixelFormat(const AkPixelFormat format)
 {
-	return format >= AkPixelFormat::D32_SFLOAT_S8_UINT;
+	return GetPixelFormatTraits(format).flags & AkPixelFormatTraits_DEPTH;
 }
 
 inline constexpr bool PixelFormatHasStencil(const AkPixelFormat format)
 {
-	return format == AkPixelFormat::D32_SFLOAT_S8_UINT
-		|| format == AkPixelFormat::D24_UNORM_S8_UINT;
+	return GetPixelFormatTraits(format).flags & AkPixelFormatTraits_STENCIL;
 }
 
 inline constexpr bool IsHDRPixelFormat(const AkPixelFormat format)
 {
-	return format >= AkPixelFormat::R10G10B10A2_UNORM && format <= AkPixelFormat::RGBA32_FLOAT;
+	return GetPixelFormatTraits(format).flags & AkPixelFormatTraits_HDR;
 }
 
 inline constexpr bool IsBlockCompressedPixelFormat(const AkPixelFormat format)
 {
-	return format >= AkPixelFormat::BC1_RGB_UNORM && format <= AkPixelFormat::BC7_SRGB;
+	return GetPixelFormatTraits(format).flags & AkPixelFormatTraits_BLOCK_COMPRESSED;
 }
 
 inline constexpr size_t GetPixelSize(const AkPixelFormat format)
 {
-	switch (format)
-	{
-		default:
-			AkRaise("Pixel format not registered on this function");
-			return 0;
-
-		case AkPixelFormat::R8_UINT:
-		case AkPixelFormat::R8_SINT:
-		case AkPixelFormat::R8_UNORM:
-		case AkPixelFormat::R8_SNORM:
-			return 1;
-
-		case AkPixelFormat::RG8_UINT:
-		case AkPixelFormat::RG8_SINT:
-		case AkPixelFormat::RG8_UNORM:
-		case AkPixelFormat::RG8_SNORM:
-
-		case AkPixelFormat::R16_UINT:
-		case AkPixelFormat::R16_SINT:
-		case AkPixelFormat::R16_UNORM:
-		case AkPixelFormat::R16_SNORM:
-		case AkPixelFormat::R16_FLOAT:
-
-		case AkPixelFormat::D16_UNORM:
-			return 2;
-
-		case AkPixelFormat::RGBA8_UINT:
-		case AkPixelFormat::RGBA8_SINT:
-		case AkPixelFormat::RGBA8_UNORM:
-		case AkPixelFormat::RGBA8_SNORM:
-		case AkPixelFormat::RGBA8_SRGB:
-
-		case AkPixelFormat::BGRA8_UNORM:
-		case AkPixelFormat::BGRA8_SRGB:
-
-		case AkPixelFormat::R10G10B10A2_UNORM:
-
-		case AkPixelFormat::RG16_UINT:
-		case AkPixelFormat::RG16_SINT:
-		case AkPixelFormat::RG16_UNORM:
-		case AkPixelFormat::RG16_SNORM:
-		case AkPixelFormat::RG16_FLOAT:
-
-		case AkPixelFormat::R32_UINT:
-		case AkPixelFormat::R32_SINT:
-		case AkPixelFormat::R32_FLOAT:
-
-		case AkPixelFormat::D32_SFLOAT:
-		case AkPixelFormat::D24_UNORM_S8_UINT:
-			return 4;
-
-		case AkPixelFormat::D32_SFLOAT_S8_UINT:
-			return 5;
-
-		case AkPixelFormat::RGBA16_UINT:
-		case AkPixelFormat::RGBA16_SINT:
-		case AkPixelFormat::RGBA16_UNORM:
-		case AkPixelFormat::RGBA16_SNORM:
-		case AkPixelFormat::RGBA16_FLOAT:
-
-		case AkPixelFormat::RG32_UINT:
-		case AkPixelFormat::RG32_SINT:
-		case AkPixelFormat::RG32_FLOAT:
-			return 8;
-
-		case AkPixelFormat::RGBA32_UINT:
-		case AkPixelFormat::RGBA32_SINT:
-		case AkPixelFormat::RGBA32_FLOAT:
-			return 16;
-	}
+	AkAssert(format != AkPixelFormat::UNDEFINED && !IsBlockCompressedPixelFormat(format), "Pixel format has no pixel size");
+	return GetPixelFormatTraits(format).byteSize;
 }
 
 inline constexpr size_t GetCompressedBlockSize(const AkPixelFormat format)
 {
-	switch (format)
-	{
-		default:
-			AkRaise("Pixel format not registered on this function");
-			return 0;
-
-		case AkPixelFormat::BC1_RGB_UNORM:
-		case AkPixelFormat::BC1_RGB_SRGB:
-
-		case AkPixelFormat::BC1_RGBA_UNORM:
-		case AkPixelFormat::BC1_RGBA_SRGB:
-
-		case AkPixelFormat::BC4_UNORM:
-		case AkPixelFormat::BC4_SNORM:
-			return 8;
-
-		case AkPixelFormat::BC2_UNORM:
-		case AkPixelFormat::BC2_SRGB:
-
-		case AkPixelFormat::BC3_UNORM:
-		case AkPixelFormat::BC3_SRGB:
-
-		case AkPixelFormat::BC5_UNORM:
-		case AkPixelFormat::BC5_SNORM:
-
-		case AkPixelFormat::BC6H_UF16:
-		case AkPixelFormat::BC6H_SF16:
-
-		case AkPixelFormat::BC7_UNORM:
-		case AkPixelFormat::BC7_SRGB:
-			return 16;
-	}
+	AkAssert(IsBlockCompressedPixelFormat(format), "Pixel format is not block compressed");
+	return GetPixelFormatTraits(format).byteSize;
 }
 
 inline constexpr size_t GetChannelCount(const AkPixelFormat format)
 {
-	switch (format)
-	{
-		default:
-			AkRaise("Pixel format not registered on this function");
-			return 0;
-
-		case AkPixelFormat::BC4_UNORM:
-		case AkPixelFormat::BC4_SNORM:
-
-		case AkPixelFormat::R8_UINT:
-		case AkPixelFormat::R8_SINT:
-		case AkPixelFormat::R8_UNORM:
-		case AkPixelFormat::R8_SNORM:
-
-		case AkPixelFormat::R16_UINT:
-		case AkPixelFormat::R16_SINT:
-		case AkPixelFormat::R16_UNORM:
-		case AkPixelFormat::R16_SNORM:
-		case AkPixelFormat::R16_FLOAT:
-
-		case AkPixelFormat::R32_UINT:
-		case AkPixelFormat::R32_SINT:
-		case AkPixelFormat::R32_FLOAT:
-
-		case AkPixelFormat::D16_UNORM:
-		case AkPixelFormat::D32_SFLOAT:
-			return 1;
-
-		case AkPixelFormat::BC5_UNORM:
-		case AkPixelFormat::BC5_SNORM:
-
-		case AkPixelFormat::RG8_UINT:
-		case AkPixelFormat::RG8_SINT:
-		case AkPixelFormat::RG8_UNORM:
-		case AkPixelFormat::RG8_SNORM:
-
-		case AkPixelFormat::RG16_UINT:
-		case AkPixelFormat::RG16_SINT:
-		case AkPixelFormat::RG16_UNORM:
-		case AkPixelFormat::RG16_SNORM:
-		case AkPixelFormat::RG16_FLOAT:
-
-		case AkPixelFormat::RG32_UINT:
-		case AkPixelFormat::RG32_SINT:
-		case AkPixelFormat::RG32_FLOAT:
-
-		case AkPixelFormat::D24_UNORM_S8_UINT:
-		case AkPixelFormat::D32_SFLOAT_S8_UINT:
-			return 2;
-
-		case AkPixelFormat::BC1_RGB_UNORM:
-		case AkPixelFormat::BC1_RGB_SRGB:
-			return 3;
-
-		case AkPixelFormat::BC1_RGBA_UNORM:
-		case AkPixelFormat::BC1_RGBA_SRGB:
-		case AkPixelFormat::BC2_UNORM:
-		case AkPixelFormat::BC2_SRGB:
-		case AkPixelFormat::BC3_UNORM:
-		case AkPixelFormat::BC3_SRGB:
-		case AkPixelFormat::BC6H_UF16:
-		case AkPixelFormat::BC6H_SF16:
-		case AkPixelFormat::BC7_UNORM:
-		case AkPixelFormat::BC7_SRGB:
-
-		case AkPixelFormat::RGBA8_UINT:
-		case AkPixelFormat::RGBA8_SINT:
-		case AkPixelFormat::RGBA8_UNORM:
-		case AkPixelFormat::RGBA8_SNORM:
-		case AkPixelFormat::RGBA8_SRGB:
-
-		case AkPixelFormat::BGRA8_UNORM:
-		case AkPixelFormat::BGRA8_SRGB:
-
-		case AkPixelFormat::RGBA16_UINT:
-		case AkPixelFormat::RGBA16_SINT:
-		case AkPixelFormat::RGBA16_UNORM:
-		case AkPixelFormat::RGBA16_SNORM:
-		case AkPixelFormat::RGBA16_FLOAT:
-
-		case AkPixelFormat::RGBA32_UINT:
-		case AkPixelFormat::RGBA32_SINT:
-		case AkPixelFormat::RGBA32_FLOAT:
-
-		case AkPixelFormat::R10G10B10A2_UNORM:
-			return 4;
-	}
+	AkAssert(format != AkPixelFormat::UNDEFINED, "Undefined pixel format has no channels");
+	return GetPixelFormatTraits(format).channelCount;
+}
+
+inline constexpr size_t GetSurfaceByteSize(const AkPixelFormat format, const uint32_t width, const uint32_t height)
+{
+	if (IsBlockCompressedPixelFormat(format))
+		return GetCompressedBlockSize(format) * ((width + 3) / 4) * ((height + 3) / 4);
+
+	return GetPixelSize(format) * width * height;
 }
\ No newline at end of file
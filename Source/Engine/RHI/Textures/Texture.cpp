@@ -1,12 +1,184 @@
 #include "Texture.h"
+#include "Core/Log.h"
+#include "RHI/Device.h"
+#include "RHI/VulkanPipelineStates.h"
+#include "RHI/Memory/MemoryAllocator.h"
+#include "Utilities/Hash.h"
 
+#include <bit>
+#include <mutex>
+#include <algorithm>
+#include <unordered_map>
 #include <vulkan/vulkan.hpp>
 
+static bool IsCubeTextureType(const AkTextureType type)
+{
+	return type == AkTextureType::CUBEMAP || type == AkTextureType::CUBEMAP_ARRAY;
+}
+
+static vk::ImageType GetImageType(const AkTextureType type)
+{
+	switch (type)
+	{
+		case AkTextureType::TEXTURE_1D:
+		case AkTextureType::TEXTURE_ARRAY_1D:
+			return vk::ImageType::e1D;
+
+		case AkTextureType::TEXTURE_3D:
+			return vk::ImageType::e3D;
+
+		default:
+			return vk::ImageType::e2D;
+	}
+}
+
+static vk::ImageViewType GetImageViewType(const AkTextureType type, const uint32_t sliceCount)
+{
+	switch (type)
+	{
+		case AkTextureType::TEXTURE_1D:			return vk::ImageViewType::e1D;
+		case AkTextureType::TEXTURE_2D:			return vk::ImageViewType::e2D;
+		case AkTextureType::TEXTURE_3D:			return vk::ImageViewType::e3D;
+		case AkTextureType::TEXTURE_ARRAY_1D:	return vk::ImageViewType::e1DArray;
+		case AkTextureType::TEXTURE_ARRAY_2D:	return vk::ImageViewType::e2DArray;
+
+		// Ranges that do not cover whole cubes are viewed as faces, to render into them
+		case AkTextureType::CUBEMAP:
+		case AkTextureType::CUBEMAP_ARRAY:
+		{
+			if (sliceCount == 1)
+				return vk::ImageViewType::e2D;
+
+			if (sliceCount % 6 != 0)
+				return vk::ImageViewType::e2DArray;
+
+			return type == AkTextureType::CUBEMAP && sliceCount == 6 ? vk::ImageViewType::eCube : vk::ImageViewType::eCubeArray;
+		}
+
+		default:
+			AkLogCritical("Texture type not registered on this function");
+			return vk::ImageViewType::e2D;
+	}
+}
+
+static vk::SampleCountFlagBits GetSampleCount(const AkMSAA msaa)
+{
+	switch (msaa)
+	{
+		case AkMSAA::X1:	return vk::SampleCountFlagBits::e1;
+		case AkMSAA::X2:	return vk::SampleCountFlagBits::e2;
+		case AkMSAA::X4:	return vk::SampleCountFlagBits::e4;
+		case AkMSAA::X8:	return vk::SampleCountFlagBits::e8;
+
+		default:
+			AkLogCritical("MSAA sample count not registered on this function");
+			return vk::SampleCountFlagBits::e1;
+	}
+}
+
+// Resolving and rendering into sub resources only depend on the views and passes, they add no usage
+static vk::ImageUsageFlags GetImageUsage(const AkTextureFlags flags)
+{
+	vk::ImageUsageFlags usage = {};
+	if (flags & AkTextureFlags_BIND_AS_SHADER_RESOURCE)	usage |= vk::ImageUsageFlagBits::eSampled;
+	if (flags & AkTextureFlags_BIND_AS_DEPTH_STENCIL)	usage |= vk::ImageUsageFlagBits::eDepthStencilAttachment;
+	if (flags & AkTextureFlags_BIND_AS_RENDER_TARGET)	usage |= vk::ImageUsageFlagBits::eColorAttachment;
+	if (flags & AkTextureFlags_ALLOW_UNORDERED_ACCESS)	usage |= vk::ImageUsageFlagBits::eStorage;
+	if (flags & AkTextureFlags_COPY_DESTINATION)		usage |= vk::ImageUsageFlagBits::eTransferDst;
+	if (flags & AkTextureFlags_COPY_SOURCE)				usage |= vk::ImageUsageFlagBits::eTransferSrc;
+
+	return usage;
+}
+
+// Compared in full on lookup, two views must never share an entry because their hashes collide
+struct AkTextureViewKey
+{
+	uint32_t baseMip = 0;
+	uint32_t mipCount = 0;
+	uint32_t baseSlice = 0;
+	uint32_t sliceCount = 0;
+	AkPixelFormat format = AkPixelFormat::UNDEFINED;
+
+	bool operator==(const AkTextureViewKey& other) const = default;
+};
+
+struct AkTextureViewKeyHash
+{
+	size_t operator()(const AkTextureViewKey& key) const
+	{
+		return HashValues(key.baseMip, key.mipCount, key.baseSlice, key.sliceCount, static_cast<uint32_t>(key.format));
+	}
+};
+
 struct AkTextureStorage
 {
 	vk::Image image = nullptr;
+	AkMemoryAllocation allocation = {};
+	bool isOwned = false;
+
+	std::mutex viewsMutex;
+	std::unordered_map<AkTextureViewKey, vk::ImageView, AkTextureViewKeyHash> views;
 };
 
+AkTexture::AkTexture(const AkTextureDescriptor& descriptor)
+	: m_Descriptor(Normalize(descriptor))
+{
+	AkAssert(!IsCubeTextureType(m_Descriptor.type) || m_Descriptor.slices % 6 == 0, "Cube textures must have a multiple of six slices");
+
+	vk::ImageCreateFlags createFlags = {};
+	if (IsCubeTextureType(m_Descriptor.type))
+		createFlags |= vk::ImageCreateFlagBits::eCubeCompatible;
+
+	// The SRGB hint keeps linear and sRGB views of the same image possible
+	if ((m_Descriptor.flags & AkTextureFlags_SRGB_HINT) && (SupportsSRGB(m_Descriptor.format) || IsSRGB(m_Descriptor.format)))
+	{
+		createFlags |= vk::ImageCreateFlagBits::eMutableFormat;
+
+		// sRGB formats rarely support storage, only their linear views are written to
+		if (m_Descriptor.flags & AkTextureFlags_ALLOW_UNORDERED_ACCESS)
+			createFlags |= vk::ImageCreateFlagBits::eExtendedUsage;
+	}
+
+	// Lets render passes target single depth slices of a volume
+	if (m_Descriptor.type == AkTextureType::TEXTURE_3D && (m_Descriptor.flags & AkTextureFlags_RENDER_INTO_SUB_RESOURCES))
+		createFlags |= vk::ImageCreateFlagBits::e2DArrayCompatible;
+
+	const vk::ImageCreateInfo imageCreateInfo =
+	{
+		.flags = createFlags,
+		.imageType = GetImageType(m_Descriptor.type),
+		.format = GetVkFormat(m_Descriptor.format),
+		.extent =
+		{
+			.width = std::max(1u, m_Descriptor.width),
+			.height = std::max(1u, m_Descriptor.height),
+			.depth = m_Descriptor.type == AkTextureType::TEXTURE_3D ? std::max(1u, m_Descriptor.depth) : 1u
+		},
+		.mipLevels = m_Descriptor.mips,
+		.arrayLayers = m_Descriptor.type == AkTextureType::TEXTURE_3D ? 1u : m_Descriptor.slices,
+		.samples = GetSampleCount(m_Descriptor.msaa),
+		.tiling = vk::ImageTiling::eOptimal,
+		.usage = GetImageUsage(m_Descriptor.flags),
+		.sharingMode = vk::SharingMode::eExclusive,
+		.initialLayout = vk::ImageLayout::eUndefined
+	};
+
+	if (!AkMemoryAllocator::CreateImage(imageCreateInfo, AkMemoryUsage::GPU_ONLY, m_Storage->image, m_Storage->allocation))
+		throw std::runtime_error("Failed to create AkTexture");
+
+	m_Storage->isOwned = true;
+}
+
+AkTextureDescriptor AkTexture::Normalize(const AkTextureDescriptor& descriptor)
+{
+	AkTextureDescriptor normalized = descriptor;
+	const uint32_t largestExtent = std::max({ descriptor.width, descriptor.height, descriptor.type == AkTextureType::TEXTURE_3D ? descriptor.depth : 1u });
+	normalized.mips = std::clamp(descriptor.mips, 1u, static_cast<uint32_t>(std::bit_width(largestExtent)));
+	normalized.slices = descriptor.type == AkTextureType::TEXTURE_3D ? 1u : std::max(1u, descriptor.slices);
+	normalized.depth = descriptor.type == AkTextureType::TEXTURE_3D ? std::max(1u, descriptor.depth) : 1u;
+	return normalized;
+}
+
 AkTexture::AkTexture(const AkTextureDescriptor& descriptor, const vk::Image& image)
 	: m_Descriptor(descriptor)
 {
@@ -15,9 +187,123 @@ AkTexture::AkTexture(const AkTextureDescriptor& descriptor, const vk::Image& ima
 
 AkTexture::~AkTexture()
 {
+	const vk::Device& device = AkDevice::GetDevice();
+	for (const auto& [key, view] : m_Storage->views)
+		device.destroyImageView(view);
+
+	if (m_Storage->isOwned)
+		AkMemoryAllocator::DestroyImage(m_Storage->image, m_Storage->allocation);
 }
 
 const vk::Image& AkTexture::GetImage()
 {
 	return m_Storage->image;
+}
+
+const vk::ImageView& AkTexture::GetView(const AkTextureSubresourceRange& range, const AkPixelFormat format)
+{
+	static const vk::ImageView kNullView = nullptr;
+
+	const AkTextureSubresourceRange resolvedRange = ResolveRange(range);
+	AkPixelFormat viewFormat = format;
+	if (viewFormat == AkPixelFormat::UNDEFINED)
+		viewFormat = (m_Descriptor.flags & AkTextureFlags_SRGB_HINT) ? GetSRGB(m_Descriptor.format) : m_Descriptor.format;
+
+	const AkTextureViewKey key =
+	{
+		.baseMip = resolvedRange.baseMip,
+		.mipCount = resolvedRange.mipCount,
+		.baseSlice = resolvedRange.baseSlice,
+		.sliceCount = resolvedRange.sliceCount,
+		.format = viewFormat
+	};
+
+	std::scoped_lock lock(m_Storage->viewsMutex);
+
+	auto found = m_Storage->views.find(key);
+	if (found != m_Storage->views.end())
+		return found->second;
+
+	// Views inherit the usage of their image, an sRGB view of an extended usage image must not claim storage its format lacks
+	const vk::ImageUsageFlags imageUsage = GetImageUsage(m_Descriptor.flags);
+	const vk::ImageViewUsageCreateInfo viewUsageCreateInfo = { .usage = imageUsage & ~vk::ImageUsageFlagBits::eStorage };
+	const bool stripsStorage = (imageUsage & vk::ImageUsageFlagBits::eStorage) && !AkDevice::SupportsFormatFeatures(viewFormat, AkFormatFeatures_STORAGE);
+
+	const vk::ImageViewCreateInfo viewCreateInfo =
+	{
+		.pNext = stripsStorage ? &viewUsageCreateInfo : nullptr,
+		.image = m_Storage->image,
+		.viewType = GetImageViewType(m_Descriptor.type, resolvedRange.sliceCount),
+		.format = GetVkFormat(viewFormat),
+		.subresourceRange =
+		{
+			.aspectMask = GetAspectMask(viewFormat),
+			.baseMipLevel = resolvedRange.baseMip,
+			.levelCount = resolvedRange.mipCount,
+			.baseArrayLayer = resolvedRange.baseSlice,
+			.layerCount = resolvedRange.sliceCount
+		}
+	};
+
+	try
+	{
+		return m_Storage->views[key] = AkDevice::GetDevice().createImageView(viewCreateInfo);
+	}
+	catch (const std::exception& exception)
+	{
+		AkLogError("Failed to create texture view: {}", exception.what());
+		return kNullView;
+	}
+}
+
+AkTextureSubresourceRange AkTexture::ResolveRange(const AkTextureSubresourceRange& range) const
+{
+	AkAssert(range.baseMip < m_Descriptor.mips && range.baseSlice < m_Descriptor.slices, "Texture subresource range is out of bounds");
+
+	AkTextureSubresourceRange resolvedRange = range;
+	resolvedRange.mipCount = std::min(range.mipCount, m_Descriptor.mips - range.baseMip);
+	resolvedRange.sliceCount = std::min(range.sliceCount, m_Descriptor.slices - range.baseSlice);
+	return resolvedRange;
+}
+
+AkSubresourceState AkTexture::GetState(const uint32_t mip, const uint32_t slice) const
+{
+	if (m_SubresourceStates.empty())
+		return m_UniformState;
+
+	return m_SubresourceStates[mip * m_Descriptor.slices + slice];
+}
+
+void AkTexture::SetState(const AkSubresourceState state, const AkTextureSubresourceRange& range)
+{
+	const AkTextureSubresourceRange resolvedRange = ResolveRange(range);
+	const bool coversWholeTexture = resolvedRange.mipCount == m_Descriptor.mips && resolvedRange.sliceCount == m_Descriptor.slices;
+
+	if (coversWholeTexture)
+	{
+		m_UniformState = state;
+		m_SubresourceStates.clear();
+		return;
+	}
+
+	if (m_SubresourceStates.empty())
+	{
+		if (m_UniformState == state)
+			return;
+
+		m_SubresourceStates.assign(m_Descriptor.mips * m_Descriptor.slices, m_UniformState);
+	}
+
+	for (uint32_t mip = resolvedRange.baseMip; mip < resolvedRange.baseMip + resolvedRange.mipCount; ++mip)
+	{
+		auto first = m_SubresourceStates.begin() + mip * m_Descriptor.slices + resolvedRange.baseSlice;
+		std::fill(first, first + resolvedRange.sliceCount, state);
+	}
+
+	// Collapse back into the compact representation once every subresource agrees again
+	if (std::all_of(m_SubresourceStates.begin(), m_SubresourceStates.end(), [state](const AkSubresourceState& other) { return other == state; }))
+	{
+		m_UniformState = state;
+		m_SubresourceStates.clear();
+	}
 }
\ No newline at end of file
@@ -1,10 +1,14 @@
 #pragma once
 #include "PixelFormats.h"
+#include "RHI/PipelineStates.h"
 #include "Utilities/ForwardStorage.h"
 
+#include <vector>
+
 namespace vk 
 { 
 	class Image; 
+	class ImageView;
 }
 
 enum AkTextureFlagBits
@@ -59,16 +63,49 @@ struct AkTextureDescriptor
 	AkMSAA msaa = AkMSAA::X1;
 };
 
+struct AkTextureSubresourceRange
+{
+	static constexpr uint32_t kRemaining = UINT32_MAX;
+
+	uint32_t baseMip = 0;
+	uint32_t mipCount = kRemaining;
+	uint32_t baseSlice = 0;
+	uint32_t sliceCount = kRemaining;
+};
+
 class AkTexture
 {
 public:
+	// Creates and owns an image with memory from the engine allocator, the mip count is clamped to the full chain.
+	// Cube textures count their faces as slices, so their slice count must be a multiple of six.
+	AkTexture(const AkTextureDescriptor& descriptor);
+
+	// Wraps an image owned by someone else, such as a swapchain back buffer
 	AkTexture(const AkTextureDescriptor& descriptor, const vk::Image& image);
 	~AkTexture();
 
+	// The descriptor an owned texture is created with, data laid out ahead of creation must match it
+	static AkTextureDescriptor Normalize(const AkTextureDescriptor& descriptor);
+
 	const AkTextureDescriptor& GetDescriptor() const { return m_Descriptor; }
 	const vk::Image& GetImage();
 
+	// Views are created on first use and cached per subresource range and format, undefined picks the format of the texture.
+	// Views of another format than the texture need a compatible format and the SRGB hint, which creates the image as mutable.
+	const vk::ImageView& GetView(const AkTextureSubresourceRange& range = {}, const AkPixelFormat format = AkPixelFormat::UNDEFINED);
+
+	AkTextureSubresourceRange ResolveRange(const AkTextureSubresourceRange& range) const;
+
+	bool HasUniformState() const { return m_SubresourceStates.empty(); }
+	AkSubresourceState GetState(const uint32_t mip, const uint32_t slice) const;
+	void SetState(const AkSubresourceState state, const AkTextureSubresourceRange& range = {});
+
 private:
 	AkTextureDescriptor m_Descriptor;
-	ForwardStorage<struct AkTextureStorage, 8> m_Storage;
+
+	// Subresource states are only expanded once a range diverges from the rest of the texture
+	AkSubresourceState m_UniformState = {};
+	std::vector<AkSubresourceState> m_SubresourceStates;
+
+	ForwardStorage<struct AkTextureStorage, 208> m_Storage;
 };
\ No newline at end of file
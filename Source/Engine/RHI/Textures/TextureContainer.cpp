@@ -0,0 +1,282 @@
+#include "TextureContainer.h"
+#include "Core/Log.h"
+#include "RHI/DeferredDestruction.h"
+#include "RHI/Memory/MemoryAllocator.h"
+#include "RHI/CommandBuffers/CommandBuffer.h"
+
+#include <bit>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+
+static_assert(std::is_trivially_copyable_v<AkTextureContainerHeader>, "The container header is read straight from the mapping");
+
+static uint64_t GetMipByteSize(const AkTextureDescriptor& descriptor, const uint32_t mip)
+{
+	const uint32_t width = std::max(1u, descriptor.width >> mip);
+	const uint32_t height = std::max(1u, descriptor.height >> mip);
+	const uint32_t depth = std::max(1u, descriptor.depth >> mip);
+	return GetSurfaceByteSize(descriptor.format, width, height) * depth * descriptor.slices;
+}
+
+static uint64_t AlignUp(const uint64_t value, const uint64_t alignment)
+{
+	return (value + alignment - 1) & ~(alignment - 1);
+}
+
+// Descriptors are read from files, so everything sizes and lookups are derived from is checked before any of it is used
+static bool IsValidDescriptor(const AkTextureDescriptor& descriptor)
+{
+	if (descriptor.format == AkPixelFormat::UNDEFINED || static_cast<size_t>(descriptor.format) >= kPixelFormatCount)
+		return false;
+
+	if (descriptor.type > AkTextureType::CUBEMAP_ARRAY || descriptor.msaa != AkMSAA::X1)
+		return false;
+
+	const uint32_t largestExtent = std::max({ descriptor.width, descriptor.height, descriptor.depth });
+	if (descriptor.width == 0 || descriptor.height == 0 || descriptor.depth == 0 || largestExtent > kTextureContainerMaxExtent || descriptor.slices > kTextureContainerMaxSlices)
+		return false;
+
+	const bool isCube = descriptor.type == AkTextureType::CUBEMAP || descriptor.type == AkTextureType::CUBEMAP_ARRAY;
+	if (descriptor.mips == 0 || descriptor.mips > kTextureContainerMaxMips || (isCube && descriptor.slices % 6 != 0))
+		return false;
+
+	// Containers are uploaded into a texture created from their descriptor, one it would clamp no longer matches the payloads
+	const AkTextureDescriptor normalized = AkTexture::Normalize(descriptor);
+	return normalized.mips == descriptor.mips && normalized.slices == descriptor.slices && normalized.depth == descriptor.depth;
+}
+
+// The tail in ascending order, then the mips above it from the smallest to the largest
+static void GetPayloadOrder(const AkTextureContainerHeader& header, std::array<uint32_t, kTextureContainerMaxMips>& outOrder)
+{
+	uint32_t index = 0;
+	for (uint32_t mip = header.tailMip; mip < header.descriptor.mips; ++mip)
+		outOrder[index++] = mip;
+
+	for (uint32_t mip = header.tailMip; mip > 0; --mip)
+		outOrder[index++] = mip - 1;
+}
+
+struct AkPayloadRegion
+{
+	uint64_t start = 0;
+	uint64_t end = 0;
+};
+
+// A run of mips crossing the tail is not laid out in mip order, so the region spans the payloads of every mip in it
+static AkPayloadRegion GetPayloadRegion(const AkTextureContainerHeader& header, const uint32_t baseMip, const uint32_t mipCount)
+{
+	AkPayloadRegion region = { .start = UINT64_MAX, .end = 0 };
+	for (uint32_t mip = baseMip; mip < baseMip + mipCount; ++mip)
+	{
+		region.start = std::min(region.start, header.mips[mip].offset);
+		region.end = std::max(region.end, header.mips[mip].offset + header.mips[mip].size);
+	}
+
+	return region;
+}
+
+bool AkTextureContainer::Write(const std::filesystem::path& path, const AkTextureDescriptor& descriptor, std::span<const std::span<const uint8_t>> mips, const uint32_t alignment)
+{
+	// Texel blocks are at most 16 bytes and copy offsets must be multiples of four, a power of two from 16 covers both
+	if (!std::has_single_bit(alignment) || alignment < 16)
+	{
+		AkLogError("Texture container alignment {} is not a power of two of at least 16", alignment);
+		return false;
+	}
+
+	if (!IsValidDescriptor(descriptor) || mips.size() != descriptor.mips)
+	{
+		AkLogError("Texture container for {} needs a valid descriptor the texture is created with as is, with one payload per mip", path.string());
+		return false;
+	}
+
+	AkTextureContainerHeader header = { .descriptor = descriptor, .alignment = alignment, .tailMip = AkTextureStreamer::GetTailMip(descriptor) };
+
+	std::array<uint32_t, kTextureContainerMaxMips> order = {};
+	GetPayloadOrder(header, order);
+
+	uint64_t offset = AlignUp(sizeof(AkTextureContainerHeader), alignment);
+	for (uint32_t i = 0; i < descriptor.mips; ++i)
+	{
+		const uint32_t mip = order[i];
+		if (mips[mip].size() != GetMipByteSize(descriptor, mip))
+		{
+			AkLogError("Mip {} of texture container {} holds {} bytes instead of {}", mip, path.string(), mips[mip].size(), GetMipByteSize(descriptor, mip));
+			return false;
+		}
+
+		header.mips[mip] = { .offset = offset, .size = mips[mip].size() };
+		offset = AlignUp(offset + mips[mip].size(), alignment);
+	}
+
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	if (!file)
+	{
+		AkLogError("Failed to open texture container {} for writing", path.string());
+		return false;
+	}
+
+	static constexpr std::array<char, 256> kPadding = {};
+	const auto writePadding = [&file](const uint64_t byteCount)
+	{
+		for (uint64_t remaining = byteCount; remaining > 0;)
+		{
+			const uint64_t chunk = std::min<uint64_t>(remaining, kPadding.size());
+			file.write(kPadding.data(), static_cast<std::streamsize>(chunk));
+			remaining -= chunk;
+		}
+	};
+
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	uint64_t writtenBytes = sizeof(header);
+
+	for (uint32_t i = 0; i < descriptor.mips; ++i)
+	{
+		const AkTextureContainerMip& mip = header.mips[order[i]];
+		writePadding(mip.offset - writtenBytes);
+		file.write(reinterpret_cast<const char*>(mips[order[i]].data()), static_cast<std::streamsize>(mip.size));
+		writtenBytes = mip.offset + mip.size;
+	}
+
+	if (!file)
+	{
+		AkLogError("Failed to write texture container {}", path.string());
+		return false;
+	}
+
+	return true;
+}
+
+AkTextureContainer::AkTextureContainer(const std::filesystem::path& path)
+	: m_File(path)
+{
+	const std::span<const uint8_t> bytes = m_File.GetBytes();
+	if (bytes.size() < sizeof(AkTextureContainerHeader))
+	{
+		AkLogError("Texture container {} is smaller than its header", path.string());
+		throw std::runtime_error("Failed to create AkTextureContainer");
+	}
+
+	std::memcpy(&m_Header, bytes.data(), sizeof(AkTextureContainerHeader));
+	if (m_Header.magic != kTextureContainerMagic || m_Header.version != kTextureContainerVersion)
+	{
+		AkLogError("{} is not a texture container of version {}", path.string(), kTextureContainerVersion);
+		throw std::runtime_error("Failed to create AkTextureContainer");
+	}
+
+	const AkTextureDescriptor& descriptor = m_Header.descriptor;
+	if (!IsValidDescriptor(descriptor) || m_Header.tailMip != AkTextureStreamer::GetTailMip(descriptor) || !std::has_single_bit(m_Header.alignment) || m_Header.alignment < 16)
+	{
+		AkLogError("Texture container {} has an invalid header", path.string());
+		throw std::runtime_error("Failed to create AkTextureContainer");
+	}
+
+	std::array<uint32_t, kTextureContainerMaxMips> order = {};
+	GetPayloadOrder(m_Header, order);
+
+	// Payloads must be laid out exactly as written, each starting at the first aligned offset past the previous one
+	uint64_t previousEnd = sizeof(AkTextureContainerHeader);
+	for (uint32_t i = 0; i < descriptor.mips; ++i)
+	{
+		const uint32_t mip = order[i];
+		const AkTextureContainerMip& payload = m_Header.mips[mip];
+		if (payload.size != GetMipByteSize(descriptor, mip) || payload.offset != AlignUp(previousEnd, m_Header.alignment) || payload.offset > bytes.size() || payload.size > bytes.size() - payload.offset)
+		{
+			AkLogError("Mip {} of texture container {} does not fit its file", mip, path.string());
+			throw std::runtime_error("Failed to create AkTextureContainer");
+		}
+
+		previousEnd = payload.offset + payload.size;
+	}
+}
+
+std::span<const uint8_t> AkTextureContainer::GetMip(const uint32_t mip) const
+{
+	const AkTextureContainerMip& payload = m_Header.mips[mip];
+	return m_File.GetBytes().subspan(static_cast<size_t>(payload.offset), static_cast<size_t>(payload.size));
+}
+
+bool AkTextureContainer::CopyMips(const uint32_t baseMip, const uint32_t mipCount, std::span<uint8_t> destination) const
+{
+	if (baseMip + mipCount > m_Header.descriptor.mips)
+		return false;
+
+	uint64_t byteSize = 0;
+	for (uint32_t mip = baseMip; mip < baseMip + mipCount; ++mip)
+		byteSize += m_Header.mips[mip].size;
+
+	if (destination.size() < byteSize)
+		return false;
+
+	const AkPayloadRegion region = GetPayloadRegion(m_Header, baseMip, mipCount);
+	m_File.Prefetch(static_cast<size_t>(region.start), static_cast<size_t>(region.end - region.start));
+
+	uint8_t* writePointer = destination.data();
+	for (uint32_t mip = baseMip; mip < baseMip + mipCount; ++mip)
+	{
+		const std::span<const uint8_t> payload = GetMip(mip);
+		std::memcpy(writePointer, payload.data(), payload.size());
+		writePointer += payload.size();
+	}
+
+	return true;
+}
+
+AkMipLoader AkTextureContainer::CreateMipLoader(const std::shared_ptr<const AkTextureContainer>& container)
+{
+	return [container](const uint32_t mip, std::span<uint8_t> destination)
+	{
+		return container->CopyMips(mip, 1, destination);
+	};
+}
+
+std::unique_ptr<AkTexture> AkTextureContainer::Upload(AkCommandBuffer* commandBuffer) const
+{
+	const AkTextureDescriptor& descriptor = m_Header.descriptor;
+
+	// The payloads of every mip are contiguous in the file, the whole region is copied in one go
+	const AkPayloadRegion region = GetPayloadRegion(m_Header, 0, descriptor.mips);
+
+	std::unique_ptr<AkTexture> texture = nullptr;
+	vk::Buffer stagingBuffer = nullptr;
+	AkMemoryAllocation stagingAllocation = {};
+
+	try
+	{
+		AkTextureDescriptor textureDescriptor = descriptor;
+		textureDescriptor.flags |= AkTextureFlags_BIND_AS_SHADER_RESOURCE | AkTextureFlags_COPY_DESTINATION;
+		texture = std::make_unique<AkTexture>(textureDescriptor);
+	}
+	catch (const std::exception& exception)
+	{
+		AkLogError("Failed to create texture from container: {}", exception.what());
+		return nullptr;
+	}
+
+	const vk::BufferCreateInfo bufferCreateInfo =
+	{
+		.size = region.end - region.start,
+		.usage = vk::BufferUsageFlagBits::eTransferSrc
+	};
+
+	if (!AkMemoryAllocator::CreateBuffer(bufferCreateInfo, AkMemoryUsage::UPLOAD, stagingBuffer, stagingAllocation))
+		return nullptr;
+
+	m_File.Prefetch(static_cast<size_t>(region.start), static_cast<size_t>(region.end - region.start));
+	std::memcpy(stagingAllocation.mappedData, m_File.GetBytes().data() + region.start, static_cast<size_t>(region.end - region.start));
+	AkMemoryAllocator::Flush(stagingAllocation);
+
+	// A single transition for the whole chain, the per mip copies then find it in the right state already
+	commandBuffer->RequireState(texture.get(), AkResourceState::COPY_DESTINATION);
+	for (uint32_t mip = 0; mip < descriptor.mips; ++mip)
+		commandBuffer->CopyBufferToTexture(stagingBuffer, texture.get(), m_Header.mips[mip].offset - region.start, { .baseMip = mip, .mipCount = 1 });
+
+	commandBuffer->RequireState(texture.get(), AkResourceState::SHADER_RESOURCE);
+
+	AkDeferredDestruction::Enqueue([stagingBuffer, stagingAllocation]() mutable { AkMemoryAllocator::DestroyBuffer(stagingBuffer, stagingAllocation); });
+	return texture;
+}
\ No newline at end of file
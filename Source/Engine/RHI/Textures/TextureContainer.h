@@ -0,0 +1,70 @@
+#pragma once
+#include "Texture.h"
+#include "TextureStreamer.h"
+#include "Platform/MappedFile.h"
+
+#include <span>
+#include <memory>
+#include <cstdint>
+#include <filesystem>
+
+inline constexpr uint32_t kTextureContainerMagic = 0x58544B41;
+inline constexpr uint32_t kTextureContainerVersion = 1;
+inline constexpr uint32_t kTextureContainerMaxMips = 16;
+
+// The largest extent with a full chain of the maximum mip count, together with the slice limit it keeps every mip size within 64 bits
+inline constexpr uint32_t kTextureContainerMaxExtent = 1u << (kTextureContainerMaxMips - 1);
+inline constexpr uint32_t kTextureContainerMaxSlices = 2048;
+
+// A mip holds its slices tightly packed in the format of the descriptor, block compressed formats already compressed
+struct AkTextureContainerMip
+{
+	uint64_t offset = 0;
+	uint64_t size = 0;
+};
+
+// Payloads follow the header with the mip tail first, then the mips above it from the smallest to the largest.
+// Every payload starts at a multiple of the alignment, so it can be copied to staging memory and uploaded as is.
+struct AkTextureContainerHeader
+{
+	uint32_t magic = kTextureContainerMagic;
+	uint32_t version = kTextureContainerVersion;
+
+	AkTextureDescriptor descriptor = {};
+	uint32_t alignment = 0;
+	uint32_t tailMip = 0;
+
+	AkTextureContainerMip mips[kTextureContainerMaxMips] = {};
+};
+
+// Maps a texture container and hands out its mips without parsing or copying anything beyond the header
+class AkTextureContainer
+{
+public:
+	// Large enough for the optimalBufferCopyOffsetAlignment of every device we ship on, as well as any texel block size
+	static constexpr uint32_t kDefaultAlignment = 256;
+
+	// Mips are given from the first one, each holding its slices tightly packed. The descriptor must already be the one AkTexture::Normalize returns.
+	static bool Write(const std::filesystem::path& path, const AkTextureDescriptor& descriptor, std::span<const std::span<const uint8_t>> mips, const uint32_t alignment = kDefaultAlignment);
+
+	// Validates the header against the size of the file, the payloads are only read from disk once copied
+	AkTextureContainer(const std::filesystem::path& path);
+
+	const AkTextureDescriptor& GetDescriptor() const { return m_Header.descriptor; }
+	uint32_t GetTailMip() const { return m_Header.tailMip; }
+
+	std::span<const uint8_t> GetMip(const uint32_t mip) const;
+
+	// Packs a run of mips one after the other, straight from the mapping into staging or host visible device memory
+	bool CopyMips(const uint32_t baseMip, const uint32_t mipCount, std::span<uint8_t> destination) const;
+
+	// The loader keeps the container mapped for as long as the streamer holds it
+	static AkMipLoader CreateMipLoader(const std::shared_ptr<const AkTextureContainer>& container);
+
+	// Creates the texture and records the upload of every mip from one upload buffer holding the payloads exactly as laid out in the file
+	std::unique_ptr<AkTexture> Upload(class AkCommandBuffer* commandBuffer) const;
+
+private:
+	AkMappedFile m_File;
+	AkTextureContainerHeader m_Header = {};
+};
\ No newline at end of file
@@ -0,0 +1,168 @@
+#include "TexturePool.h"
+#include "Core/Log.h"
+#include "RHI/DeferredDestruction.h"
+#include "Utilities/Hash.h"
+
+#include <mutex>
+#include <memory>
+#include <vector>
+#include <numeric>
+#include <algorithm>
+#include <unordered_map>
+
+struct AkTextureArrayPool
+{
+	AkTextureDescriptor descriptor = {};
+	uint32_t sliceCount = 0;
+	std::unique_ptr<AkTexture> texture = nullptr;
+	std::vector<uint32_t> freeSlices;
+};
+
+static std::mutex sMutex;
+static std::vector<std::unique_ptr<AkTextureArrayPool>> sPools;
+static std::vector<uint32_t> sFreePoolIndices;
+static std::unordered_map<size_t, std::vector<uint32_t>> sPoolsByDescriptor;
+
+static size_t HashPoolDescriptor(const AkTextureDescriptor& descriptor)
+{
+	return HashValues(descriptor.width, descriptor.height, static_cast<uint32_t>(descriptor.format), descriptor.mips, descriptor.flags);
+}
+
+static uint64_t GetSliceByteSize(const AkTextureDescriptor& descriptor)
+{
+	const AkTextureDescriptor normalized = AkTexture::Normalize(descriptor);
+
+	uint64_t byteSize = 0;
+	for (uint32_t mip = 0; mip < normalized.mips; ++mip)
+		byteSize += GetSurfaceByteSize(normalized.format, std::max(1u, normalized.width >> mip), std::max(1u, normalized.height >> mip));
+
+	return byteSize;
+}
+
+static bool IsSamePoolDescriptor(const AkTextureDescriptor& first, const AkTextureDescriptor& second)
+{
+	return first.width == second.width && first.height == second.height && first.format == second.format && first.mips == second.mips && first.flags == second.flags;
+}
+
+bool AkTexturePool::Initialize()
+{
+	return true;
+}
+
+void AkTexturePool::Deinitialize()
+{
+	// The device is idle, so every pool is released right away
+	std::scoped_lock lock(sMutex);
+	sPools.clear();
+	sFreePoolIndices.clear();
+	sPoolsByDescriptor.clear();
+}
+
+AkPooledTexture AkTexturePool::Allocate(const AkTextureDescriptor& descriptor)
+{
+	AkAssert(descriptor.type == AkTextureType::TEXTURE_2D && descriptor.slices == 1 && descriptor.msaa == AkMSAA::X1, "Only single sampled 2D textures can be pooled");
+
+	const uint64_t sliceByteSize = GetSliceByteSize(descriptor);
+	if (sliceByteSize > kMaxSliceByteSize)
+	{
+		AkLogError("A {}x{} texture takes {} bytes, pooled textures are limited to {} bytes", descriptor.width, descriptor.height, sliceByteSize, kMaxSliceByteSize);
+		return {};
+	}
+
+	const size_t descriptorHash = HashPoolDescriptor(descriptor);
+	std::scoped_lock lock(sMutex);
+
+	std::vector<uint32_t>& poolIndices = sPoolsByDescriptor[descriptorHash];
+	for (const uint32_t poolIndex : poolIndices)
+	{
+		AkTextureArrayPool& pool = *sPools[poolIndex];
+		if (pool.freeSlices.empty() || !IsSamePoolDescriptor(pool.descriptor, descriptor))
+			continue;
+
+		const uint32_t slice = pool.freeSlices.back();
+		pool.freeSlices.pop_back();
+		return { .pool = poolIndex, .slice = slice };
+	}
+
+	std::unique_ptr<AkTextureArrayPool> pool = std::make_unique<AkTextureArrayPool>();
+	pool->descriptor = descriptor;
+	pool->sliceCount = static_cast<uint32_t>(std::min<uint64_t>(kMaxSlicesPerPool, kPoolByteBudget / std::max<uint64_t>(sliceByteSize, 1)));
+
+	AkTextureDescriptor arrayDescriptor = descriptor;
+	arrayDescriptor.type = AkTextureType::TEXTURE_ARRAY_2D;
+	arrayDescriptor.slices = pool->sliceCount;
+
+	try
+	{
+		pool->texture = std::make_unique<AkTexture>(arrayDescriptor);
+	}
+	catch (const std::exception& exception)
+	{
+		AkLogError("Failed to create texture pool: {}", exception.what());
+		return {};
+	}
+
+	// Slices are handed out from the back, starting with the first one
+	pool->freeSlices.resize(pool->sliceCount - 1);
+	std::iota(pool->freeSlices.rbegin(), pool->freeSlices.rend(), 1u);
+
+	uint32_t poolIndex = static_cast<uint32_t>(sPools.size());
+	if (!sFreePoolIndices.empty())
+	{
+		poolIndex = sFreePoolIndices.back();
+		sFreePoolIndices.pop_back();
+		sPools[poolIndex] = std::move(pool);
+	}
+	else
+		sPools.push_back(std::move(pool));
+
+	poolIndices.push_back(poolIndex);
+	return { .pool = poolIndex, .slice = 0 };
+}
+
+void AkTexturePool::Free(const AkPooledTexture& pooledTexture)
+{
+	if (!pooledTexture.IsValid())
+		return;
+
+	AkDeferredDestruction::Enqueue([pooledTexture]()
+	{
+		std::scoped_lock lock(sMutex);
+
+		// Pools are gone once deinitialized, the destructions still queued then are flushed afterwards
+		if (pooledTexture.pool < sPools.size() && sPools[pooledTexture.pool])
+			sPools[pooledTexture.pool]->freeSlices.push_back(pooledTexture.slice);
+	});
+}
+
+void AkTexturePool::Trim()
+{
+	std::scoped_lock lock(sMutex);
+	for (auto& [descriptorHash, poolIndices] : sPoolsByDescriptor)
+	{
+		std::erase_if(poolIndices, [](const uint32_t poolIndex)
+		{
+			std::unique_ptr<AkTextureArrayPool>& pool = sPools[poolIndex];
+			if (pool->freeSlices.size() != pool->sliceCount)
+				return false;
+
+			AkDeferredDestruction::Enqueue([texture = std::move(pool->texture)]() mutable { texture.reset(); });
+			pool.reset();
+			sFreePoolIndices.push_back(poolIndex);
+			return true;
+		});
+	}
+
+	std::erase_if(sPoolsByDescriptor, [](const auto& entry) { return entry.second.empty(); });
+}
+
+AkTexture* AkTexturePool::GetTexture(const AkPooledTexture& pooledTexture)
+{
+	std::scoped_lock lock(sMutex);
+	return sPools[pooledTexture.pool]->texture.get();
+}
+
+AkTextureSubresourceRange AkTexturePool::GetRange(const AkPooledTexture& pooledTexture)
+{
+	return { .baseSlice = pooledTexture.slice, .sliceCount = 1 };
+}
\ No newline at end of file
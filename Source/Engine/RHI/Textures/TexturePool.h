@@ -0,0 +1,48 @@
+#pragma once
+#include "Texture.h"
+
+#include <cstdint>
+
+// A texture living in one slice of a pooled texture array, shaders bind the pool and index the slice
+struct AkPooledTexture
+{
+	uint32_t pool = UINT32_MAX;
+	uint32_t slice = UINT32_MAX;
+
+	bool IsValid() const { return pool != UINT32_MAX; }
+};
+
+// Allocates small textures of the same extent, format, mips and flags as slices of shared 2D texture arrays.
+// Allocating and freeing a slice only touch a free list, images are created once a whole pool is in use and destroyed when trimmed.
+class AkTexturePool
+{
+public:
+	// Every device supports at least 256 array layers
+	static constexpr uint32_t kMaxSlicesPerPool = 256;
+
+	// Pools of larger textures hold fewer slices, so a single pool never grows past this
+	static constexpr uint64_t kPoolByteBudget = 16ull << 20;
+
+	// Textures too large to share a pool with this many others gain nothing from pooling and are rejected
+	static constexpr uint32_t kMinSlicesPerPool = 16;
+	static constexpr uint64_t kMaxSliceByteSize = kPoolByteBudget / kMinSlicesPerPool;
+
+	static bool Initialize();
+	static void Deinitialize();
+
+	// The descriptor describes a single 2D texture of at most kMaxSliceByteSize with its mips, larger ones return an invalid texture.
+	// The slice is uninitialized until something is copied or rendered into it.
+	static AkPooledTexture Allocate(const AkTextureDescriptor& descriptor);
+
+	// The slice may still be sampled by frames in flight, so it is only handed out again once they completed
+	static void Free(const AkPooledTexture& pooledTexture);
+
+	// Destroys the pools with no slice in use
+	static void Trim();
+
+	// The array holding the texture, shared by every slice of the pool
+	static AkTexture* GetTexture(const AkPooledTexture& pooledTexture);
+
+	// Selects the slice of the texture within its array, for copies, barriers and render targets
+	static AkTextureSubresourceRange GetRange(const AkPooledTexture& pooledTexture);
+};
\ No newline at end of file
@@ -0,0 +1,162 @@
+#include "TextureReadback.h"
+#include "Texture.h"
+#include "Core/Log.h"
+#include "Core/JobSystem.h"
+#include "RHI/Memory/MemoryAllocator.h"
+#include "RHI/CommandBuffers/CommandBuffer.h"
+
+#include <array>
+#include <mutex>
+#include <algorithm>
+
+enum class AkReadbackSlotState
+{
+	FREE,
+	IN_FLIGHT,
+	DELIVERING
+};
+
+struct AkReadbackSlot
+{
+	AkReadbackSlotState state = AkReadbackSlotState::FREE;
+	uint64_t frame = 0;
+
+	vk::Buffer buffer = nullptr;
+	AkMemoryAllocation allocation = {};
+
+	AkReadbackData data = {};
+	AkReadbackCallback callback = nullptr;
+};
+
+static std::mutex sSlotsMutex;
+static std::array<AkReadbackSlot, AkTextureReadback::kRingSize> sSlots;
+static uint32_t sNextSlotIndex = 0;
+static AkJobCounter sDeliveryCounter;
+
+bool AkTextureReadback::Initialize()
+{
+	m_FrameCounter = 0;
+	sNextSlotIndex = 0;
+	return true;
+}
+
+void AkTextureReadback::Deinitialize()
+{
+	AkJobSystem::Wait(sDeliveryCounter);
+
+	// The device is idle, readbacks still in flight are dropped as their callbacks may reference state that is already gone
+	std::scoped_lock lock(sSlotsMutex);
+	for (AkReadbackSlot& slot : sSlots)
+	{
+		if (slot.buffer)
+			AkMemoryAllocator::DestroyBuffer(slot.buffer, slot.allocation);
+
+		slot = {};
+	}
+}
+
+void AkTextureReadback::SetFramesInFlight(const uint32_t framesInFlight)
+{
+	std::scoped_lock lock(sSlotsMutex);
+	m_FramesInFlight = std::max(framesInFlight, m_FramesInFlight);
+}
+
+void AkTextureReadback::BeginFrame()
+{
+	std::scoped_lock lock(sSlotsMutex);
+	++m_FrameCounter;
+
+	for (AkReadbackSlot& slot : sSlots)
+	{
+		if (slot.state != AkReadbackSlotState::IN_FLIGHT || slot.frame + m_FramesInFlight > m_FrameCounter)
+			continue;
+
+		slot.state = AkReadbackSlotState::DELIVERING;
+		AkJobSystem::Schedule([&slot]() { Deliver(slot); }, &sDeliveryCounter);
+	}
+}
+
+bool AkTextureReadback::Request(AkCommandBuffer* commandBuffer, AkTexture* texture, AkReadbackCallback&& callback, const uint32_t mip, const uint32_t slice)
+{
+	const AkTextureDescriptor& descriptor = texture->GetDescriptor();
+	if (IsDepthPixelFormat(descriptor.format))
+	{
+		AkLogError("Depth textures can not be read back");
+		return false;
+	}
+
+	if (!(descriptor.flags & AkTextureFlags_COPY_SOURCE))
+	{
+		AkLogError("Textures created without 'COPY_SOURCE' can not be read back");
+		return false;
+	}
+
+	const AkReadbackData data =
+	{
+		.width = std::max(1u, descriptor.width >> mip),
+		.height = std::max(1u, descriptor.height >> mip),
+		.depth = std::max(1u, descriptor.depth >> mip),
+		.format = descriptor.format
+	};
+
+	const size_t byteSize = GetSurfaceByteSize(data.format, data.width, data.height) * data.depth;
+	vk::Buffer buffer = nullptr;
+
+	{
+		std::scoped_lock lock(sSlotsMutex);
+
+		uint32_t slotIndex = sNextSlotIndex;
+		while (sSlots[slotIndex].state != AkReadbackSlotState::FREE)
+		{
+			slotIndex = (slotIndex + 1) % kRingSize;
+			if (slotIndex == sNextSlotIndex)
+			{
+				AkLogWarning("Every readback slot is in use, the readback is dropped");
+				return false;
+			}
+		}
+
+		// Slots only ever grow, so a steady stream of same sized captures never allocates again
+		AkReadbackSlot& slot = sSlots[slotIndex];
+		if (slot.allocation.size < byteSize)
+		{
+			if (slot.buffer)
+				AkMemoryAllocator::DestroyBuffer(slot.buffer, slot.allocation);
+
+			const vk::BufferCreateInfo bufferCreateInfo =
+			{
+				.size = byteSize,
+				.usage = vk::BufferUsageFlagBits::eTransferDst
+			};
+
+			if (!AkMemoryAllocator::CreateBuffer(bufferCreateInfo, AkMemoryUsage::READBACK, slot.buffer, slot.allocation))
+				return false;
+		}
+
+		slot.state = AkReadbackSlotState::IN_FLIGHT;
+		slot.frame = m_FrameCounter;
+		slot.data = data;
+		slot.data.bytes = { static_cast<const uint8_t*>(slot.allocation.mappedData), byteSize };
+		slot.callback = std::move(callback);
+
+		buffer = slot.buffer;
+		sNextSlotIndex = (slotIndex + 1) % kRingSize;
+	}
+
+	commandBuffer->CopyTextureToBuffer(texture, buffer, 0, { .baseMip = mip, .mipCount = 1, .baseSlice = slice, .sliceCount = 1 });
+
+	// Transfer writes are only guaranteed to be visible to the host through a barrier into the host domain
+	commandBuffer->HostReadBarrier();
+	commandBuffer->FlushBarriers();
+	return true;
+}
+
+void AkTextureReadback::Deliver(AkReadbackSlot& slot)
+{
+	AkMemoryAllocator::Invalidate(slot.allocation);
+	slot.callback(slot.data);
+
+	std::scoped_lock lock(sSlotsMutex);
+	slot.callback = nullptr;
+	slot.state = AkReadbackSlotState::FREE;
+}
\ No newline at end of file
@@ -0,0 +1,45 @@
+#pragma once
+#include "PixelFormats.h"
+
+#include <span>
+#include <cstdint>
+#include <functional>
+
+struct AkReadbackData
+{
+	// Tightly packed rows, only valid until the callback returns
+	std::span<const uint8_t> bytes = {};
+
+	uint32_t width = 0;
+	uint32_t height = 0;
+	uint32_t depth = 0;
+	AkPixelFormat format = AkPixelFormat::UNDEFINED;
+};
+
+using AkReadbackCallback = std::function<void(const AkReadbackData& data)>;
+
+// Copies textures into a ring of host visible buffers and hands their bytes to a callback once the frame that copied them completed.
+// Nothing ever waits on the GPU, a request is dropped with a warning while every slot of the ring is still in use.
+class AkTextureReadback
+{
+public:
+	static constexpr uint32_t kRingSize = 8;
+
+	static bool Initialize();
+	static void Deinitialize();
+
+	static void SetFramesInFlight(const uint32_t framesInFlight);
+
+	// Must be called once the fence of the frame being started has signaled, completed readbacks are delivered as jobs
+	static void BeginFrame();
+
+	// Records the copy of a single mip and slice, the command buffer must be submitted with the current frame.
+	// The texture is left in the copy source state, back buffers included.
+	static bool Request(class AkCommandBuffer* commandBuffer, class AkTexture* texture, AkReadbackCallback&& callback, const uint32_t mip = 0, const uint32_t slice = 0);
+
+private:
+	static void Deliver(struct AkReadbackSlot& slot);
+
+	static inline uint32_t m_FramesInFlight = 1;
+	static inline uint64_t m_FrameCounter = 0;
+};
\ No newline at end of file
@@ -0,0 +1,396 @@
+#include "TextureStreamer.h"
+#include "Core/Log.h"
+#include "Core/JobSystem.h"
+#include "RHI/DeferredDestruction.h"
+#include "RHI/Memory/MemoryAllocator.h"
+#include "RHI/CommandBuffers/CommandBuffer.h"
+
+#include <bit>
+#include <cmath>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <algorithm>
+
+enum class AkStreamingLoadState
+{
+	IDLE,
+	LOADING,
+	READY,
+	FAILED
+};
+
+struct AkStreamedTexture
+{
+	AkTextureDescriptor descriptor = {};
+	AkMipLoader loader = nullptr;
+	bool isRegistered = false;
+	bool hasFailedLoad = false;
+
+	// The resident mip equals the mip count while nothing is resident
+	std::unique_ptr<AkTexture> texture = nullptr;
+	uint32_t residentMip = 0;
+	uint32_t tailMip = 0;
+
+	// The finest mip requested within the residency window, a coarser request only replaces it once the window elapsed
+	uint32_t requestedMip = 0;
+	uint64_t requestedMipFrame = 0;
+	uint64_t lastRequestFrame = 0;
+	float priority = 0.f;
+	float effectivePriority = 0.f;
+
+	// A job loads the mips from the load mip up to the resident mip into the staging buffer
+	std::atomic<AkStreamingLoadState> loadState = AkStreamingLoadState::IDLE;
+	uint32_t loadMip = 0;
+	vk::Buffer stagingBuffer = nullptr;
+	AkMemoryAllocation stagingAllocation = {};
+};
+
+// Share of the budget left by everything else that streaming uses, the rest absorbs allocations made between two updates
+static constexpr double kBudgetHeadroom = 0.9;
+
+static std::mutex sMutex;
+static std::vector<std::unique_ptr<AkStreamedTexture>> sStreamedTextures;
+static std::vector<AkStreamedTextureHandle> sFreeHandles;
+static std::vector<AkStreamedTexture*> sPrioritizedTextures;
+static std::atomic<uint64_t> sResidentBytes = 0;
+static AkJobCounter sLoadCounter;
+
+static uint64_t GetChainByteSize(const AkTextureDescriptor& descriptor, const uint32_t firstMip, const uint32_t endMip)
+{
+	uint64_t byteSize = 0;
+	for (uint32_t mip = firstMip; mip < endMip; ++mip)
+	{
+		const uint32_t width = std::max(1u, descriptor.width >> mip);
+		const uint32_t height = std::max(1u, descriptor.height >> mip);
+		const uint32_t depth = std::max(1u, descriptor.depth >> mip);
+		byteSize += GetSurfaceByteSize(descriptor.format, width, height) * depth * descriptor.slices;
+	}
+
+	return byteSize;
+}
+
+static uint64_t GetResidentByteSize(const AkStreamedTexture& streamedTexture)
+{
+	return streamedTexture.texture ? GetChainByteSize(streamedTexture.descriptor, streamedTexture.residentMip, streamedTexture.descriptor.mips) : 0;
+}
+
+static uint32_t GetLargestExtent(const AkTextureDescriptor& descriptor)
+{
+	return std::max({ descriptor.width, descriptor.height, descriptor.depth });
+}
+
+uint32_t AkTextureStreamer::GetTailMip(const AkTextureDescriptor& descriptor)
+{
+	const uint32_t largestExtent = GetLargestExtent(descriptor);
+
+	uint32_t mip = 0;
+	while (mip + 1 < descriptor.mips && (largestExtent >> mip) > kMipTailSize)
+		++mip;
+
+	return mip;
+}
+
+// The finest mip still covering a texel per pixel, rounding down keeps the texture sharp rather than saving a mip
+static uint32_t GetMipForScreenSize(const AkStreamedTexture& streamedTexture, const float screenSize)
+{
+	if (screenSize <= 1.f)
+		return streamedTexture.tailMip;
+
+	const float mip = std::floor(std::log2(static_cast<float>(GetLargestExtent(streamedTexture.descriptor)) / screenSize));
+	return mip <= 0.f ? 0u : std::min(static_cast<uint32_t>(mip), streamedTexture.tailMip);
+}
+
+static void DestroyStagingBuffer(AkStreamedTexture& streamedTexture)
+{
+	if (!streamedTexture.stagingBuffer)
+		return;
+
+	AkDeferredDestruction::Enqueue([buffer = streamedTexture.stagingBuffer, allocation = streamedTexture.stagingAllocation]() mutable { AkMemoryAllocator::DestroyBuffer(buffer, allocation); });
+	streamedTexture.stagingBuffer = nullptr;
+	streamedTexture.stagingAllocation = {};
+}
+
+bool AkTextureStreamer::Initialize()
+{
+	m_FrameCounter = 0;
+	m_BudgetLimit = 0;
+	sResidentBytes = 0;
+	return true;
+}
+
+void AkTextureStreamer::Deinitialize()
+{
+	AkJobSystem::Wait(sLoadCounter);
+
+	// The device is idle, so everything is released right away
+	std::scoped_lock lock(sMutex);
+	for (std::unique_ptr<AkStreamedTexture>& streamedTexture : sStreamedTextures)
+	{
+		if (streamedTexture && streamedTexture->stagingBuffer)
+			AkMemoryAllocator::DestroyBuffer(streamedTexture->stagingBuffer, streamedTexture->stagingAllocation);
+	}
+
+	sStreamedTextures.clear();
+	sFreeHandles.clear();
+	sPrioritizedTextures.clear();
+	sResidentBytes = 0;
+}
+
+AkStreamedTextureHandle AkTextureStreamer::Register(const AkTextureDescriptor& descriptor, AkMipLoader&& loader)
+{
+	std::unique_ptr<AkStreamedTexture> streamedTexture = std::make_unique<AkStreamedTexture>();
+	streamedTexture->descriptor = descriptor;
+	streamedTexture->descriptor.depth = descriptor.type == AkTextureType::TEXTURE_3D ? std::max(1u, descriptor.depth) : 1u;
+	streamedTexture->descriptor.slices = descriptor.type == AkTextureType::TEXTURE_3D ? 1u : std::max(1u, descriptor.slices);
+	streamedTexture->descriptor.mips = std::clamp(descriptor.mips, 1u, static_cast<uint32_t>(std::bit_width(GetLargestExtent(streamedTexture->descriptor))));
+	streamedTexture->loader = std::move(loader);
+	streamedTexture->isRegistered = true;
+	streamedTexture->residentMip = streamedTexture->descriptor.mips;
+	streamedTexture->tailMip = GetTailMip(streamedTexture->descriptor);
+	streamedTexture->requestedMip = streamedTexture->tailMip;
+
+	std::scoped_lock lock(sMutex);
+	streamedTexture->requestedMipFrame = m_FrameCounter;
+	streamedTexture->lastRequestFrame = m_FrameCounter;
+
+	if (!sFreeHandles.empty())
+	{
+		const AkStreamedTextureHandle handle = sFreeHandles.back();
+		sFreeHandles.pop_back();
+		sStreamedTextures[handle] = std::move(streamedTexture);
+		return handle;
+	}
+
+	sStreamedTextures.push_back(std::move(streamedTexture));
+	return static_cast<AkStreamedTextureHandle>(sStreamedTextures.size() - 1);
+}
+
+void AkTextureStreamer::Unregister(const AkStreamedTextureHandle handle)
+{
+	// The texture is released on the next update, once any load in flight finished
+	std::scoped_lock lock(sMutex);
+	if (handle < sStreamedTextures.size() && sStreamedTextures[handle])
+		sStreamedTextures[handle]->isRegistered = false;
+}
+
+void AkTextureStreamer::Request(const AkStreamedTextureHandle handle, const float screenSize, const float distance)
+{
+	std::scoped_lock lock(sMutex);
+	if (handle >= sStreamedTextures.size() || !sStreamedTextures[handle] || !sStreamedTextures[handle]->isRegistered)
+		return;
+
+	AkStreamedTexture& streamedTexture = *sStreamedTextures[handle];
+	const uint32_t mip = GetMipForScreenSize(streamedTexture, screenSize);
+	if (mip <= streamedTexture.requestedMip || streamedTexture.requestedMipFrame + kResidencyFrames <= m_FrameCounter)
+	{
+		streamedTexture.requestedMip = mip;
+		streamedTexture.requestedMipFrame = m_FrameCounter;
+	}
+
+	// A texture used several times in a frame is as important as its most demanding use
+	const float priority = std::max(screenSize, 0.f) / (1.f + std::max(distance, 0.f));
+	streamedTexture.priority = streamedTexture.lastRequestFrame == m_FrameCounter ? std::max(streamedTexture.priority, priority) : priority;
+	streamedTexture.lastRequestFrame = m_FrameCounter;
+}
+
+AkTexture* AkTextureStreamer::GetTexture(const AkStreamedTextureHandle handle)
+{
+	std::scoped_lock lock(sMutex);
+	return handle < sStreamedTextures.size() && sStreamedTextures[handle] ? sStreamedTextures[handle]->texture.get() : nullptr;
+}
+
+uint32_t AkTextureStreamer::GetResidentMip(const AkStreamedTextureHandle handle)
+{
+	std::scoped_lock lock(sMutex);
+	return handle < sStreamedTextures.size() && sStreamedTextures[handle] ? sStreamedTextures[handle]->residentMip : 0;
+}
+
+void AkTextureStreamer::SetBudgetLimit(const uint64_t budgetLimit)
+{
+	std::scoped_lock lock(sMutex);
+	m_BudgetLimit = budgetLimit;
+}
+
+uint64_t AkTextureStreamer::GetResidentBytes()
+{
+	return sResidentBytes.load(std::memory_order_relaxed);
+}
+
+void AkTextureStreamer::RecordUpdates(AkCommandBuffer* commandBuffer)
+{
+	std::scoped_lock lock(sMutex);
+	++m_FrameCounter;
+
+	// Finished loads are applied first, as they change the resident bytes the budget is checked against
+	for (AkStreamedTextureHandle handle = 0; handle < sStreamedTextures.size(); ++handle)
+	{
+		AkStreamedTexture* streamedTexture = sStreamedTextures[handle].get();
+		if (!streamedTexture)
+			continue;
+
+		const AkStreamingLoadState loadState = streamedTexture->loadState.load(std::memory_order_acquire);
+		if (loadState == AkStreamingLoadState::LOADING)
+			continue;
+
+		// A texture that failed to load or to be recreated keeps its resident mips instead of retrying every frame
+		if (loadState == AkStreamingLoadState::READY && streamedTexture->isRegistered)
+			streamedTexture->hasFailedLoad |= !ApplyResidency(commandBuffer, *streamedTexture, streamedTexture->loadMip);
+
+		streamedTexture->hasFailedLoad |= loadState == AkStreamingLoadState::FAILED;
+		streamedTexture->loadState = AkStreamingLoadState::IDLE;
+		DestroyStagingBuffer(*streamedTexture);
+
+		if (!streamedTexture->isRegistered)
+		{
+			sResidentBytes -= GetResidentByteSize(*streamedTexture);
+			if (streamedTexture->texture)
+				AkDeferredDestruction::Enqueue([texture = std::move(streamedTexture->texture)]() mutable { texture.reset(); });
+
+			sStreamedTextures[handle].reset();
+			sFreeHandles.push_back(handle);
+		}
+	}
+
+	// The budget is whatever everything else in the heap left, the usage reported by the device already includes the streamed textures
+	const AkMemoryBudget memoryBudget = AkMemoryAllocator::GetBudget(AkMemoryUsage::GPU_ONLY);
+	const uint64_t residentBytes = sResidentBytes.load(std::memory_order_relaxed);
+	const uint64_t otherBytes = memoryBudget.usage > residentBytes ? memoryBudget.usage - residentBytes : 0;
+	uint64_t budget = memoryBudget.budget > otherBytes ? static_cast<uint64_t>(static_cast<double>(memoryBudget.budget - otherBytes) * kBudgetHeadroom) : 0;
+	if (m_BudgetLimit != 0)
+		budget = std::min(budget, m_BudgetLimit);
+
+	// Recently requested textures keep most of their priority, textures not requested within the residency window have none
+	uint64_t tailBytes = 0;
+	sPrioritizedTextures.clear();
+	for (std::unique_ptr<AkStreamedTexture>& streamedTexture : sStreamedTextures)
+	{
+		if (!streamedTexture)
+			continue;
+
+		const uint64_t framesSinceRequest = m_FrameCounter - streamedTexture->lastRequestFrame;
+		streamedTexture->effectivePriority = framesSinceRequest > kResidencyFrames ? 0.f : streamedTexture->priority / (1.f + static_cast<float>(framesSinceRequest) / kResidencyFrames);
+
+		tailBytes += GetChainByteSize(streamedTexture->descriptor, streamedTexture->tailMip, streamedTexture->descriptor.mips);
+		sPrioritizedTextures.push_back(streamedTexture.get());
+	}
+
+	std::sort(sPrioritizedTextures.begin(), sPrioritizedTextures.end(), [](const AkStreamedTexture* a, const AkStreamedTexture* b) { return a->effectivePriority > b->effectivePriority; });
+
+	// Tails are always resident, the mips above them are handed out from the most important texture down
+	uint64_t remainingBytes = budget > tailBytes ? budget - tailBytes : 0;
+	uint64_t uploadBytes = 0;
+	for (AkStreamedTexture* streamedTexture : sPrioritizedTextures)
+	{
+		const AkTextureDescriptor& descriptor = streamedTexture->descriptor;
+		const bool isRequested = streamedTexture->lastRequestFrame + kResidencyFrames > m_FrameCounter;
+
+		uint32_t targetMip = isRequested ? streamedTexture->requestedMip : streamedTexture->tailMip;
+		while (targetMip < streamedTexture->tailMip && GetChainByteSize(descriptor, targetMip, streamedTexture->tailMip) > remainingBytes)
+			++targetMip;
+
+		remainingBytes -= GetChainByteSize(descriptor, targetMip, streamedTexture->tailMip);
+
+		if (streamedTexture->loadState != AkStreamingLoadState::IDLE)
+			continue;
+
+		// Evictions only copy mips that are already resident, so they happen right away
+		if (streamedTexture->texture && targetMip > streamedTexture->residentMip)
+		{
+			ApplyResidency(commandBuffer, *streamedTexture, targetMip);
+			continue;
+		}
+
+		if (targetMip >= streamedTexture->residentMip || streamedTexture->hasFailedLoad)
+			continue;
+
+		// The tail is loaded at once, the mips above it one at a time so the texture sharpens progressively instead of popping
+		const uint32_t loadMip = streamedTexture->texture ? streamedTexture->residentMip - 1 : streamedTexture->tailMip;
+		const uint64_t loadBytes = GetChainByteSize(descriptor, loadMip, streamedTexture->residentMip);
+		if (uploadBytes != 0 && uploadBytes + loadBytes > kMaxUploadBytesPerFrame)
+			continue;
+
+		uploadBytes += loadBytes;
+		streamedTexture->loadMip = loadMip;
+		streamedTexture->loadState = AkStreamingLoadState::LOADING;
+		AkJobSystem::Schedule([streamedTexture]() { Load(*streamedTexture); }, &sLoadCounter);
+	}
+}
+
+void AkTextureStreamer::Load(AkStreamedTexture& streamedTexture)
+{
+	const AkTextureDescriptor& descriptor = streamedTexture.descriptor;
+	const vk::BufferCreateInfo bufferCreateInfo =
+	{
+		.size = GetChainByteSize(descriptor, streamedTexture.loadMip, streamedTexture.residentMip),
+		.usage = vk::BufferUsageFlagBits::eTransferSrc
+	};
+
+	if (!AkMemoryAllocator::CreateBuffer(bufferCreateInfo, AkMemoryUsage::UPLOAD, streamedTexture.stagingBuffer, streamedTexture.stagingAllocation))
+	{
+		streamedTexture.loadState.store(AkStreamingLoadState::FAILED, std::memory_order_release);
+		return;
+	}
+
+	// Mips are packed one after the other, the layout the buffer to texture copy expects
+	uint8_t* destination = static_cast<uint8_t*>(streamedTexture.stagingAllocation.mappedData);
+	for (uint32_t mip = streamedTexture.loadMip; mip < streamedTexture.residentMip; ++mip)
+	{
+		const uint64_t mipByteSize = GetChainByteSize(descriptor, mip, mip + 1);
+		if (!streamedTexture.loader(mip, { destination, static_cast<size_t>(mipByteSize) }))
+		{
+			AkLogError("Failed to load mip {} of a streamed texture, it stays at its resident mips", mip);
+			streamedTexture.loadState.store(AkStreamingLoadState::FAILED, std::memory_order_release);
+			return;
+		}
+
+		destination += mipByteSize;
+	}
+
+	// Flushed before publishing the load, the copy out of the staging buffer is recorded once it is ready
+	AkMemoryAllocator::Flush(streamedTexture.stagingAllocation);
+	streamedTexture.loadState.store(AkStreamingLoadState::READY, std::memory_order_release);
+}
+
+bool AkTextureStreamer::ApplyResidency(AkCommandBuffer* commandBuffer, AkStreamedTexture& streamedTexture, const uint32_t residentMip)
+{
+	AkTextureDescriptor descriptor = streamedTexture.descriptor;
+	descriptor.width = std::max(1u, descriptor.width >> residentMip);
+	descriptor.height = std::max(1u, descriptor.height >> residentMip);
+	descriptor.depth = std::max(1u, descriptor.depth >> residentMip);
+	descriptor.mips = streamedTexture.descriptor.mips - residentMip;
+	descriptor.flags |= AkTextureFlags_BIND_AS_SHADER_RESOURCE | AkTextureFlags_COPY_SOURCE | AkTextureFlags_COPY_DESTINATION;
+
+	std::unique_ptr<AkTexture> texture = nullptr;
+	try
+	{
+		texture = std::make_unique<AkTexture>(descriptor);
+	}
+	catch (const std::exception& exception)
+	{
+		AkLogError("Failed to create streamed texture: {}", exception.what());
+		return false;
+	}
+
+	// Loaded mips are the finest ones of the new chain, the staging buffer holds them packed
+	if (residentMip < streamedTexture.residentMip)
+		commandBuffer->CopyBufferToTexture(streamedTexture.stagingBuffer, texture.get(), 0, { .mipCount = streamedTexture.residentMip - residentMip });
+
+	if (streamedTexture.texture)
+	{
+		const uint32_t firstKeptMip = std::max(residentMip, streamedTexture.residentMip);
+		commandBuffer->CopyTextureMips(streamedTexture.texture.get(), firstKeptMip - streamedTexture.residentMip, texture.get(), firstKeptMip - residentMip, streamedTexture.descriptor.mips - firstKeptMip);
+	}
+
+	commandBuffer->RequireState(texture.get(), AkResourceState::SHADER_RESOURCE);
+
+	sResidentBytes -= GetResidentByteSize(streamedTexture);
+	if (streamedTexture.texture)
+		AkDeferredDestruction::Enqueue([oldTexture = std::move(streamedTexture.texture)]() mutable { oldTexture.reset(); });
+
+	streamedTexture.texture = std::move(texture);
+	streamedTexture.residentMip = residentMip;
+	sResidentBytes += GetResidentByteSize(streamedTexture);
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,59 @@
+#pragma once
+#include "Texture.h"
+
+#include <span>
+#include <cstdint>
+#include <functional>
+
+// Fills the bytes of a single mip with its slices tightly packed, called from job threads
+using AkMipLoader = std::function<bool(const uint32_t mip, std::span<uint8_t> destination)>;
+
+using AkStreamedTextureHandle = uint32_t;
+inline constexpr AkStreamedTextureHandle kInvalidStreamedTexture = UINT32_MAX;
+
+// Keeps the mip tail of every registered texture resident and streams the mips above it in and out within the memory budget.
+// Residency follows a priority combining the requested screen size, the distance and how recently the texture was requested.
+// A texture is recreated with its new chain on every change, mips already resident are copied over and the old one is destroyed deferred.
+class AkTextureStreamer
+{
+public:
+	// Mips whose largest extent is at most this size form the tail, which is resident for as long as the texture is registered
+	static constexpr uint32_t kMipTailSize = 128;
+
+	// Throttles the loads started per frame, so streaming in never spikes the frame time
+	static constexpr uint64_t kMaxUploadBytesPerFrame = 32ull * 1024 * 1024;
+
+	// A texture keeps the mips it was requested with for this many frames before it can be coarsened, and falls back to its tail once unrequested this long
+	static constexpr uint64_t kResidencyFrames = 120;
+
+	static bool Initialize();
+	static void Deinitialize();
+
+	// First mip of the tail, containers store the mips from it on first so the tail is read in one go
+	static uint32_t GetTailMip(const AkTextureDescriptor& descriptor);
+
+	// The descriptor describes the full chain, the texture has no storage until its tail was loaded
+	static AkStreamedTextureHandle Register(const AkTextureDescriptor& descriptor, AkMipLoader&& loader);
+	static void Unregister(const AkStreamedTextureHandle handle);
+
+	// Called for every use of the texture, with the size in pixels it covers on screen along its largest extent and its distance to the camera
+	static void Request(const AkStreamedTextureHandle handle, const float screenSize, const float distance);
+
+	// Only valid on the render thread until the next update, the first mip of the texture is the resident mip of the full chain
+	static AkTexture* GetTexture(const AkStreamedTextureHandle handle);
+	static uint32_t GetResidentMip(const AkStreamedTextureHandle handle);
+
+	// Caps the bytes used by streamed textures below the budget of the device, zero only keeps the budget
+	static void SetBudgetLimit(const uint64_t budgetLimit);
+	static uint64_t GetResidentBytes();
+
+	// Applies finished loads and evictions then starts new loads, must be recorded before anything sampling streamed textures in the frame
+	static void RecordUpdates(class AkCommandBuffer* commandBuffer);
+
+private:
+	static void Load(struct AkStreamedTexture& streamedTexture);
+	static bool ApplyResidency(class AkCommandBuffer* commandBuffer, struct AkStreamedTexture& streamedTexture, const uint32_t residentMip);
+
+	static inline uint64_t m_FrameCounter = 0;
+	static inline uint64_t m_BudgetLimit = 0;
+};
\ No newline at end of file
@@ -0,0 +1,223 @@
+#pragma once
+#include "PipelineStates.h"
+#include "Core/Log.h"
+#include "RHI/Textures/PixelFormats.h"
+
+#include <array>
+#include <vulkan/vulkan.hpp>
+
+inline vk::ImageAspectFlags GetAspectMask(const AkPixelFormat format)
+{
+	if (IsDepthPixelFormat(format))
+		return vk::ImageAspectFlagBits::eDepth;
+	else
+		return vk::ImageAspectFlagBits::eColor;
+}
+
+struct AkVkPixelFormat
+{
+	AkPixelFormat format = AkPixelFormat::UNDEFINED;
+	vk::Format vkFormat = vk::Format::eUndefined;
+};
+
+inline constexpr std::array kVkPixelFormats = std::to_array<AkVkPixelFormat>(
+{
+	{ AkPixelFormat::UNDEFINED,			vk::Format::eUndefined },
+	{ AkPixelFormat::R8_UINT,			vk::Format::eR8Uint },
+	{ AkPixelFormat::R8_SINT,			vk::Format::eR8Sint },
+	{ AkPixelFormat::R8_UNORM,			vk::Format::eR8Unorm },
+	{ AkPixelFormat::R8_SNORM,			vk::Format::eR8Snorm },
+	{ AkPixelFormat::RG8_UINT,			vk::Format::eR8G8Uint },
+	{ AkPixelFormat::RG8_SINT,			vk::Format::eR8G8Sint },
+	{ AkPixelFormat::RG8_UNORM,			vk::Format::eR8G8Unorm },
+	{ AkPixelFormat::RG8_SNORM,			vk::Format::eR8G8Snorm },
+	{ AkPixelFormat::RGBA8_UINT,		vk::Format::eR8G8B8A8Uint },
+	{ AkPixelFormat::RGBA8_SINT,		vk::Format::eR8G8B8A8Sint },
+	{ AkPixelFormat::RGBA8_SNORM,		vk::Format::eR8G8B8A8Snorm },
+	{ AkPixelFormat::RGBA8_UNORM,		vk::Format::eR8G8B8A8Unorm },
+	{ AkPixelFormat::RGBA8_SRGB,		vk::Format::eR8G8B8A8Srgb },
+	{ AkPixelFormat::BGRA8_UNORM,		vk::Format::eB8G8R8A8Unorm },
+	{ AkPixelFormat::BGRA8_SRGB,		vk::Format::eB8G8R8A8Srgb },
+	{ AkPixelFormat::R10G10B10A2_UNORM,	vk::Format::eA2B10G10R10UnormPack32 },
+	{ AkPixelFormat::R16_UINT,			vk::Format::eR16Uint },
+	{ AkPixelFormat::R16_SINT,			vk::Format::eR16Sint },
+	{ AkPixelFormat::R16_UNORM,			vk::Format::eR16Unorm },
+	{ AkPixelFormat::R16_SNORM,			vk::Format::eR16Snorm },
+	{ AkPixelFormat::R16_FLOAT,			vk::Format::eR16Sfloat },
+	{ AkPixelFormat::RG16_UINT,			vk::Format::eR16G16Uint },
+	{ AkPixelFormat::RG16_SINT,			vk::Format::eR16G16Sint },
+	{ AkPixelFormat::RG16_UNORM,		vk::Format::eR16G16Unorm },
+	{ AkPixelFormat::RG16_SNORM,		vk::Format::eR16G16Snorm },
+	{ AkPixelFormat::RG16_FLOAT,		vk::Format::eR16G16Sfloat },
+	{ AkPixelFormat::RGBA16_UINT,		vk::Format::eR16G16B16A16Uint },
+	{ AkPixelFormat::RGBA16_SINT,		vk::Format::eR16G16B16A16Sint },
+	{ AkPixelFormat::RGBA16_UNORM,		vk::Format::eR16G16B16A16Unorm },
+	{ AkPixelFormat::RGBA16_SNORM,		vk::Format::eR16G16B16A16Snorm },
+	{ AkPixelFormat::RGBA16_FLOAT,		vk::Format::eR16G16B16A16Sfloat },
+	{ AkPixelFormat::R32_UINT,			vk::Format::eR32Uint },
+	{ AkPixelFormat::R32_SINT,			vk::Format::eR32Sint },
+	{ AkPixelFormat::R32_FLOAT,			vk::Format::eR32Sfloat },
+	{ AkPixelFormat::RG32_UINT,			vk::Format::eR32G32Uint },
+	{ AkPixelFormat::RG32_SINT,			vk::Format::eR32G32Sint },
+	{ AkPixelFormat::RG32_FLOAT,		vk::Format::eR32G32Sfloat },
+	{ AkPixelFormat::RGBA32_UINT,		vk::Format::eR32G32B32A32Uint },
+	{ AkPixelFormat::RGBA32_SINT,		vk::Format::eR32G32B32A32Sint },
+	{ AkPixelFormat::RGBA32_FLOAT,		vk::Format::eR32G32B32A32Sfloat },
+	{ AkPixelFormat::BC1_RGB_UNORM,		vk::Format::eBc1RgbUnormBlock },
+	{ AkPixelFormat::BC1_RGB_SRGB,		vk::Format::eBc1RgbSrgbBlock },
+	{ AkPixelFormat::BC1_RGBA_UNORM,	vk::Format::eBc1RgbaUnormBlock },
+	{ AkPixelFormat::BC1_RGBA_SRGB,		vk::Format::eBc1RgbaSrgbBlock },
+	{ AkPixelFormat::BC2_UNORM,			vk::Format::eBc2UnormBlock },
+	{ AkPixelFormat::BC2_SRGB,			vk::Format::eBc2SrgbBlock },
+	{ AkPixelFormat::BC3_UNORM,			vk::Format::eBc3UnormBlock },
+	{ AkPixelFormat::BC3_SRGB,			vk::Format::eBc3SrgbBlock },
+	{ AkPixelFormat::BC4_UNORM,			vk::Format::eBc4UnormBlock },
+	{ AkPixelFormat::BC4_SNORM,			vk::Format::eBc4SnormBlock },
+	{ AkPixelFormat::BC5_UNORM,			vk::Format::eBc5UnormBlock },
+	{ AkPixelFormat::BC5_SNORM,			vk::Format::eBc5SnormBlock },
+	{ AkPixelFormat::BC6H_UF16,			vk::Format::eBc6HUfloatBlock },
+	{ AkPixelFormat::BC6H_SF16,			vk::Format::eBc6HSfloatBlock },
+	{ AkPixelFormat::BC7_UNORM,			vk::Format::eBc7UnormBlock },
+	{ AkPixelFormat::BC7_SRGB,			vk::Format::eBc7SrgbBlock },
+	{ AkPixelFormat::D32_SFLOAT_S8_UINT,	vk::Format::eD32SfloatS8Uint },
+	{ AkPixelFormat::D32_SFLOAT,		vk::Format::eD32Sfloat },
+	{ AkPixelFormat::D24_UNORM_S8_UINT,	vk::Format::eD24UnormS8Uint },
+	{ AkPixelFormat::D16_UNORM,			vk::Format::eD16Unorm }
+});
+static_assert(IsIndexedByPixelFormat(kVkPixelFormats), "Every pixel format needs its Vulkan format, in declaration order");
+
+inline constexpr vk::Format GetVkFormat(const AkPixelFormat format)
+{
+	return kVkPixelFormats[static_cast<size_t>(format)].vkFormat;
+}
+
+// Only used for formats handed out by the driver, such as the swapchain one
+inline constexpr AkPixelFormat GetAkPixelFormat(const vk::Format format)
+{
+	for (const AkVkPixelFormat& entry : kVkPixelFormats)
+	{
+		if (entry.vkFormat == format)
+			return entry.format;
+	}
+
+	AkLogCritical("Vulkan format not registered on this function");
+	return AkPixelFormat::UNDEFINED;
+}
+
+inline constexpr vk::ImageLayout GetImageLayout(const AkResourceState resourceState)
+{
+	switch (resourceState)
+	{
+		case AkResourceState::UNDEFINED:
+			return vk::ImageLayout::eUndefined;
+
+		case AkResourceState::RENDER_TARGET:
+			return vk::ImageLayout::eColorAttachmentOptimal;
+
+		case AkResourceState::UNORDERED_ACCESS:
+			return vk::ImageLayout::eGeneral;
+
+		case AkResourceState::DEPTH_READ:
+			return vk::ImageLayout::eDepthStencilReadOnlyOptimal;
+
+		case AkResourceState::DEPTH_WRITE:
+			return vk::ImageLayout::eDepthStencilAttachmentOptimal;
+
+		case AkResourceState::SHADER_RESOURCE:
+			return vk::ImageLayout::eShaderReadOnlyOptimal;
+
+		case AkResourceState::COPY_DESTINATION:
+			return vk::ImageLayout::eTransferDstOptimal;
+
+		case AkResourceState::COPY_SOURCE:
+			return vk::ImageLayout::eTransferSrcOptimal;
+
+		case AkResourceState::PRESENT:
+			return vk::ImageLayout::ePresentSrcKHR;
+
+		case AkResourceState::INDEX_BUFFER:
+		case AkResourceState::VERTEX_BUFFER:
+		case AkResourceState::CONSTANT_BUFFER:
+		case AkResourceState::INDIRECT_ARGUMENT:
+			AkLogCritical("Resource state is not a texture compatible state");
+			return vk::ImageLayout::eUndefined;
+
+		default:
+			AkLogCritical("Resource state not registered in this function");
+			return vk::ImageLayout::eUndefined;
+	}
+}
+
+inline constexpr vk::AccessFlags2 GetAccessMask(const AkResourceState resourceState)
+{
+	switch (resourceState)
+	{
+		case AkResourceState::UNDEFINED:			return vk::AccessFlagBits2::eNone;
+		case AkResourceState::INDEX_BUFFER:			return vk::AccessFlagBits2::eIndexRead;
+		case AkResourceState::VERTEX_BUFFER: 		return vk::AccessFlagBits2::eVertexAttributeRead;
+		case AkResourceState::CONSTANT_BUFFER:		return vk::AccessFlagBits2::eUniformRead;
+		case AkResourceState::RENDER_TARGET:		return vk::AccessFlagBits2::eColorAttachmentRead | vk::AccessFlagBits2::eColorAttachmentWrite;
+		case AkResourceState::UNORDERED_ACCESS:		return vk::AccessFlagBits2::eShaderStorageRead | vk::AccessFlagBits2::eShaderStorageWrite;
+		case AkResourceState::DEPTH_READ:			return vk::AccessFlagBits2::eDepthStencilAttachmentRead;
+		case AkResourceState::DEPTH_WRITE:			return vk::AccessFlagBits2::eDepthStencilAttachmentRead | vk::AccessFlagBits2::eDepthStencilAttachmentWrite;
+		case AkResourceState::SHADER_RESOURCE:		return vk::AccessFlagBits2::eShaderSampledRead;
+		case AkResourceState::INDIRECT_ARGUMENT:	return vk::AccessFlagBits2::eIndirectCommandRead;
+		case AkResourceState::COPY_DESTINATION:		return vk::AccessFlagBits2::eTransferWrite;
+		case AkResourceState::COPY_SOURCE:			return vk::AccessFlagBits2::eTransferRead;
+		case AkResourceState::PRESENT:				return vk::AccessFlagBits2::eNone;
+
+		default:
+			AkLogCritical("Resource state not registered in this function");
+			return vk::AccessFlagBits2::eNone;
+	}
+}
+
+inline constexpr vk::PipelineStageFlags2 GetShaderStageFlags(const AkShaderStageFlags shaderStages)
+{
+	vk::PipelineStageFlags2 stageFlags = vk::PipelineStageFlagBits2::eNone;
+	if (shaderStages & AkShaderStage_VERTEX)	stageFlags |= vk::PipelineStageFlagBits2::eVertexShader;
+	if (shaderStages & AkShaderStage_FRAGMENT)	stageFlags |= vk::PipelineStageFlagBits2::eFragmentShader;
+	if (shaderStages & AkShaderStage_COMPUTE)	stageFlags |= vk::PipelineStageFlagBits2::eComputeShader;
+	return stageFlags;
+}
+
+inline constexpr vk::PipelineStageFlags2 GetPipelineStageFlags(const AkSubresourceState& subresourceState)
+{
+	switch (subresourceState.state)
+	{
+		// Undefined and present transitions chain with whatever happened before them in the queue, including swapchain semaphore waits
+		case AkResourceState::UNDEFINED:
+		case AkResourceState::PRESENT:
+			return vk::PipelineStageFlagBits2::eAllCommands;
+
+		case AkResourceState::INDEX_BUFFER:
+			return vk::PipelineStageFlagBits2::eIndexInput;
+
+		case AkResourceState::VERTEX_BUFFER:
+			return vk::PipelineStageFlagBits2::eVertexAttributeInput;
+
+		case AkResourceState::SHADER_RESOURCE:
+		case AkResourceState::CONSTANT_BUFFER:
+		case AkResourceState::UNORDERED_ACCESS:
+			return GetShaderStageFlags(subresourceState.shaderStages != AkShaderStage_NONE ? subresourceState.shaderStages : AkShaderStage_ALL);
+
+		case AkResourceState::RENDER_TARGET:
+			return vk::PipelineStageFlagBits2::eColorAttachmentOutput;
+
+		case AkResourceState::DEPTH_READ:
+		case AkResourceState::DEPTH_WRITE:
+			return	vk::PipelineStageFlagBits2::eEarlyFragmentTests |
+				vk::PipelineStageFlagBits2::eLateFragmentTests;
+
+		case AkResourceState::INDIRECT_ARGUMENT:
+			return vk::PipelineStageFlagBits2::eDrawIndirect;
+
+		case AkResourceState::COPY_SOURCE:
+		case AkResourceState::COPY_DESTINATION:
+			return vk::PipelineStageFlagBits2::eTransfer;
+
+		default:
+			AkLogCritical("Resource state not registered in this function");
+			return vk::PipelineStageFlagBits2::eNone;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,18 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+
+// https://www.boost.org/doc/libs/1_86_0/libs/container_hash/doc/html/hash.html#notes_hash_combine
+template<typename T>
+inline void HashCombine(size_t& seed, const T& value)
+{
+	seed ^= std::hash<T>{}(value) + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2);
+}
+
+template<typename ...Values>
+inline size_t HashValues(const Values&... values)
+{
+	size_t seed = 0;
+	(HashCombine(seed, values), ...);
+	return seed;
+}
\ No newline at end of file